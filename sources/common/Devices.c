@@ -0,0 +1,367 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <errno.h> // errno, EEXIST
+#include <math.h> // sqrt()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // FILE, fopen(), fprintf(), snprintf()
+#include <stdlib.h> // malloc(), realloc(), free(), getenv()
+#include <string.h> // strchr(), strcmp(), strcspn()
+#include <sys/stat.h> // mkdir()
+
+#include "common/Devices.h" // DeviceScore{}
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/Roofline.h" // Roofline_Measure()
+#include "common/helper.h" // IN, OUT, INOUT, TAB, LF, TR_FAILED()
+
+/// Name of the ranking cache, in `$XDG_CACHE_HOME` or `~/.cache`.
+#define TR_DEVICES_CACHE_NAME "first-opencl-project-devices.txt"
+
+///
+/// Returns the type of a device as a string.
+///
+static char const* TypeName(IN cl_device_type type) {
+  return type & CL_DEVICE_TYPE_GPU         ? "GPU"
+    :    type & CL_DEVICE_TYPE_CPU         ? "CPU"
+    :    type & CL_DEVICE_TYPE_ACCELERATOR ? "Accelerator"
+    :    type & CL_DEVICE_TYPE_CUSTOM      ? "Custom"
+    :                                        "Unknown";
+}
+
+///
+/// Lists every device of every platform, with their indexes, names and
+/// driver versions (not probed).
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @post `*devices` must be freed.
+///
+static bool ListDevices(OUT DeviceScore** devices, OUT cl_device_id** ids, OUT size_t* count) {
+  assert(devices != NULL && ids != NULL && count != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_platform_id* platforms = NULL;
+  cl_device_id* platformDevices = NULL;
+  *devices = NULL;
+  *ids = NULL;
+  *count = 0u;
+
+  cl_uint platformCount = 0u;
+  error = clGetPlatformIDs(0u, NULL, &platformCount);
+  if (error != CL_SUCCESS || platformCount == 0u) {
+    TR_FAILED("clGetPlatformIDs(&platformCount)", error);
+    goto out;
+  }
+
+  platforms = (cl_platform_id*) malloc(sizeof(cl_platform_id) * platformCount);
+  error = clGetPlatformIDs(platformCount, platforms, NULL);
+  if (error != CL_SUCCESS || platforms == NULL) {
+    TR_FAILED("clGetPlatformIDs(&platforms)", error);
+    goto out;
+  }
+
+  for (cl_uint platformIndex = 0u; platformIndex < platformCount; ++platformIndex) {
+    cl_uint deviceCount = 0u;
+    error = clGetDeviceIDs(platforms[platformIndex], CL_DEVICE_TYPE_ALL, 0u, NULL, &deviceCount);
+    if (error == CL_DEVICE_NOT_FOUND || deviceCount == 0u) { continue; }
+    if (error != CL_SUCCESS) { TR_FAILED("clGetDeviceIDs(&deviceCount)", error); goto out; }
+
+    platformDevices = (cl_device_id*) malloc(sizeof(cl_device_id) * deviceCount);
+    DeviceScore* moreDevices = (DeviceScore*) realloc(*devices, sizeof(DeviceScore) * (*count + deviceCount));
+    if (moreDevices != NULL) { *devices = moreDevices; }
+    cl_device_id* moreIds = (cl_device_id*) realloc(*ids, sizeof(cl_device_id) * (*count + deviceCount));
+    if (moreIds != NULL) { *ids = moreIds; }
+    if (platformDevices == NULL || moreDevices == NULL || moreIds == NULL) {
+      TR_ERROR("malloc(devices) failed");
+      goto out;
+    }
+
+    error = clGetDeviceIDs(platforms[platformIndex], CL_DEVICE_TYPE_ALL, deviceCount, platformDevices, NULL);
+    if (error != CL_SUCCESS) { TR_FAILED("clGetDeviceIDs(&devices)", error); goto out; }
+
+    for (cl_uint deviceIndex = 0u; deviceIndex < deviceCount; ++deviceIndex) {
+      DeviceScore* device = *devices + *count;
+      *device = (DeviceScore) { .platformIndex = platformIndex, .deviceIndex = deviceIndex };
+      (*ids)[*count] = platformDevices[deviceIndex];
+
+      // The names are truncated rather than failing.
+      if (CL_SUCCESS != clGetDeviceInfo(platformDevices[deviceIndex], CL_DEVICE_NAME, sizeof(device->name) - 1u, device->name, NULL)) {
+        snprintf(device->name, sizeof(device->name), "Unknown");
+      }
+
+      if (CL_SUCCESS != clGetDeviceInfo(platformDevices[deviceIndex], CL_DRIVER_VERSION, sizeof(device->driver) - 1u, device->driver, NULL)) {
+        snprintf(device->driver, sizeof(device->driver), "Unknown");
+      }
+
+      // Tabs and new lines would break the cache format.
+      device->name[strcspn(device->name, "\t\n")] = '\0';
+      device->driver[strcspn(device->driver, "\t\n")] = '\0';
+      *count += 1u;
+    }
+
+    free(platformDevices);
+    platformDevices = NULL;
+  }
+
+  success = true;
+
+out:
+  if (platformDevices != NULL) { free(platformDevices); }
+  if (platforms != NULL) { free(platforms); }
+
+  if (!success) {
+    if (*devices != NULL) { free(*devices); }
+    if (*ids != NULL) { free(*ids); }
+    *devices = NULL;
+    *ids = NULL;
+    *count = 0u;
+  }
+
+  return success;
+}
+
+///
+/// Creates the directory `path` and its missing parents (as `mkdir -p`).
+///
+/// @returns `true` if the directory exists, `false` otherwise.
+///
+static bool MakeDirectories(INOUT char* path) {
+  for (char* slash = strchr(path + 1, '/'); slash != NULL; slash = strchr(slash + 1, '/')) {
+    *slash = '\0';
+    bool created = mkdir(path, 0755) == 0 || errno == EEXIST;
+    *slash = '/';
+    if (!created) { return false; }
+  }
+
+  return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+///
+/// Writes the path of the ranking cache, creating its directory if needed.
+///
+/// @returns `true` on success, `false` if no cache directory is known or it
+///          cannot be created.
+///
+static bool CachePath(OUT char* path, IN size_t size) {
+  char const* cache = getenv("XDG_CACHE_HOME");
+  char const* home = getenv("HOME");
+  int length = cache != NULL && cache[0] != '\0' ? snprintf(path, size, "%s", cache)
+    : home != NULL && home[0] != '\0' ? snprintf(path, size, "%s/.cache", home)
+    : -1;
+
+  if (length < 0 || (size_t) length >= size || !MakeDirectories(path)) {
+    return false;
+  }
+
+  return (size_t) snprintf(path + length, size - (size_t) length, "/" TR_DEVICES_CACHE_NAME) < size - (size_t) length;
+}
+
+///
+/// Fills the scores of the devices from the ranking cache.
+///
+/// @returns `true` if every device was found with the same name and driver
+///          version, `false` otherwise (then the others must be probed).
+///
+static bool LoadCache(INOUT DeviceScore* devices, IN size_t count) {
+  char path[1024];
+  if (!CachePath(path, sizeof(path))) { return false; }
+
+  FILE* file = fopen(path, "r");
+  if (file == NULL) { return false; }
+
+  // <Platform> <Device> <GFLOP/s> <GB/s>\t<Name>\t<Driver>
+  size_t found = 0u;
+  char line[16u + 2u * TR_DEVICES_NAME_SIZE + 64u];
+  while (fgets(line, sizeof(line), file) != NULL) {
+    size_t platformIndex, deviceIndex;
+    double gflops, bandwidth;
+    int offset = 0;
+    if (sscanf(line, "%zu %zu %lf %lf\t%n", &platformIndex, &deviceIndex, &gflops, &bandwidth, &offset) != 4 || offset == 0) {
+      continue;
+    }
+
+    char* name = line + offset;
+    char* driver = name + strcspn(name, "\t");
+    if (*driver != '\t') { continue; }
+    *driver++ = '\0';
+    driver[strcspn(driver, "\n")] = '\0';
+
+    for (size_t index = 0u; index < count; ++index) {
+      DeviceScore* device = &devices[index];
+      if (device->platformIndex == platformIndex && device->deviceIndex == deviceIndex
+        && device->score == 0.0 && strcmp(device->name, name) == 0 && strcmp(device->driver, driver) == 0) {
+        device->gflops = gflops;
+        device->bandwidth = bandwidth;
+        device->score = sqrt(gflops * bandwidth);
+        found += 1u;
+      }
+    }
+  }
+
+  fclose(file);
+  return found == count;
+}
+
+///
+/// Writes the scores of the devices into the ranking cache, but the ones of
+/// the devices which failed to be probed, so that they are probed again.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool SaveCache(IN DeviceScore const* devices, IN size_t count) {
+  char path[1024];
+  if (!CachePath(path, sizeof(path))) { return false; }
+
+  FILE* file = fopen(path, "w");
+  if (file == NULL) { return false; }
+
+  for (size_t index = 0u; index < count; ++index) {
+    DeviceScore const* device = &devices[index];
+    if (!(device->score > 0.0)) { continue; }
+    fprintf(file, "%zu %zu %.3f %.3f\t%s\t%s\n"
+      , device->platformIndex, device->deviceIndex
+      , device->gflops, device->bandwidth, device->name, device->driver);
+  }
+
+  return fclose(file) == 0;
+}
+
+bool Devices_Probe(IN OpenClContext* this, OUT DeviceScore* score) {
+  assert(this != NULL && this->context != NULL && this->queue != NULL);
+  assert(score != NULL);
+
+  Roofline roofline;
+  score->gflops = score->bandwidth = score->score = 0.0;
+  if (!Roofline_Measure(this, false, &roofline)) {
+    return false;
+  }
+
+  score->gflops = roofline.gflops;
+  score->bandwidth = roofline.bandwidth;
+  score->score = sqrt(score->gflops * score->bandwidth);
+  return true;
+}
+
+bool Devices_Fastest(OUT size_t* platformIndex, OUT size_t* deviceIndex) {
+  assert(platformIndex != NULL && deviceIndex != NULL);
+
+  size_t count = 0u;
+  DeviceScore* devices = NULL;
+  cl_device_id* ids = NULL;
+  if (!ListDevices(&devices, &ids, &count)) {
+    return false;
+  }
+
+  if (!LoadCache(devices, count)) {
+    for (size_t index = 0u; index < count; ++index) {
+      DeviceScore* device = &devices[index];
+      OpenClContext context;
+      if (device->score > 0.0) { continue; } // Cached.
+
+      // A device which fails to be probed is ranked last (and not cached).
+      if (OpenClContext_FromIndexes(device->platformIndex, device->deviceIndex, &context)) {
+        if (!Devices_Probe(&context, device)) {
+          TR_ERROR("Devices_Probe(%zu:%zu) failed", device->platformIndex, device->deviceIndex);
+        }
+
+        if (!OpenClContext_Release(&context)) {
+          TR_ERROR("OpenClContext_Release() failed");
+        }
+      }
+    }
+
+    if (!SaveCache(devices, count)) {
+      TR_ERROR("The device ranking could not be cached.");
+    }
+  }
+
+  size_t fastest = 0u;
+  for (size_t index = 1u; index < count; ++index) {
+    if (devices[index].score > devices[fastest].score) {
+      fastest = index;
+    }
+  }
+
+  bool success = count > 0u && devices[fastest].score > 0.0;
+  if (success) {
+    *platformIndex = devices[fastest].platformIndex;
+    *deviceIndex = devices[fastest].deviceIndex;
+  }
+  else {
+    TR_ERROR("No device could be probed.");
+  }
+
+  free(devices);
+  free(ids);
+  return success;
+}
+
+bool Devices_Display(void) {
+  size_t count = 0u;
+  DeviceScore* devices = NULL;
+  cl_device_id* ids = NULL;
+  if (!ListDevices(&devices, &ids, &count)) {
+    return false;
+  }
+
+  bool cached = LoadCache(devices, count);
+  printf(LF TAB0 "OpenCL Devices:" LF);
+
+  #define TR_DEVICES_PLATFORM   TAB2 "Platform.......: "
+  #define TR_DEVICES_DRIVER     TAB2 "Driver.Version.: "
+  #define TR_DEVICES_UNITS      TAB2 "Compute.Units..: "
+  #define TR_DEVICES_GLOBAL     TAB2 "Global.Memory..: "
+  #define TR_DEVICES_LOCAL      TAB2 "Local.Memory...: "
+  #define TR_DEVICES_WORK_GROUP TAB2 "Work-Group.Size: "
+  #define TR_DEVICES_FP64       TAB2 "Double.Support.: "
+  #define TR_DEVICES_PROBE      TAB2 "Probe.Score....: "
+
+  for (size_t index = 0u; index < count; ++index) {
+    DeviceScore const* device = &devices[index];
+
+    cl_device_type type = 0u;
+    cl_platform_id platform = NULL;
+    char platformName[TR_DEVICES_NAME_SIZE] = "Unknown";
+    clGetDeviceInfo(ids[index], CL_DEVICE_TYPE, sizeof(type), &type, NULL);
+    if (CL_SUCCESS == clGetDeviceInfo(ids[index], CL_DEVICE_PLATFORM, sizeof(platform), &platform, NULL)) {
+      clGetPlatformInfo(platform, CL_PLATFORM_NAME, sizeof(platformName) - 1u, platformName, NULL);
+    }
+
+    OpenClCapabilities capabilities;
+    OpenClContext_QueryCapabilities(ids[index], &capabilities);
+
+    printf(LF TAB1 "%zu:%zu %s (%s)" LF, device->platformIndex, device->deviceIndex, device->name, TypeName(type));
+    printf(TR_DEVICES_PLATFORM "%s" LF, platformName);
+    printf(TR_DEVICES_DRIVER "%s" LF, device->driver);
+    printf(TR_DEVICES_UNITS "%u @ %u MHz" LF, capabilities.computeUnits, capabilities.clockFrequency);
+    printf(TR_DEVICES_GLOBAL "%.1f MiB (%.1f MiB per buffer)" LF
+      , (double) capabilities.globalMemorySize / (1024.0 * 1024.0)
+      , (double) capabilities.maxAllocationSize / (1024.0 * 1024.0));
+    printf(TR_DEVICES_LOCAL "%.1f KiB" LF, (double) capabilities.localMemorySize / 1024.0);
+    printf(TR_DEVICES_WORK_GROUP "%zu work-items" LF, capabilities.maxWorkGroupSize);
+    // As OpenClContext_EnableDoublePrecision(), 0 without double-precision.
+    cl_device_fp_config fp64 = 0u;
+    if (CL_SUCCESS != clGetDeviceInfo(ids[index], CL_DEVICE_DOUBLE_FP_CONFIG, sizeof(fp64), &fp64, NULL)) {
+      fp64 = 0u;
+    }
+
+    printf(TR_DEVICES_FP64 "%s" LF, fp64 != 0u ? "True" : "False");
+
+    if (device->score > 0.0) {
+      printf(TR_DEVICES_PROBE "%.1f (%.1f GFLOP/s, %.1f GB/s)" LF, device->score, device->gflops, device->bandwidth);
+    }
+
+    OpenClContext_ReleaseCapabilities(&capabilities);
+  }
+
+  if (!cached) {
+    printf(LF TAB1 "(Run with --device Fastest once to rank the devices.)" LF);
+  }
+
+  printf(LF);
+  free(devices);
+  free(ids);
+  return true;
+}
@@ -0,0 +1,66 @@
+#ifndef TR_COMMON_DEVICES_H
+#define TR_COMMON_DEVICES_H
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, INOUT, OUT
+
+/// Maximum length of the device name and driver version kept in a `DeviceScore`.
+#define TR_DEVICES_NAME_SIZE 128u
+
+///
+/// The result of the probe kernels on a device (see `common/Probe.cl`),
+/// identified by its indexes, its name and its driver version.
+///
+typedef struct DeviceScore {
+  size_t platformIndex, deviceIndex;
+  char name[TR_DEVICES_NAME_SIZE];
+  char driver[TR_DEVICES_NAME_SIZE];
+
+  /// Single-precision FMA throughput (GFLOP/s) and copy bandwidth (GB/s).
+  double gflops, bandwidth;
+
+  /// Geometric mean of the above, since a matrix multiplication is bound by
+  /// the former when large and by the latter when small (0 if not probed).
+  double score;
+} DeviceScore;
+
+///
+/// Runs the short FMA-throughput and bandwidth probe kernels on the device of
+/// the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `context` is not NULL and already initialized.
+/// @post May display error on stderr.
+///
+bool Devices_Probe(IN OpenClContext* context, OUT DeviceScore* score);
+
+///
+/// Finds the device with the best probe score among every platform.
+///
+/// The ranking is cached on disk (`$XDG_CACHE_HOME` or `~/.cache`), and
+/// probed again only when the devices or their drivers change.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `platformIndex` and `deviceIndex` are not NULL.
+/// @post May display error on stderr.
+///
+bool Devices_Fastest(OUT size_t* platformIndex, OUT size_t* deviceIndex);
+
+///
+/// Displays every platform and device with their key capabilities, and their
+/// probe scores when already cached (the `devices` command).
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @post Display content on stdout, may display error on stderr.
+///
+bool Devices_Display(void);
+
+#endif // TR_COMMON_DEVICES_H
@@ -0,0 +1,128 @@
+// mmap(MAP_HUGETLB), madvise(MADV_HUGEPAGE) and getrusage() are not ISO C
+// (see `man feature_test_macros`).
+#define _DEFAULT_SOURCE
+
+#include <assert.h> // assert()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // fprintf(), stderr
+#include <sys/mman.h> // mmap(), madvise(), munmap()
+#include <sys/resource.h> // getrusage()
+#include <unistd.h> // sysconf()
+
+#include "common/HostArena.h" // Self
+#include "common/helper.h" // IN, INOUT, OUT, TR_ERROR()
+#include "common/parallel.h" // ParallelFor(), ParallelBody
+#include "common/timer.h" // TimerNow()
+
+typedef struct TouchTask {
+  unsigned char* base;
+  size_t pageSize;
+} TouchTask;
+
+///
+/// Writes the first byte of the pages `[begin, end)`, taking their faults.
+///
+static void TouchPages(IN size_t begin, IN size_t end, INOUT void* data) {
+  TouchTask const* task = data;
+  for (size_t page = begin; page < end; ++page) {
+    ((unsigned char volatile*) task->base)[page * task->pageSize] = 0u;
+  }
+}
+
+static size_t RoundUp(IN size_t value, IN size_t multiple) {
+  return (value + multiple - 1u) / multiple * multiple;
+}
+
+bool HostArena_Create(IN size_t size, IN bool hugePages, OUT HostArena* this) {
+  assert(this != NULL);
+
+  *this = (HostArena) { 0 };
+  long pageSize = sysconf(_SC_PAGESIZE);
+  size_t smallPage = pageSize > 0 ? (size_t) pageSize : TR_HOSTARENA_ALIGNMENT;
+  size = RoundUp(size > 0u ? size : 1u, hugePages ? TR_HOSTARENA_HUGE_PAGE_SIZE : smallPage);
+
+  void* base = MAP_FAILED;
+  if (hugePages) {
+    // Fails unless huge pages are reserved (e.g. /proc/sys/vm/nr_hugepages).
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    this->hugePages = base != MAP_FAILED;
+  }
+
+  if (base == MAP_FAILED) {
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+      TR_ERROR("mmap(%zu bytes) failed", size);
+      return false;
+    }
+
+    // Only a hint, ignored when transparent huge pages are disabled.
+    this->transparentHugePages = hugePages && madvise(base, size, MADV_HUGEPAGE) == 0;
+  }
+
+  this->base = (unsigned char*) base;
+  this->size = size;
+  return true;
+}
+
+void* HostArena_Allocate(INOUT HostArena* this, IN size_t bytes) {
+  assert(this != NULL && this->base != NULL);
+
+  size_t offset = RoundUp(this->used, TR_HOSTARENA_ALIGNMENT);
+  if (offset > this->size || bytes > this->size - offset) {
+    TR_ERROR("The host arena is full (%zu bytes wanted, %zu left).", bytes, this->size - (offset < this->size ? offset : this->size));
+    return NULL;
+  }
+
+  this->used = offset + bytes;
+  return this->base + offset;
+}
+
+bool HostArena_Fill(INOUT HostArena* this, IN size_t count, IN ParallelBody fill, INOUT void* data) {
+  assert(this != NULL && fill != NULL);
+
+  // The faults of every thread are counted by RUSAGE_SELF.
+  struct rusage before, after;
+  bool counted = getrusage(RUSAGE_SELF, &before) == 0;
+  double startTime = TimerNow();
+
+  bool success = ParallelFor(count, fill, data);
+
+  this->populateMilliseconds += (TimerNow() - startTime) * 1e3;
+  if (counted && getrusage(RUSAGE_SELF, &after) == 0) {
+    this->minorFaults += after.ru_minflt - before.ru_minflt;
+    this->majorFaults += after.ru_majflt - before.ru_majflt;
+  }
+
+  return success;
+}
+
+void HostArena_Touch(INOUT HostArena* this, IN void* pointer, IN size_t bytes) {
+  assert(this != NULL && pointer != NULL);
+
+  // The allocations are aligned on TR_HOSTARENA_ALIGNMENT, not on huge pages.
+  TouchTask task = { .base = pointer, .pageSize = TR_HOSTARENA_ALIGNMENT };
+  HostArena_Fill(this, (bytes + task.pageSize - 1u) / task.pageSize, TouchPages, &task);
+}
+
+size_t HostArena_Mark(IN HostArena const* this) {
+  assert(this != NULL);
+  return this->used;
+}
+
+void HostArena_Reset(INOUT HostArena* this, IN size_t mark) {
+  assert(this != NULL && mark <= this->used);
+  this->used = mark;
+}
+
+bool HostArena_Release(INOUT HostArena* this) {
+  assert(this != NULL);
+
+  bool success = this->base == NULL || munmap(this->base, this->size) == 0;
+  if (!success) {
+    TR_ERROR("munmap(%zu bytes) failed", this->size);
+  }
+
+  *this = (HostArena) { 0 };
+  return success;
+}
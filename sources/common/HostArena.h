@@ -0,0 +1,102 @@
+#ifndef TR_COMMON_HOSTARENA_H
+#define TR_COMMON_HOSTARENA_H
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/helper.h" // IN, INOUT, OUT
+#include "common/parallel.h" // ParallelBody
+
+/// Alignment of every allocation of an arena (a page, as expected by
+/// `CL_MEM_USE_HOST_PTR` and by the vector loads of the host threads).
+#define TR_HOSTARENA_ALIGNMENT 4096u
+
+/// Size of a huge page (the default one on x86-64 and AArch64).
+#define TR_HOSTARENA_HUGE_PAGE_SIZE (2u << 20)
+
+///
+/// One region reserved up front for the host operands and the temporaries,
+/// handed out by bumping an offset.
+///
+/// The pages are not touched on creation: the first touch of an allocation
+/// is its parallel fill (see `HostArena_Fill()`), so that, with the first-touch
+/// policy, each page lands on the NUMA node of the thread writing its rows
+/// (the threads are not pinned, a migrated thread may leave pages behind).
+///
+typedef struct HostArena {
+  unsigned char* base;
+  size_t size, used;
+
+  /// Whether the region is backed by reserved huge pages (`MAP_HUGETLB`), or
+  /// only advised to use transparent ones (`MADV_HUGEPAGE`).
+  bool hugePages, transparentHugePages;
+
+  /// Time spent and page faults taken by the first touches of the region
+  /// (accumulated by `HostArena_Fill()` and `HostArena_Touch()`).
+  double populateMilliseconds;
+  long minorFaults, majorFaults;
+} HostArena;
+
+///
+/// Reserves a region of at least `size` bytes, with huge pages when
+/// `hugePages` (reserved ones first, transparent ones otherwise).
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `arena` is not NULL.
+/// @post `arena` must be released with `HostArena_Release()`.
+/// @post May display error on stderr.
+///
+bool HostArena_Create(IN size_t size, IN bool hugePages, OUT HostArena* arena);
+
+///
+/// Takes `bytes` from the arena, aligned on `TR_HOSTARENA_ALIGNMENT`.
+///
+/// @returns The allocation (not touched yet), or NULL if the arena is full.
+///
+/// @post May display error on stderr.
+///
+void* HostArena_Allocate(INOUT HostArena* arena, IN size_t bytes);
+
+///
+/// Runs `ParallelFor(count, fill, data)`, the fill being the first touch of
+/// the memory it writes, and accumulates its time and page faults into the
+/// arena.
+///
+/// @returns The result of `ParallelFor()`.
+///
+/// @pre `arena` and `fill` are not NULL.
+///
+bool HostArena_Fill(INOUT HostArena* arena, IN size_t count, IN ParallelBody fill, INOUT void* data);
+
+///
+/// Touches the pages of an allocation that is not filled on the host (e.g.
+/// a result read back from the device) in parallel, see `HostArena_Fill()`.
+///
+/// @pre `arena` and `pointer` are not NULL, `pointer` comes from `HostArena_Allocate()`.
+///
+void HostArena_Touch(INOUT HostArena* arena, IN void* pointer, IN size_t bytes);
+
+///
+/// Returns the current offset of the arena, the allocations made afterwards
+/// being given back together with `HostArena_Reset()` (pooled temporaries).
+///
+size_t HostArena_Mark(IN HostArena const* arena);
+
+///
+/// Gives back every allocation made since `mark`.
+///
+/// @pre `mark` comes from `HostArena_Mark()` and no later mark was reset.
+///
+void HostArena_Reset(INOUT HostArena* arena, IN size_t mark);
+
+///
+/// Unmaps the region of the arena.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @post May display error on stderr.
+///
+bool HostArena_Release(INOUT HostArena* arena);
+
+#endif // TR_COMMON_HOSTARENA_H
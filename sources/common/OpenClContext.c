@@ -4,8 +4,12 @@
 #include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t
 #include <stdio.h> // fprintf(), stderr
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // strlen(), strstr()
 
+#include "common/Devices.h" // Devices_Fastest()
 #include "common/OpenClContext.h" // OpenClContext{}
+#include "common/ProgramCache.h" // ProgramCache_Release()
 #include "common/helper.h" // IN, OUT, INOUT, TAB, LF, TR_FAILED()
 #include "common/parse.h" // ParseNumbers()
 #include "common/prefix.h" // IsPrefix()
@@ -32,6 +36,110 @@ static bool StringContains(
   return false;
 }
 
+///
+/// Queries one device information, zeroed if not supported by the device.
+///
+/// @returns `true` on success, `false` otherwise (then `value` is zeroed).
+///
+static bool QueryDeviceInfo(IN cl_device_id device, IN cl_device_info name, IN size_t size, OUT void* value) {
+  if (CL_SUCCESS != clGetDeviceInfo(device, name, size, value, NULL)) {
+    memset(value, 0, size);
+    return false;
+  }
+
+  return true;
+}
+
+bool OpenClContext_CreateStreams(INOUT OpenClContext* this, IN size_t count) {
+  assert(this != NULL && this->context != NULL && this->queue != NULL);
+  assert(count >= 1u && count <= TR_OPENCL_MAX_STREAMS);
+
+  cl_int error;
+  cl_queue_properties queueProperties[3] = { CL_QUEUE_PROPERTIES, CL_QUEUE_PROFILING_ENABLE, 0u };
+
+  this->streams[0] = this->queue;
+  this->streamCount = this->streamCount > 0u ? this->streamCount : 1u;
+
+  while (this->streamCount < count) {
+    cl_command_queue queue = clCreateCommandQueueWithProperties(this->context, this->device, queueProperties, &error);
+    if (error != CL_SUCCESS || queue == NULL) {
+      TR_FAILED("clCreateCommandQueueWithProperties(stream)", error);
+
+      for (size_t index = 1u; index < this->streamCount; ++index) {
+        clReleaseCommandQueue(this->streams[index]);
+      }
+
+      this->streamCount = 1u;
+      return false;
+    }
+
+    this->streams[this->streamCount++] = queue;
+  }
+
+  return true;
+}
+
+void OpenClContext_QueryCapabilities(IN cl_device_id device, OUT OpenClCapabilities* capabilities) {
+  assert(device != NULL && capabilities != NULL);
+
+  OpenClCapabilities* this = capabilities;
+  *this = (OpenClCapabilities) { 0 };
+
+  QueryDeviceInfo(device, CL_DEVICE_MAX_COMPUTE_UNITS, sizeof(this->computeUnits), &this->computeUnits);
+  QueryDeviceInfo(device, CL_DEVICE_MAX_CLOCK_FREQUENCY, sizeof(this->clockFrequency), &this->clockFrequency);
+  QueryDeviceInfo(device, CL_DEVICE_GLOBAL_MEM_SIZE, sizeof(this->globalMemorySize), &this->globalMemorySize);
+  QueryDeviceInfo(device, CL_DEVICE_MAX_MEM_ALLOC_SIZE, sizeof(this->maxAllocationSize), &this->maxAllocationSize);
+  QueryDeviceInfo(device, CL_DEVICE_LOCAL_MEM_SIZE, sizeof(this->localMemorySize), &this->localMemorySize);
+  QueryDeviceInfo(device, CL_DEVICE_MAX_CONSTANT_BUFFER_SIZE, sizeof(this->constantMemorySize), &this->constantMemorySize);
+  QueryDeviceInfo(device, CL_DEVICE_MAX_WORK_GROUP_SIZE, sizeof(this->maxWorkGroupSize), &this->maxWorkGroupSize);
+  QueryDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_FLOAT, sizeof(this->vectorWidthFloat), &this->vectorWidthFloat);
+  QueryDeviceInfo(device, CL_DEVICE_PREFERRED_VECTOR_WIDTH_DOUBLE, sizeof(this->vectorWidthDouble), &this->vectorWidthDouble);
+  QueryDeviceInfo(device, CL_DEVICE_MAX_NUM_SUB_GROUPS, sizeof(this->maxSubGroups), &this->maxSubGroups);
+  QueryDeviceInfo(device, CL_DEVICE_SVM_CAPABILITIES, sizeof(this->svmCapabilities), &this->svmCapabilities);
+  QueryDeviceInfo(device, CL_DEVICE_IMAGE_SUPPORT, sizeof(this->imageSupport), &this->imageSupport);
+  QueryDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_WIDTH, sizeof(this->image2dMaxWidth), &this->image2dMaxWidth);
+  QueryDeviceInfo(device, CL_DEVICE_IMAGE2D_MAX_HEIGHT, sizeof(this->image2dMaxHeight), &this->image2dMaxHeight);
+
+  // At least 3 dimensions are guaranteed by the specification.
+  cl_uint dimensions = 0u;
+  QueryDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_DIMENSIONS, sizeof(dimensions), &dimensions);
+  if (dimensions >= 3u) {
+    size_t sizes[dimensions];
+    if (QueryDeviceInfo(device, CL_DEVICE_MAX_WORK_ITEM_SIZES, sizeof(size_t) * dimensions, sizes)) {
+      memcpy(this->maxWorkItemSizes, sizes, sizeof(this->maxWorkItemSizes));
+    }
+  }
+
+  size_t extensionsLength = 0u;
+  if (CL_SUCCESS == clGetDeviceInfo(device, CL_DEVICE_EXTENSIONS, 0u, NULL, &extensionsLength) && extensionsLength > 0u) {
+    this->extensions = (char*) malloc(extensionsLength);
+    if (this->extensions != NULL && !QueryDeviceInfo(device, CL_DEVICE_EXTENSIONS, extensionsLength, this->extensions)) {
+      free(this->extensions);
+      this->extensions = NULL;
+    }
+  }
+
+  // Only meaningful with cl_khr_image2d_from_buffer (core in OpenCL 2.0, but optional in 3.0).
+  if (this->imageSupport && this->extensions != NULL && strstr(this->extensions, "cl_khr_image2d_from_buffer") != NULL) {
+    QueryDeviceInfo(device, CL_DEVICE_IMAGE_PITCH_ALIGNMENT, sizeof(this->imagePitchAlignment), &this->imagePitchAlignment);
+  }
+
+  // The sizes are only listed by Intel (CL_DEVICE_SUB_GROUP_SIZES_INTEL).
+  size_t sizesLength = 0u;
+  if (this->extensions != NULL && strstr(this->extensions, "cl_intel_required_subgroup_size") != NULL
+    && CL_SUCCESS == clGetDeviceInfo(device, CL_DEVICE_SUB_GROUP_SIZES_INTEL, 0u, NULL, &sizesLength)) {
+    size_t count = sizesLength / sizeof(size_t);
+    count = count < TR_OPENCL_SUB_GROUP_SIZES ? count : TR_OPENCL_SUB_GROUP_SIZES;
+    if (count > 0u) {
+      size_t sizes[sizesLength / sizeof(size_t)];
+      if (QueryDeviceInfo(device, CL_DEVICE_SUB_GROUP_SIZES_INTEL, sizesLength, sizes)) {
+        memcpy(this->subGroupSizes, sizes, sizeof(size_t) * count);
+        this->subGroupSizeCount = count;
+      }
+    }
+  }
+}
+
 bool OpenClContext_FromDeviceType(IN cl_device_type type, OUT OpenClContext* output) {
   assert(output != NULL);
 
@@ -153,6 +261,10 @@ outPlatforms:
     output->device = device;
     output->queue = queue;
     output->fp64Extension = false;
+    OpenClContext_QueryCapabilities(device, &output->capabilities);
+    output->streams[0] = queue;
+    output->streamCount = 1u;
+    output->subDevice = false;
   }
   else {
     output->context = NULL;
@@ -160,6 +272,9 @@ outPlatforms:
     output->device = NULL;
     output->queue = NULL;
     output->fp64Extension = false;
+    output->capabilities = (OpenClCapabilities) { 0 };
+    output->streamCount = 0u;
+    output->subDevice = false;
   }
 
   return success;
@@ -287,6 +402,10 @@ outPlatforms:
     output->device = device;
     output->queue = queue;
     output->fp64Extension = false;
+    OpenClContext_QueryCapabilities(device, &output->capabilities);
+    output->streams[0] = queue;
+    output->streamCount = 1u;
+    output->subDevice = false;
   }
   else {
     output->context = NULL;
@@ -294,11 +413,87 @@ outPlatforms:
     output->device = NULL;
     output->queue = NULL;
     output->fp64Extension = false;
+    output->capabilities = (OpenClCapabilities) { 0 };
+    output->streamCount = 0u;
+    output->subDevice = false;
   }
 
   return success;
 }
 
+bool OpenClContext_FromNumaNodes(IN OpenClContext const* parent, OUT OpenClContext* nodes, OUT size_t* count) {
+  assert(parent != NULL && parent->device != NULL);
+  assert(nodes != NULL && count != NULL);
+
+  cl_device_id devices[TR_OPENCL_MAX_NODES] = { NULL };
+  cl_uint deviceCount = 0u;
+  *count = 0u;
+
+  cl_device_partition_property properties[3] = {
+    CL_DEVICE_PARTITION_BY_AFFINITY_DOMAIN, CL_DEVICE_AFFINITY_DOMAIN_NUMA, 0
+  };
+
+  // Counts the nodes first: num_entries below the number of sub-devices
+  // would fail with CL_INVALID_VALUE.
+  cl_int error = clCreateSubDevices(parent->device, properties, 0u, NULL, &deviceCount);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clCreateSubDevices(NUMA count)", error);
+    return false;
+  }
+
+  if (deviceCount == 0u || deviceCount > TR_OPENCL_MAX_NODES) {
+    TR_ERROR("The device has %u NUMA nodes, but between 1 and %u are supported (TR_OPENCL_MAX_NODES).", deviceCount, TR_OPENCL_MAX_NODES);
+    return false;
+  }
+
+  error = clCreateSubDevices(parent->device, properties, deviceCount, devices, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clCreateSubDevices(NUMA)", error);
+    return false;
+  }
+
+  for (cl_uint index = 0u; index < deviceCount; ++index) {
+    OpenClContext* node = &nodes[index];
+    *node = (OpenClContext) { .platform = parent->platform, .device = devices[index], .subDevice = true };
+
+    cl_context_properties contextProperties[3] = { CL_CONTEXT_PLATFORM, (cl_context_properties) parent->platform, 0u };
+    node->context = clCreateContext(contextProperties, 1, &devices[index], NULL, NULL, &error);
+    if (error != CL_SUCCESS || node->context == NULL) {
+      TR_FAILED("clCreateContext(NUMA)", error);
+      goto outFailure;
+    }
+
+    cl_queue_properties queueProperties[3] = { CL_QUEUE_PROPERTIES, CL_QUEUE_PROFILING_ENABLE, 0u };
+    node->queue = clCreateCommandQueueWithProperties(node->context, devices[index], queueProperties, &error);
+    if (error != CL_SUCCESS || node->queue == NULL) {
+      TR_FAILED("clCreateCommandQueueWithProperties(NUMA)", error);
+      clReleaseContext(node->context);
+      goto outFailure;
+    }
+
+    node->fp64Extension = parent->fp64Extension;
+    OpenClContext_QueryCapabilities(devices[index], &node->capabilities);
+    node->streams[0] = node->queue;
+    node->streamCount = 1u;
+    *count += 1u;
+  }
+
+  return true;
+
+outFailure:
+  for (size_t index = 0u; index < *count; ++index) {
+    OpenClContext_Release(&nodes[index]);
+  }
+
+  // The sub-devices not yet owned by a context.
+  for (size_t index = *count; index < deviceCount; ++index) {
+    clReleaseDevice(devices[index]);
+  }
+
+  *count = 0u;
+  return false;
+}
+
 int OpenClContext_FromString(IN char const* option, OUT OpenClContext* context) {
   assert(context != NULL);
   assert(option != NULL);
@@ -316,6 +511,12 @@ int OpenClContext_FromString(IN char const* option, OUT OpenClContext* context)
     return OpenClContext_FromDeviceType(CL_DEVICE_TYPE_DEFAULT, context);
   }
 
+  if (IsPrefix(option, "Fastest", 8)) {
+    size_t platformIndex = 0u, deviceIndex = 0u;
+    return Devices_Fastest(&platformIndex, &deviceIndex)
+      && OpenClContext_FromIndexes(platformIndex, deviceIndex, context);
+  }
+
   size_t indexes[2] = { 0u, 0u };
   char const* cursor = option;
   if (ParseNumbers(&cursor, indexes, 2)) {
@@ -332,6 +533,22 @@ bool OpenClContext_Release(INOUT OpenClContext* this) {
   bool success = true;
   cl_int error;
 
+  // Cached programs and kernels must not outlive their context.
+  if (!ProgramCache_Release(this)) {
+    TR_ERROR("ProgramCache_Release() failed");
+    success = false;
+  }
+
+  // The first stream is the default queue, released below.
+  for (size_t index = 1u; index < this->streamCount; ++index) {
+    if (CL_SUCCESS != (error = clReleaseCommandQueue(this->streams[index]))) {
+      TR_FAILED("clReleaseCommandQueue(stream)", error);
+      success = false;
+    }
+  }
+
+  this->streamCount = 0u;
+
   if (this->queue != NULL) {
     error = clReleaseCommandQueue(this->queue);
     if (error != CL_SUCCESS) {
@@ -348,6 +565,14 @@ bool OpenClContext_Release(INOUT OpenClContext* this) {
     }
   }
 
+  OpenClContext_ReleaseCapabilities(&this->capabilities);
+
+  if (this->subDevice && CL_SUCCESS != (error = clReleaseDevice(this->device))) {
+    TR_FAILED("clReleaseDevice()", error);
+    success = false;
+  }
+
+  this->subDevice = false;
   this->context = NULL;
   this->platform = NULL;
   this->device = NULL;
@@ -419,6 +644,37 @@ bool OpenClContext_EnableDoublePrecision(INOUT OpenClContext* this) {
   return this->fp64Extension;
 }
 
+void OpenClContext_ReleaseCapabilities(INOUT OpenClCapabilities* this) {
+  assert(this != NULL);
+
+  if (this->extensions != NULL) {
+    free(this->extensions);
+  }
+
+  *this = (OpenClCapabilities) { 0 };
+}
+
+bool OpenClContext_HasExtension(IN OpenClContext const* this, IN char const* extension) {
+  assert(this != NULL && extension != NULL);
+
+  char const* extensions = this->capabilities.extensions;
+  size_t length = strlen(extension);
+  if (extensions == NULL || length == 0u) {
+    return false;
+  }
+
+  // Whole words only (e.g. cl_khr_fp16 must not match cl_khr_fp16_something).
+  for (char const* found = strstr(extensions, extension); found != NULL; found = strstr(found + 1, extension)) {
+    bool starts = found == extensions || found[-1] == ' ';
+    bool ends = found[length] == '\0' || found[length] == ' ';
+    if (starts && ends) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 bool OpenClContext_DisplayInformations(IN OpenClContext* this) {
   assert(this != NULL);
 
@@ -509,11 +765,66 @@ bool OpenClContext_DisplayInformations(IN OpenClContext* this) {
     , bits
   );
 
-  // TODO: Display more informations (see clinfo --raw)
-  // - Local memory CL_DEVICE_LOCAL_MEM_SIZE cl_ulong
-  // - Global memory
-  // - work group
-  // - work item
+  #define TR_DEVICE_UNITS      TAB2 "Compute.Units..: "
+  #define TR_DEVICE_GLOBAL     TAB2 "Global.Memory..: "
+  #define TR_DEVICE_LOCAL      TAB2 "Local.Memory...: "
+  #define TR_DEVICE_CONSTANT   TAB2 "Constant.Memory: "
+  #define TR_DEVICE_WORK_GROUP TAB2 "Work-Group.Size: "
+  #define TR_DEVICE_VECTORS    TAB2 "Vector.Widths..: "
+  #define TR_DEVICE_SUB_GROUPS TAB2 "Sub-Groups.....: "
+  #define TR_DEVICE_SVM        TAB2 "Shared.Memory..: "
+  #define TR_DEVICE_IMAGES     TAB2 "Images.........: "
+  #define TR_DEVICE_UNKNOWN    "Unknown"
+
+  OpenClCapabilities const* capabilities = &this->capabilities;
+  printf(TR_DEVICE_UNITS "%u @ %u MHz" LF, capabilities->computeUnits, capabilities->clockFrequency);
+
+  printf(TR_DEVICE_GLOBAL "%.1f MiB (%.1f MiB per buffer)" LF
+    , (double) capabilities->globalMemorySize / (1024.0 * 1024.0)
+    , (double) capabilities->maxAllocationSize / (1024.0 * 1024.0)
+  );
+
+  printf(TR_DEVICE_LOCAL "%.1f KiB" LF, (double) capabilities->localMemorySize / 1024.0);
+  printf(TR_DEVICE_CONSTANT "%.1f KiB" LF, (double) capabilities->constantMemorySize / 1024.0);
+
+  printf(TR_DEVICE_WORK_GROUP "%zu work-items (%zu x %zu x %zu)" LF
+    , capabilities->maxWorkGroupSize
+    , capabilities->maxWorkItemSizes[0]
+    , capabilities->maxWorkItemSizes[1]
+    , capabilities->maxWorkItemSizes[2]
+  );
+
+  printf(TR_DEVICE_VECTORS "float%u, double%u" LF
+    , capabilities->vectorWidthFloat, capabilities->vectorWidthDouble);
+
+  if (capabilities->maxSubGroups == 0u && capabilities->subGroupSizeCount == 0u) {
+    printf(TR_DEVICE_SUB_GROUPS TR_DEVICE_UNKNOWN LF);
+  }
+  else {
+    printf(TR_DEVICE_SUB_GROUPS "%u per work-group, sizes", capabilities->maxSubGroups);
+    for (size_t index = 0u; index < capabilities->subGroupSizeCount; ++index) {
+      printf(" %zu", capabilities->subGroupSizes[index]);
+    }
+
+    printf("%s" LF, capabilities->subGroupSizeCount == 0u ? " " TR_DEVICE_UNKNOWN : "");
+  }
+
+  cl_device_svm_capabilities svm = capabilities->svmCapabilities;
+  printf(TR_DEVICE_SVM "%s" LF
+    , svm & CL_DEVICE_SVM_FINE_GRAIN_SYSTEM ? "Fine-Grained System"
+    : svm & CL_DEVICE_SVM_FINE_GRAIN_BUFFER ? "Fine-Grained Buffer"
+    : svm & CL_DEVICE_SVM_COARSE_GRAIN_BUFFER ? "Coarse-Grained Buffer"
+    : "None"
+  );
+
+  if (!capabilities->imageSupport) {
+    printf(TR_DEVICE_IMAGES "None" LF);
+  }
+  else {
+    printf(TR_DEVICE_IMAGES "2D up to %zu x %zu%s" LF
+      , capabilities->image2dMaxWidth, capabilities->image2dMaxHeight
+      , capabilities->imagePitchAlignment > 0u ? ", from buffers" : "");
+  }
 
   printf(LF);
   return true;
@@ -3,8 +3,60 @@
 
 #include <CL/opencl.h> // Khronos API
 #include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
 #include "common/helper.h" // IN, INOUT, OUT
 
+/// Maximum number of sub-group sizes kept in `OpenClCapabilities`.
+#define TR_OPENCL_SUB_GROUP_SIZES 8u
+
+///
+/// The limits and preferences of a device, queried once with the context and
+/// used to pick and validate the launch parameters before any allocation.
+///
+/// A limit is 0 when the query is not supported (e.g. sub-groups before OpenCL
+/// 2.1), it must then be considered as unknown rather than as null.
+///
+typedef struct OpenClCapabilities {
+  cl_uint computeUnits;
+  cl_uint clockFrequency; // MHz
+
+  cl_ulong globalMemorySize;
+  cl_ulong maxAllocationSize; // Of a single buffer.
+  cl_ulong localMemorySize; // Per work-group.
+  cl_ulong constantMemorySize;
+
+  size_t maxWorkGroupSize;
+  size_t maxWorkItemSizes[3];
+
+  /// Preferred vector widths (e.g. `float4` if 4), 0 if the type is unsupported.
+  cl_uint vectorWidthFloat, vectorWidthDouble;
+
+  /// Maximum number of sub-groups in a work-group, and the supported sub-group
+  /// sizes (from cl_intel_required_subgroup_size).
+  cl_uint maxSubGroups;
+  size_t subGroupSizes[TR_OPENCL_SUB_GROUP_SIZES];
+  size_t subGroupSizeCount;
+
+  /// Shared virtual memory support (`CL_DEVICE_SVM_*` bits, from OpenCL 2.0).
+  cl_device_svm_capabilities svmCapabilities;
+
+  /// Image support and the largest 2D image (in pixels), and the row pitch
+  /// alignment (in pixels) of the images created from buffers, 0 without
+  /// cl_khr_image2d_from_buffer.
+  cl_bool imageSupport;
+  size_t image2dMaxWidth, image2dMaxHeight;
+  cl_uint imagePitchAlignment;
+
+  /// Space-separated device extensions (owned by the context, may be NULL).
+  char* extensions;
+} OpenClCapabilities;
+
+/// Maximum number of command queues of a context (see `OpenClContext_CreateStreams()`).
+#define TR_OPENCL_MAX_STREAMS 16u
+
+/// Maximum number of NUMA nodes of a device (see `OpenClContext_FromNumaNodes()`).
+#define TR_OPENCL_MAX_NODES 8u
+
 ///
 /// A `OpenClContext` consists of an OpenCL context with one attached device
 /// with its platform and a default queue.
@@ -18,6 +70,17 @@ typedef struct OpenClContext {
   /// Whether or not the double-precision extension is available.
   /// (Coming from cl_khr_fp64 or cl_amd_fp64)
   bool fp64Extension;
+
+  /// The limits of the device (see `OpenClCapabilities`).
+  OpenClCapabilities capabilities;
+
+  /// Independent in-order queues (with profiling) sharing the device, the
+  /// first one being `queue` (see `OpenClContext_CreateStreams()`).
+  cl_command_queue streams[TR_OPENCL_MAX_STREAMS];
+  size_t streamCount;
+
+  /// Whether `device` is a sub-device owned by the context (released with it).
+  bool subDevice;
 } OpenClContext;
 
 ///
@@ -45,6 +108,7 @@ bool OpenClContext_FromIndexes(IN size_t platformIndex, IN size_t deviceIndex, O
 ///
 /// Given string may contains the following values (or prefix, case-insensitive):
 ///   - `GPU`, `CPU` or `Default` to get first available required device,
+///   - `Fastest` to get the best ranked device (see `Devices_Fastest()`),
 ///   - `P:D` where `P` is the platform index and `D` the device index.
 ///
 /// @returns `2` for an unknown option, `1` on success, `0` otherwise.
@@ -65,6 +129,23 @@ int OpenClContext_FromString(IN char const* option, OUT OpenClContext* context);
 ///
 bool OpenClContext_Release(INOUT OpenClContext* context);
 
+///
+/// Partitions the device of a context by NUMA node (`clCreateSubDevices()` by
+/// affinity domain), then creates one `OpenClContext` per sub-device, with its
+/// own context and queue, thus with its own node-local buffers.
+///
+/// The double-precision support is inherited from `parent`.
+///
+/// @returns `true` on success, `false` otherwise (e.g. not a multi-node CPU,
+///          or more than `TR_OPENCL_MAX_NODES` nodes, which are rejected).
+///
+/// @pre `parent` is not NULL and already initialized.
+/// @pre `nodes` has `TR_OPENCL_MAX_NODES` contexts, `count` is not NULL.
+/// @post Each of the `count` contexts must be released with `OpenClContext_Release()`.
+/// @post May display error on stderr.
+///
+bool OpenClContext_FromNumaNodes(IN OpenClContext const* parent, OUT OpenClContext* nodes, OUT size_t* count);
+
 ///
 /// Checks if double-precision floating-point extension is available and updates
 /// the `OpenClContext` accordingly.
@@ -76,6 +157,47 @@ bool OpenClContext_Release(INOUT OpenClContext* context);
 ///
 bool OpenClContext_EnableDoublePrecision(INOUT OpenClContext* context);
 
+///
+/// Creates `count - 1` more command queues next to the default one, so that
+/// independent commands (e.g. small kernels) may run concurrently.
+///
+/// @returns `true` on success, `false` otherwise (then only `queue` remains).
+///
+/// @pre `context` is not NULL and already initialized.
+/// @pre `1 <= count <= TR_OPENCL_MAX_STREAMS`.
+/// @post May display error on stderr.
+///
+bool OpenClContext_CreateStreams(INOUT OpenClContext* context, IN size_t count);
+
+///
+/// Queries the limits and preferences of a device (see `OpenClCapabilities`),
+/// done once by the `OpenClContext` factories.
+///
+/// The unsupported queries are left to 0 (i.e. unknown) rather than failing,
+/// since they depend on the OpenCL version and on vendor extensions.
+///
+/// @pre `device` and `capabilities` are not NULL.
+/// @post `capabilities` must be released with `OpenClContext_ReleaseCapabilities()`.
+///
+void OpenClContext_QueryCapabilities(IN cl_device_id device, OUT OpenClCapabilities* capabilities);
+
+///
+/// Releases the capabilities queried by `OpenClContext_QueryCapabilities()`.
+///
+/// @pre `capabilities` is not NULL.
+///
+void OpenClContext_ReleaseCapabilities(INOUT OpenClCapabilities* capabilities);
+
+///
+/// Checks if the device supports the given extension (e.g. `cl_khr_subgroups`).
+///
+/// @returns `true` if listed in the device extensions, `false` otherwise.
+///
+/// @pre `context` is not NULL and already initialized.
+/// @pre `extension` is not NULL and null-terminated.
+///
+bool OpenClContext_HasExtension(IN OpenClContext const* context, IN char const* extension);
+
 ///
 /// Displays informations about the associated platform and device of the context.
 ///
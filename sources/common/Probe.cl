@@ -0,0 +1,66 @@
+#ifndef PROBE_ITERATIONS // Loop count of ProbeFma.
+#define PROBE_ITERATIONS 256
+#endif
+
+#ifndef PROBE_REAL // float or double.
+#define PROBE_REAL float
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define PROBE_CONCAT_(A, B) A ## B
+#define PROBE_CONCAT(A, B) PROBE_CONCAT_(A, B)
+#define PROBE_REAL4 PROBE_CONCAT(PROBE_REAL, 4)
+
+#define IN
+#define OUT
+#define INOUT
+
+///
+/// Fused multiply-add throughput: 4 independent `PROBE_REAL4` chains, i.e. 32
+/// flops per iteration and per work-item, with a dependency the compiler cannot
+/// fold.
+///
+/// @pre `output` has get_global_size(0) elements.
+///
+__kernel void ProbeFma(
+  IN  PROBE_REAL const seed,
+  OUT __global PROBE_REAL* output)
+{
+  size_t id = get_global_id(0);
+
+  PROBE_REAL4 a = (PROBE_REAL4) (seed) + (PROBE_REAL) id;
+  PROBE_REAL4 b = a + (PROBE_REAL4) (1.0f, 2.0f, 3.0f, 4.0f);
+  PROBE_REAL4 c = a + (PROBE_REAL4) (5.0f, 6.0f, 7.0f, 8.0f);
+  PROBE_REAL4 d = a + (PROBE_REAL4) (9.0f, 10.0f, 11.0f, 12.0f);
+  PROBE_REAL4 const x = (PROBE_REAL4) (0.999f);
+  PROBE_REAL4 const y = (PROBE_REAL4) (0.001f);
+
+  for (int iteration = 0; iteration < PROBE_ITERATIONS; ++iteration) {
+    a = fma(a, x, y);
+    b = fma(b, x, y);
+    c = fma(c, x, y);
+    d = fma(d, x, y);
+  }
+
+  PROBE_REAL4 sum = (a + b) + (c + d);
+  output[id] = sum.x + sum.y + sum.z + sum.w;
+}
+
+///
+/// Global memory bandwidth: a plain copy, i.e. `2 * sizeof(PROBE_REAL4)` bytes
+/// moved per work-item.
+///
+/// @pre `input` and `output` have get_global_size(0) elements.
+///
+__kernel void ProbeCopy(
+  IN  __global PROBE_REAL4 const* input,
+  OUT __global PROBE_REAL4* output)
+{
+  size_t id = get_global_id(0);
+  output[id] = input[id];
+}
@@ -0,0 +1,421 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <stdatomic.h> // atomic_bool, atomic_uint, atomic_exchange(), atomic_fetch_sub()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // snprintf()
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // strcmp(), strlen()
+#include <threads.h> // mtx_*(), cnd_*()
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/ProgramCache.h" // Self
+#include "common/helper.h" // IN, INOUT, OUT, TR_FAILED()
+#include "common/timer.h" // TimerNow()
+
+///
+/// A cached kernel, the key being (`context`, `source`, `options`, `kernelName`).
+///
+/// Each entry holds its own reference on `program` which may be shared between
+/// several entries (several kernels of the same program).
+///
+typedef struct ProgramCacheEntry {
+  cl_context context;
+  char const* source;
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE];
+  char kernelName[TR_PROGRAMCACHE_NAME_SIZE];
+
+  cl_program program;
+  cl_kernel kernel;
+
+  /// Logical time of the last access (0 means the entry is empty).
+  size_t lastUse;
+} ProgramCacheEntry;
+
+///
+/// The cache is shared by every thread (e.g. the producers of `Submitter`),
+/// thus its entries and counters are guarded by `mutex`, initialized once.
+///
+static struct {
+  ProgramCacheEntry entries[TR_PROGRAMCACHE_CAPACITY];
+  size_t clock;
+  size_t hits, misses;
+  mtx_t mutex;
+} cache = { 0 };
+
+static once_flag cacheOnce = ONCE_FLAG_INIT;
+
+static void InitializeCache(void) {
+  if (mtx_init(&cache.mutex, mtx_plain) != thrd_success) {
+    TR_ERROR("mtx_init(cache) failed");
+  }
+}
+
+///
+/// Locks the cache (initialized on first use).
+///
+static void LockCache(void) {
+  call_once(&cacheOnce, InitializeCache);
+  mtx_lock(&cache.mutex);
+}
+
+///
+/// Releases the resources of an entry and marks it as empty.
+///
+static bool ReleaseEntry(INOUT ProgramCacheEntry* entry) {
+  assert(entry != NULL);
+
+  bool success = true;
+  cl_int error;
+
+  if (entry->kernel != NULL && CL_SUCCESS != (error = clReleaseKernel(entry->kernel))) {
+    TR_FAILED("clReleaseKernel()", error);
+    success = false;
+  }
+
+  if (entry->program != NULL && CL_SUCCESS != (error = clReleaseProgram(entry->program))) {
+    TR_FAILED("clReleaseProgram()", error);
+    success = false;
+  }
+
+  *entry = (ProgramCacheEntry) { 0 };
+  return success;
+}
+
+///
+/// Looks for the entry matching the key of the given build.
+///
+/// @param sibling Set to the program of an entry with the same source and
+///                options but another kernel name, if any.
+///
+/// @returns The matching entry or NULL.
+///
+static ProgramCacheEntry* FindEntry(IN ProgramBuild const* build, OUT cl_program* sibling) {
+  assert(build != NULL && sibling != NULL);
+
+  *sibling = NULL;
+  for (size_t index = 0u; index < TR_PROGRAMCACHE_CAPACITY; ++index) {
+    ProgramCacheEntry* entry = &cache.entries[index];
+    if (entry->lastUse == 0u || entry->context != build->openCl->context
+      || entry->source != build->source || strcmp(entry->options, build->options) != 0) {
+      continue;
+    }
+
+    if (strcmp(entry->kernelName, build->kernelName) == 0) {
+      return entry;
+    }
+
+    *sibling = entry->program;
+  }
+
+  return NULL;
+}
+
+///
+/// Stores a program and its kernel in the cache, evicting the least recently
+/// used entry if needed (kernels still in use keep their own reference).
+///
+/// The cache takes ownership of one reference on both `program` and `kernel`.
+///
+static void InsertEntry(IN ProgramBuild const* build, IN cl_program program, IN cl_kernel kernel) {
+  assert(build != NULL && program != NULL && kernel != NULL);
+
+  ProgramCacheEntry* victim = &cache.entries[0];
+  for (size_t index = 1u; index < TR_PROGRAMCACHE_CAPACITY; ++index) {
+    if (cache.entries[index].lastUse < victim->lastUse) {
+      victim = &cache.entries[index]; // Least recently used (or empty).
+    }
+  }
+
+  if (victim->lastUse != 0u) {
+    ReleaseEntry(victim);
+  }
+
+  cache.clock += 1u;
+  victim->context = build->openCl->context;
+  victim->source = build->source;
+  snprintf(victim->options, TR_PROGRAMCACHE_OPTIONS_SIZE, "%s", build->options);
+  snprintf(victim->kernelName, TR_PROGRAMCACHE_NAME_SIZE, "%s", build->kernelName);
+  victim->program = program;
+  victim->kernel = kernel;
+  victim->lastUse = cache.clock;
+}
+
+///
+/// The state of a build shared by `ProgramCache_WaitKernel()` and the build
+/// callback, on the heap since some drivers still call the callback after
+/// `clBuildProgram()` failed, i.e. possibly after the waiter returned. It is
+/// freed by the last of them (see `ReleaseShared()`).
+///
+typedef struct ProgramBuildShared {
+  mtx_t mutex;
+  cnd_t condition;
+  bool done;
+  double endTime;
+
+  /// Set by the first completion (see `CompleteBuild()`).
+  atomic_bool completed;
+  atomic_uint references;
+} ProgramBuildShared;
+
+static ProgramBuildShared* CreateShared(IN unsigned references) {
+  ProgramBuildShared* shared = (ProgramBuildShared*) malloc(sizeof(ProgramBuildShared));
+  if (shared == NULL) {
+    TR_ERROR("malloc(ProgramBuildShared) failed");
+    return NULL;
+  }
+
+  *shared = (ProgramBuildShared) { .done = false };
+  if (mtx_init(&shared->mutex, mtx_plain) != thrd_success) {
+    TR_ERROR("mtx_init() failed");
+    free(shared);
+    return NULL;
+  }
+
+  if (cnd_init(&shared->condition) != thrd_success) {
+    TR_ERROR("cnd_init() failed");
+    mtx_destroy(&shared->mutex);
+    free(shared);
+    return NULL;
+  }
+
+  atomic_init(&shared->completed, false);
+  atomic_init(&shared->references, references);
+  return shared;
+}
+
+static void ReleaseShared(INOUT ProgramBuildShared* shared) {
+  if (atomic_fetch_sub(&shared->references, 1u) != 1u) {
+    return;
+  }
+
+  cnd_destroy(&shared->condition);
+  mtx_destroy(&shared->mutex);
+  free(shared);
+}
+
+///
+/// Marks the build as complete and wakes up `ProgramCache_WaitKernel()`, only
+/// the first time (the callback may follow a synchronous failure).
+///
+static void CompleteBuild(INOUT ProgramBuildShared* shared) {
+  if (atomic_exchange(&shared->completed, true)) {
+    return;
+  }
+
+  mtx_lock(&shared->mutex);
+  shared->endTime = TimerNow();
+  shared->done = true;
+  cnd_signal(&shared->condition);
+  mtx_unlock(&shared->mutex);
+}
+
+///
+/// Called by the OpenCL runtime (possibly from another thread) once the build
+/// of the program is complete, successfully or not, then drops its reference.
+///
+static void CL_CALLBACK OnProgramBuilt(IN cl_program program, IN void* data) {
+  (void) program;
+  CompleteBuild((ProgramBuildShared*) data);
+  ReleaseShared((ProgramBuildShared*) data);
+}
+
+bool ProgramCache_BuildAsync(
+  IN OpenClContext* openCl,
+  IN char const* sourceStart,
+  IN char const* sourceEnd,
+  IN char const* options,
+  IN char const* kernelName,
+  OUT ProgramBuild* build)
+{
+  assert(openCl != NULL && openCl->context != NULL && openCl->device != NULL);
+  assert(sourceStart != NULL && sourceStart <= sourceEnd);
+  assert(options != NULL && kernelName != NULL);
+  assert(build != NULL);
+
+  cl_int error;
+
+  if (strlen(options) >= TR_PROGRAMCACHE_OPTIONS_SIZE || strlen(kernelName) >= TR_PROGRAMCACHE_NAME_SIZE) {
+    TR_ERROR("The build options or kernel name are too long to be cached.");
+    return false;
+  }
+
+  *build = (ProgramBuild) { .openCl = openCl, .source = sourceStart };
+  snprintf(build->options, TR_PROGRAMCACHE_OPTIONS_SIZE, "%s", options);
+  snprintf(build->kernelName, TR_PROGRAMCACHE_NAME_SIZE, "%s", kernelName);
+  build->startTime = build->endTime = TimerNow();
+
+  // ╦ ╦┬┌┬┐
+  // ╠═╣│ │
+  // ╩ ╩┴ ┴
+
+  LockCache();
+  cl_program sibling = NULL;
+  ProgramCacheEntry* entry = FindEntry(build, &sibling);
+  if (entry != NULL) {
+    error = clRetainKernel(entry->kernel);
+    if (error != CL_SUCCESS) {
+      mtx_unlock(&cache.mutex);
+      TR_FAILED("clRetainKernel()", error);
+      return false;
+    }
+
+    cache.clock += 1u;
+    cache.hits += 1u;
+    entry->lastUse = cache.clock;
+    build->kernel = entry->kernel;
+    mtx_unlock(&cache.mutex);
+    return true;
+  }
+
+  // ╔╦╗┬┌─┐┌─┐
+  // ║║║│└─┐└─┐
+  // ╩ ╩┴└─┘└─┘
+
+  cache.misses += 1u;
+
+  // Retained under the lock, since the entry may be evicted by another thread.
+  if (sibling != NULL) {
+    error = clRetainProgram(sibling);
+    mtx_unlock(&cache.mutex);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clRetainProgram()", error);
+      return false;
+    }
+
+    build->program = sibling; // Already built.
+    return true;
+  }
+
+  // Two threads missing the same key both build it, the first entry is evicted later.
+  mtx_unlock(&cache.mutex);
+
+  size_t sourceLength = (size_t) (sourceEnd - sourceStart);
+  build->program = clCreateProgramWithSource(openCl->context, 1, &sourceStart, &sourceLength, &error);
+  if (error != CL_SUCCESS || build->program == NULL) {
+    TR_FAILED("clCreateProgramWithSource()", error);
+    return false;
+  }
+
+  // One reference for the waiter, one for the callback.
+  build->shared = CreateShared(2u);
+  if (build->shared == NULL) {
+    clReleaseProgram(build->program);
+    return false;
+  }
+
+  // With a callback, clBuildProgram() may return as soon as the build has begun.
+  error = clBuildProgram(build->program, 1, &openCl->device, build->options, OnProgramBuilt, build->shared);
+  if (error != CL_SUCCESS) {
+    // The build status is checked (and errors displayed) by ProgramCache_WaitKernel().
+    // The reference of the callback is kept, whether it is still called or not.
+    TR_FAILED("clBuildProgram()", error);
+    CompleteBuild(build->shared);
+  }
+
+  return true;
+}
+
+cl_kernel ProgramCache_WaitKernel(INOUT ProgramBuild* build) {
+  assert(build != NULL && build->openCl != NULL);
+
+  cl_int error;
+  cl_kernel kernel = NULL;
+  cl_program program = build->program;
+
+  ProgramBuildShared* shared = build->shared;
+  if (shared != NULL) {
+    mtx_lock(&shared->mutex);
+    while (!shared->done) {
+      cnd_wait(&shared->condition, &shared->mutex);
+    }
+    build->endTime = shared->endTime;
+    mtx_unlock(&shared->mutex);
+
+    ReleaseShared(shared);
+    build->shared = NULL;
+  }
+
+  if (build->kernel != NULL) {
+    return build->kernel; // Cache hit, already retained.
+  }
+
+  assert(program != NULL);
+
+  cl_build_status status = CL_BUILD_ERROR;
+  error = clGetProgramBuildInfo(program, build->openCl->device, CL_PROGRAM_BUILD_STATUS, sizeof(status), &status, NULL);
+  if (error != CL_SUCCESS || status != CL_BUILD_SUCCESS) {
+    if (error != CL_SUCCESS) TR_FAILED("clGetProgramBuildInfo(CL_PROGRAM_BUILD_STATUS)", error);
+    OpenClContext_DisplayBuildError(program, build->openCl);
+    goto outProgram;
+  }
+
+  kernel = clCreateKernel(program, build->kernelName, &error);
+  if (error != CL_SUCCESS || kernel == NULL) {
+    TR_FAILED("clCreateKernel()", error);
+    TR_ERROR("Kernel \"%s\" not found with options \"%s\".", build->kernelName, build->options);
+    kernel = NULL;
+    goto outProgram;
+  }
+
+  // One reference for the cache, one for the caller.
+  error = clRetainKernel(kernel);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clRetainKernel()", error);
+    clReleaseKernel(kernel);
+    kernel = NULL;
+    goto outProgram;
+  }
+
+  LockCache();
+  InsertEntry(build, program, kernel);
+  mtx_unlock(&cache.mutex);
+  return kernel;
+
+outProgram:
+  if (CL_SUCCESS != (error = clReleaseProgram(program))) {
+    TR_FAILED("clReleaseProgram()", error);
+  }
+
+  return NULL;
+}
+
+cl_kernel ProgramCache_GetKernel(
+  IN OpenClContext* openCl,
+  IN char const* sourceStart,
+  IN char const* sourceEnd,
+  IN char const* options,
+  IN char const* kernelName)
+{
+  ProgramBuild build;
+  if (!ProgramCache_BuildAsync(openCl, sourceStart, sourceEnd, options, kernelName, &build)) {
+    return NULL;
+  }
+
+  return ProgramCache_WaitKernel(&build);
+}
+
+bool ProgramCache_Release(IN OpenClContext* openCl) {
+  assert(openCl != NULL);
+
+  bool success = true;
+  LockCache();
+  for (size_t index = 0u; index < TR_PROGRAMCACHE_CAPACITY; ++index) {
+    ProgramCacheEntry* entry = &cache.entries[index];
+    if (entry->lastUse != 0u && entry->context == openCl->context) {
+      success = ReleaseEntry(entry) && success;
+    }
+  }
+
+  mtx_unlock(&cache.mutex);
+  return success;
+}
+
+void ProgramCache_Statistics(OUT size_t* hits, OUT size_t* misses) {
+  assert(hits != NULL && misses != NULL);
+  LockCache();
+  *hits = cache.hits;
+  *misses = cache.misses;
+  mtx_unlock(&cache.mutex);
+}
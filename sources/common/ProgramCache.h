@@ -0,0 +1,122 @@
+#ifndef TR_COMMON_PROGRAMCACHE_H
+#define TR_COMMON_PROGRAMCACHE_H
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, INOUT, OUT
+
+/// Maximum number of kernels kept alive by the cache (least recently used are evicted).
+#define TR_PROGRAMCACHE_CAPACITY 16u
+
+/// Maximum length of the build options, which is part of the cache key.
+#define TR_PROGRAMCACHE_OPTIONS_SIZE 512u
+
+/// Maximum length of a kernel name, which is part of the cache key.
+#define TR_PROGRAMCACHE_NAME_SIZE 64u
+
+///
+/// An asynchronous program build, started by `ProgramCache_BuildAsync()` and
+/// completed by `ProgramCache_WaitKernel()`.
+///
+/// The structure may live on the stack of the caller: the state shared with the
+/// OpenCL build callback, which may outlive it, is reference-counted apart.
+///
+typedef struct ProgramBuild {
+  OpenClContext* openCl;
+  char const* source;
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE];
+  char kernelName[TR_PROGRAMCACHE_NAME_SIZE];
+
+  /// Not NULL when the program is being built (cache miss).
+  cl_program program;
+  /// Not NULL when the kernel was found in the cache (cache hit).
+  cl_kernel kernel;
+
+  /// Not NULL while the program is being built, completed by the callback.
+  struct ProgramBuildShared* shared;
+
+  /// Timestamps (see `TimerNow()`) of the build start and completion.
+  double startTime, endTime;
+} ProgramBuild;
+
+///
+/// Starts building the OpenCL program containing the kernel named `kernelName`
+/// without waiting for the compilation to finish (cache hits complete at once).
+///
+/// @returns `true` if the build has been started, `false` otherwise.
+///
+/// @pre Same as `ProgramCache_GetKernel()`.
+/// @pre `build` is not NULL.
+/// @post On success, `ProgramCache_WaitKernel()` must be called on `build`.
+/// @post May display error on stderr.
+///
+bool ProgramCache_BuildAsync(
+  IN OpenClContext* context,
+  IN char const* sourceStart,
+  IN char const* sourceEnd,
+  IN char const* options,
+  IN char const* kernelName,
+  OUT ProgramBuild* build
+);
+
+///
+/// Waits for the build started by `ProgramCache_BuildAsync()`, then creates the
+/// kernel and stores it in the cache.
+///
+/// @returns A retained kernel that must be released with `clReleaseKernel()`,
+///          or `NULL` on failure.
+///
+/// @pre `build` is not NULL and has been started.
+/// @post `build` is released (whatever the result).
+/// @post May display error on stderr (build errors included).
+///
+cl_kernel ProgramCache_WaitKernel(INOUT ProgramBuild* build);
+
+///
+/// Returns a kernel named `kernelName` from the OpenCL program built from the
+/// given source and build options.
+///
+/// Programs and kernels are kept in an in-process LRU cache keyed by the OpenCL
+/// context, the source, the build options and the kernel name, so that
+/// repeated configurations (e.g. the same shapes) only pay for the build once.
+/// A program already built for another kernel of the same key is reused.
+///
+/// The cache is thread-safe, but the returned kernel is shared: threads must
+/// not set its arguments concurrently (see `Submitter_ThreadKernel()`).
+///
+/// @returns A retained kernel that must be released with `clReleaseKernel()`,
+///          or `NULL` on failure.
+///
+/// @pre `context` is not NULL and already initialized.
+/// @pre `sourceStart <= sourceEnd`.
+/// @pre `options` and `kernelName` are not NULL and null-terminated.
+/// @post May display error on stderr (build errors included).
+///
+cl_kernel ProgramCache_GetKernel(
+  IN OpenClContext* context,
+  IN char const* sourceStart,
+  IN char const* sourceEnd,
+  IN char const* options,
+  IN char const* kernelName
+);
+
+///
+/// Releases every cached program and kernel belonging to the given context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `context` is not NULL.
+/// @post May display error on stderr.
+///
+bool ProgramCache_Release(IN OpenClContext* context);
+
+///
+/// Returns the number of cache hits and misses since the beginning of the process.
+///
+void ProgramCache_Statistics(OUT size_t* hits, OUT size_t* misses);
+
+#endif // TR_COMMON_PROGRAMCACHE_H
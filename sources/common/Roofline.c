@@ -0,0 +1,270 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <getopt.h> // getopt_long()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // FILE, fprintf(), printf(), snprintf()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/Roofline.h" // Self
+#include "common/helper.h" // IN, OUT, INOUT, TAB, LF, TR_FAILED()
+
+/// Bytes copied by the bandwidth probe (bounded by the allocation limit),
+/// well beyond the last-level caches.
+#define TR_ROOFLINE_COPY_BYTES (64u << 20u)
+
+/// Work-items per compute unit of the FMA probe.
+#define TR_ROOFLINE_FMA_ITEMS 2048u
+
+/// Flops per work-item of `ProbeFma` (4 chains of 4-wide FMAs).
+#define TR_ROOFLINE_FMA_ITERATIONS 256u
+#define TR_ROOFLINE_FMA_FLOPS (TR_ROOFLINE_FMA_ITERATIONS * 4u * 4u * 2u)
+
+/// Each probe is run this many times, the best time is kept (the first warms up).
+#define TR_ROOFLINE_RUNS 3u
+
+// Define commonProbeStart and commonProbeEnd.
+TR_OPENCL_IMPORT(common, Probe)
+
+///
+/// Enqueues a kernel `TR_ROOFLINE_RUNS` times and returns its best device time.
+///
+/// @returns The time in nanoseconds, or 0 on failure.
+///
+static double BestTime(IN cl_command_queue queue, IN cl_kernel kernel, IN size_t globalSize) {
+  cl_int error;
+  double best = 0.0;
+
+  for (size_t run = 0u; run < TR_ROOFLINE_RUNS; ++run) {
+    cl_event event = NULL;
+    cl_ulong start = 0u, end = 0u;
+    error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &globalSize, NULL, 0, NULL, &event);
+    if (error != CL_SUCCESS) { TR_FAILED("clEnqueueNDRangeKernel(Probe)", error); return 0.0; }
+
+    error  = clWaitForEvents(1, &event);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+    clReleaseEvent(event);
+    if (error != CL_SUCCESS) { TR_FAILED("clGetEventProfilingInfo(Probe)", error); return 0.0; }
+
+    double time = (double) (end - start);
+    if (run > 0u && time > 0.0 && (best == 0.0 || time < best)) {
+      best = time;
+    }
+  }
+
+  return best;
+}
+
+bool Roofline_Measure(IN OpenClContext* this, IN bool doublePrecision, OUT Roofline* roofline) {
+  assert(this != NULL && this->context != NULL && this->queue != NULL);
+  assert(roofline != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_kernel fma = NULL, copy = NULL;
+  cl_mem output = NULL, input = NULL, copied = NULL;
+
+  *roofline = (Roofline) { .doublePrecision = doublePrecision };
+  size_t realSize = doublePrecision ? sizeof(cl_double) : sizeof(cl_float);
+
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE];
+  snprintf(options, sizeof(options), "-DPROBE_ITERATIONS=%u -DPROBE_REAL=%s"
+    , TR_ROOFLINE_FMA_ITERATIONS, doublePrecision ? "double" : "float");
+  fma = ProgramCache_GetKernel(this, commonProbeStart, commonProbeEnd, options, "ProbeFma");
+  copy = ProgramCache_GetKernel(this, commonProbeStart, commonProbeEnd, options, "ProbeCopy");
+  if (fma == NULL || copy == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(Probe) failed");
+    goto out;
+  }
+
+  // ╔═╗╔╦╗╔═╗
+  // ╠╣ ║║║╠═╣
+  // ╚  ╩ ╩╩ ╩
+
+  cl_uint computeUnits = this->capabilities.computeUnits > 0u ? this->capabilities.computeUnits : 1u;
+  size_t fmaItems = (size_t) computeUnits * TR_ROOFLINE_FMA_ITEMS;
+
+  output = clCreateBuffer(this->context, CL_MEM_WRITE_ONLY, realSize * fmaItems, NULL, &error);
+  if (error != CL_SUCCESS || output == NULL) { TR_FAILED("clCreateBuffer(ProbeFma)", error); goto out; }
+
+  cl_float floatSeed = 1.0f;
+  cl_double doubleSeed = 1.0;
+  error  = clSetKernelArg(fma, 0, realSize, doublePrecision ? (void const*) &doubleSeed : (void const*) &floatSeed);
+  error |= clSetKernelArg(fma, 1, sizeof(cl_mem), &output);
+  if (error != CL_SUCCESS) { TR_FAILED("clSetKernelArg(ProbeFma)", error); goto out; }
+
+  double fmaTime = BestTime(this->queue, fma, fmaItems);
+  if (fmaTime <= 0.0) { goto out; }
+  roofline->gflops = (double) fmaItems * TR_ROOFLINE_FMA_FLOPS / fmaTime;
+
+  // ╔╗ ┌─┐┌┐┌┌┬┐┬ ┬┬┌┬┐┌┬┐┬ ┬
+  // ╠╩╗├─┤│││ ││││││ │  │ ├─┤
+  // ╚═╝┴ ┴┘└┘╶┴┘└┴┘┴ ┴  ┴ ┴ ┴
+
+  size_t bytes = TR_ROOFLINE_COPY_BYTES;
+  cl_ulong maxAllocation = this->capabilities.maxAllocationSize;
+  while (maxAllocation != 0u && bytes > maxAllocation && bytes > 4096u) { bytes /= 2u; }
+  size_t copyItems = bytes / (4u * realSize);
+
+  input = clCreateBuffer(this->context, CL_MEM_READ_ONLY, bytes, NULL, &error);
+  if (error != CL_SUCCESS || input == NULL) { TR_FAILED("clCreateBuffer(ProbeCopy, input)", error); goto out; }
+  copied = clCreateBuffer(this->context, CL_MEM_WRITE_ONLY, bytes, NULL, &error);
+  if (error != CL_SUCCESS || copied == NULL) { TR_FAILED("clCreateBuffer(ProbeCopy, output)", error); goto out; }
+
+  error  = clSetKernelArg(copy, 0, sizeof(cl_mem), &input);
+  error |= clSetKernelArg(copy, 1, sizeof(cl_mem), &copied);
+  if (error != CL_SUCCESS) { TR_FAILED("clSetKernelArg(ProbeCopy)", error); goto out; }
+
+  double copyTime = BestTime(this->queue, copy, copyItems);
+  if (copyTime <= 0.0) { goto out; }
+  roofline->bandwidth = 2.0 * (double) bytes / copyTime;
+
+  success = true;
+
+out:
+  if (copied != NULL && CL_SUCCESS != (error = clReleaseMemObject(copied))) { TR_FAILED("clReleaseMemObject(ProbeCopy)", error); }
+  if (input != NULL && CL_SUCCESS != (error = clReleaseMemObject(input))) { TR_FAILED("clReleaseMemObject(ProbeCopy)", error); }
+  if (output != NULL && CL_SUCCESS != (error = clReleaseMemObject(output))) { TR_FAILED("clReleaseMemObject(ProbeFma)", error); }
+  if (copy != NULL) { clReleaseKernel(copy); }
+  if (fma != NULL) { clReleaseKernel(fma); }
+
+  return success;
+}
+
+double Roofline_Ridge(IN Roofline const* roofline) {
+  assert(roofline != NULL);
+  return roofline->bandwidth > 0.0 ? roofline->gflops / roofline->bandwidth : 0.0;
+}
+
+double Roofline_Attainable(IN Roofline const* roofline, IN double intensity) {
+  assert(roofline != NULL);
+  double memoryBound = intensity * roofline->bandwidth;
+  return memoryBound < roofline->gflops ? memoryBound : roofline->gflops;
+}
+
+void Roofline_Display(IN Roofline const* roofline, IN double operations, IN double bytes, IN double nanoseconds) {
+  assert(roofline != NULL);
+
+  double intensity = bytes > 0.0 ? operations / bytes : 0.0;
+  double attainable = Roofline_Attainable(roofline, intensity);
+  double achieved = nanoseconds > 0.0 ? operations / nanoseconds : 0.0;
+
+  printf(
+    TAB1 "Arithmetic.Intensity...: %.3f FLOP/B (ridge point at %.3f FLOP/B)" LF
+    TAB1 "Attainable.............: %.3f GFLOP/s (%s-bound, %.1f GFLOP/s and %.1f GB/s measured)" LF
+    TAB1 "Roofline.Efficiency....: %.1f%%" LF
+    , intensity, Roofline_Ridge(roofline)
+    , attainable, intensity < Roofline_Ridge(roofline) ? "memory" : "compute"
+    , roofline->gflops, roofline->bandwidth
+    , attainable > 0.0 ? 100.0 * achieved / attainable : 0.0
+  );
+}
+
+// ╔═╗┌─┐┌┬┐┌┬┐┌─┐┌┐┌┌┬┐
+// ║  │ ││││││││├─┤│││ ││
+// ╚═╝└─┘┴ ┴┴ ┴┴ ┴┘└┘╶┴┘
+
+void Roofline_ArgumentsUsage(IN FILE* stream, IN char const* command) {
+  assert(stream != NULL);
+  assert(command != NULL);
+
+  fprintf(stream,
+    TAB1 BOLD("%s") LF
+
+    TAB2 "Measures the sustained FMA throughput and global bandwidth of a device in float and" LF
+    TAB2 "double (see also matmul --roofline):" LFLF
+
+    TAB2 BOLD("-d, --device") " GPU | CPU | Default | Fastest | <PlatformIndex>:<DeviceIndex>" LF
+    TAB3 "Specifies which device to use (prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-h, --help") LF
+    TAB3 "Displays this help and quit." LFLF
+
+    , command
+  );
+}
+
+int Roofline_Run(IN int argc, IN char* argv[]) {
+  assert(argc >= 1 && argv[0] != NULL);
+
+  static struct option options[] = {
+    { "device", required_argument, NULL, 'd' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 },
+  };
+
+  int option;
+  char const* device = "Default";
+
+  opterr = 1; // Prints error on stderr.
+  while (0 <= (option = getopt_long(argc, argv, "d:h", options, NULL))) {
+    switch (option) {
+      case 'd': device = optarg; break;
+      case 'h':
+        Roofline_ArgumentsUsage(stdout, argv[0]);
+        return 2;
+      default:
+        return 0;
+    }
+  }
+
+  OpenClContext openCl;
+  if (OpenClContext_FromString(device, &openCl) != 1) {
+    fprintf(stderr, LF "The device cannot be opened:" LF TAB1 "--device %s" LFLF, device);
+    return 0;
+  }
+
+  int result = 0;
+  char name[128] = { 0x0 };
+  cl_int error = clGetDeviceInfo(openCl.device, CL_DEVICE_NAME, sizeof(name) - 1u, name, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetDeviceInfo(CL_DEVICE_NAME)", error);
+    goto out;
+  }
+
+  bool fp64 = OpenClContext_EnableDoublePrecision(&openCl);
+  printf(TAB0 "Roofline of %s:" LF, name);
+
+  for (size_t precision = 0u; precision < 2u; ++precision) {
+    bool doublePrecision = precision == 1u;
+    char const* type = doublePrecision ? "double" : "float";
+    if (doublePrecision && !fp64) {
+      printf(LF TAB1 "%s:" LF TAB2 "Skipped (no double-precision)" LF, type);
+      continue;
+    }
+
+    Roofline roofline;
+    if (!Roofline_Measure(&openCl, doublePrecision, &roofline)) {
+      TR_ERROR("Roofline_Measure(%s) failed", type);
+      goto out;
+    }
+
+    // A square product moves 3 N^2 elements for 2 N^3 flops (at best), thus
+    // reaches the ridge point from N = 1.5 * sizeof(Real) * ridge.
+    double ridge = Roofline_Ridge(&roofline);
+    double realSize = doublePrecision ? sizeof(cl_double) : sizeof(cl_float);
+
+    printf(
+      LF TAB1 "%s:" LF
+      TAB2 "Peak.Compute.........: %.3f GFLOP/s (FMA chains)" LF
+      TAB2 "Peak.Bandwidth.......: %.3f GB/s (streaming copy)" LF
+      TAB2 "Ridge.Point..........: %.3f FLOP/B" LF
+      TAB2 "MatMul.Compute.Bound.: N >= %.0f (square, compulsory traffic)" LF
+      , type, roofline.gflops, roofline.bandwidth, ridge, 1.5 * realSize * ridge
+    );
+  }
+
+  printf(LF);
+  result = 1;
+
+out:
+  if (!OpenClContext_Release(&openCl)) {
+    TR_ERROR("OpenClContext_Release() failed");
+  }
+
+  return result;
+}
@@ -0,0 +1,71 @@
+#ifndef TR_COMMON_ROOFLINE_H
+#define TR_COMMON_ROOFLINE_H
+
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // FILE
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, INOUT, OUT
+
+///
+/// The ceilings of a device in a precision, measured by the probe kernels (see
+/// `common/Probe.cl`): sustained FMA throughput and global memory bandwidth.
+///
+typedef struct Roofline {
+  bool doublePrecision;
+
+  /// FMA throughput (GFLOP/s) and copy bandwidth (GB/s).
+  double gflops, bandwidth;
+} Roofline;
+
+///
+/// Runs the FMA-chain and streaming-copy probe kernels in the given precision
+/// on the device of the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `context` is not NULL and already initialized (with double-precision
+///      enabled for `doublePrecision`).
+/// @post May display error on stderr.
+///
+bool Roofline_Measure(IN OpenClContext* context, IN bool doublePrecision, OUT Roofline* roofline);
+
+///
+/// Returns the arithmetic intensity (FLOP/B) from which a kernel is bound by
+/// the FMA throughput rather than by the bandwidth.
+///
+double Roofline_Ridge(IN Roofline const* roofline);
+
+///
+/// Returns the attainable performance (GFLOP/s) of a kernel with the given
+/// arithmetic intensity (FLOP/B), `min(gflops, intensity * bandwidth)`.
+///
+double Roofline_Attainable(IN Roofline const* roofline, IN double intensity);
+
+///
+/// Displays the arithmetic intensity, attainable performance and percent of
+/// roofline of a kernel of `operations` flops moving at least `bytes` bytes
+/// in `nanoseconds`.
+///
+/// @post Display content on stdout.
+///
+void Roofline_Display(IN Roofline const* roofline, IN double operations, IN double bytes, IN double nanoseconds);
+
+///
+/// Displays the usage of the `roofline` command.
+///
+/// @pre `stream` and `command` are not NULL.
+///
+void Roofline_ArgumentsUsage(IN FILE* stream, IN char const* command);
+
+///
+/// Measures and displays the ceilings of a device in single- and
+/// double-precision (the `roofline` command).
+///
+/// @returns `0` on failure, `1` on success, `2` for `--help`.
+///
+/// @post Display content on stdout, may display error on stderr.
+///
+int Roofline_Run(IN int argc, IN char* argv[]);
+
+#endif // TR_COMMON_ROOFLINE_H
@@ -0,0 +1,469 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <stdatomic.h> // atomic_*()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // fprintf(), stderr
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // memcpy(), memcmp()
+#include <threads.h> // thrd_*(), mtx_*(), cnd_*(), tss_*()
+#include <time.h> // timespec_get()
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/Submitter.h" // Self
+#include "common/helper.h" // IN, INOUT, OUT, TR_FAILED()
+
+/// Longest sleep of the submission thread, bounding a missed wake-up.
+#define TR_SUBMIT_SLEEP_NANOSECONDS 1000000l
+
+///
+/// The jobs of a batch, completed together by the callback of its marker.
+///
+typedef struct SubmitBatch {
+  size_t count;
+  SubmitJob* jobs[TR_SUBMIT_MAX_BATCH];
+} SubmitBatch;
+
+///
+/// The kernel clones of a thread, `prototypes[i]` being cloned as `clones[i]`.
+///
+/// The prototypes are retained while cached: the cache being keyed by their
+/// address, a prototype released by `ProgramCache` must not be reused by
+/// another kernel and then be mistaken for it.
+///
+typedef struct ThreadKernels {
+  size_t count;
+  cl_kernel prototypes[TR_SUBMIT_THREAD_KERNELS];
+  cl_kernel clones[TR_SUBMIT_THREAD_KERNELS];
+} ThreadKernels;
+
+static tss_t threadKernels;
+static once_flag threadKernelsOnce = ONCE_FLAG_INIT;
+
+// ╔╦╗┬ ┬┬─┐┌─┐┌─┐┌┬┐  ╦╔═┌─┐┬─┐┌┐┌┌─┐┬  ┌─┐
+//  ║ ├─┤├┬┘├┤ ├─┤ ││  ╠╩╗├┤ ├┬┘│││├┤ │  └─┐
+//  ╩ ┴ ┴┴└─└─┘┴ ┴╶┴┘  ╩ ╩└─┘┴└─┘└┘└─┘┴─┘└─┘
+
+///
+/// Releases the clones of a thread, and their prototypes, when it exits.
+///
+static void ReleaseThreadKernels(IN void* data) {
+  ThreadKernels* kernels = (ThreadKernels*) data;
+  for (size_t index = 0u; index < kernels->count; ++index) {
+    clReleaseKernel(kernels->clones[index]);
+    clReleaseKernel(kernels->prototypes[index]);
+  }
+
+  free(kernels);
+}
+
+static void InitializeThreadKernels(void) {
+  if (tss_create(&threadKernels, ReleaseThreadKernels) != thrd_success) {
+    TR_ERROR("tss_create() failed");
+  }
+}
+
+cl_kernel Submitter_ThreadKernel(IN cl_kernel prototype) {
+  assert(prototype != NULL);
+
+  call_once(&threadKernelsOnce, InitializeThreadKernels);
+
+  ThreadKernels* kernels = (ThreadKernels*) tss_get(threadKernels);
+  if (kernels == NULL) {
+    kernels = (ThreadKernels*) calloc(1u, sizeof(ThreadKernels));
+    if (kernels == NULL || tss_set(threadKernels, kernels) != thrd_success) {
+      TR_ERROR("tss_set() failed");
+      free(kernels);
+      return NULL;
+    }
+  }
+
+  for (size_t index = 0u; index < kernels->count; ++index) {
+    if (kernels->prototypes[index] == prototype) {
+      return kernels->clones[index];
+    }
+  }
+
+  // The oldest clone makes room for the new one.
+  if (kernels->count == TR_SUBMIT_THREAD_KERNELS) {
+    clReleaseKernel(kernels->clones[0]);
+    clReleaseKernel(kernels->prototypes[0]);
+    memmove(kernels->prototypes, kernels->prototypes + 1, sizeof(cl_kernel) * (TR_SUBMIT_THREAD_KERNELS - 1u));
+    memmove(kernels->clones, kernels->clones + 1, sizeof(cl_kernel) * (TR_SUBMIT_THREAD_KERNELS - 1u));
+    kernels->count -= 1u;
+  }
+
+  cl_int error;
+  cl_kernel clone = clCloneKernel(prototype, &error); // OpenCL 2.1
+  if (error != CL_SUCCESS || clone == NULL) {
+    TR_FAILED("clCloneKernel()", error);
+    return NULL;
+  }
+
+  error = clRetainKernel(prototype);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clRetainKernel()", error);
+    clReleaseKernel(clone);
+    return NULL;
+  }
+
+  kernels->prototypes[kernels->count] = prototype;
+  kernels->clones[kernels->count] = clone;
+  kernels->count += 1u;
+  return clone;
+}
+
+// ╦┌─┐┌┐ ┌─┐
+// ║│ │├┴┐└─┐
+// ╚╝└─┘└─┘└─┘
+
+bool SubmitJob_Init(
+  OUT SubmitJob* this, IN cl_kernel kernel, IN cl_uint dimensions,
+  IN size_t const* globalSize, IN size_t const* localSize)
+{
+  assert(this != NULL && kernel != NULL && globalSize != NULL);
+  assert(dimensions >= 1u && dimensions <= 3u);
+
+  *this = (SubmitJob) { .kernel = kernel, .dimensions = dimensions, .hasLocalSize = localSize != NULL };
+  atomic_init(&this->next, NULL);
+
+  for (cl_uint index = 0u; index < dimensions; ++index) {
+    this->globalSize[index] = globalSize[index];
+    this->localSize[index] = localSize != NULL ? localSize[index] : 0u;
+  }
+
+  if (mtx_init(&this->mutex, mtx_plain) != thrd_success) {
+    TR_ERROR("mtx_init() failed");
+    return false;
+  }
+
+  if (cnd_init(&this->condition) != thrd_success) {
+    TR_ERROR("cnd_init() failed");
+    mtx_destroy(&this->mutex);
+    return false;
+  }
+
+  return true;
+}
+
+bool SubmitJob_SetArgument(INOUT SubmitJob* this, IN cl_uint index, IN size_t size, IN void const* value) {
+  assert(this != NULL);
+
+  if (index >= TR_SUBMIT_MAX_ARGUMENTS || (value != NULL && size > TR_SUBMIT_ARGUMENT_SIZE)) {
+    TR_ERROR("The argument %u (%zu bytes) cannot be kept by a job.", index, size);
+    return false;
+  }
+
+  SubmitArgument* argument = &this->arguments[index];
+  *argument = (SubmitArgument) { .size = size, .local = value == NULL };
+  if (value != NULL) {
+    memcpy(argument->value, value, size);
+  }
+
+  this->argumentCount = index + 1u > this->argumentCount ? index + 1u : this->argumentCount;
+  return true;
+}
+
+///
+/// Completes a job: its callback first, then its waiters.
+///
+static void CompleteJob(INOUT SubmitJob* job, IN cl_int status, IN size_t batchSize) {
+  job->batchSize = batchSize;
+  if (job->callback != NULL) {
+    job->callback(job, job->callbackData);
+  }
+
+  mtx_lock(&job->mutex);
+  job->status = status;
+  job->done = true;
+  cnd_broadcast(&job->condition);
+  mtx_unlock(&job->mutex);
+}
+
+cl_int SubmitJob_Wait(INOUT SubmitJob* this) {
+  assert(this != NULL);
+
+  mtx_lock(&this->mutex);
+  while (!this->done) {
+    cnd_wait(&this->condition, &this->mutex);
+  }
+  cl_int status = this->status;
+  mtx_unlock(&this->mutex);
+
+  cnd_destroy(&this->condition);
+  mtx_destroy(&this->mutex);
+  return status;
+}
+
+// ╔═╗ ┬ ┬┌─┐┬ ┬┌─┐
+// ║═╬╗│ │├┤ │ │├┤
+// ╚═╝╚└─┘└─┘└─┘└─┘
+
+///
+/// Pushes a job on the producers' end (wait-free).
+///
+static void Push(INOUT Submitter* this, INOUT SubmitJob* job) {
+  atomic_store_explicit(&job->next, NULL, memory_order_relaxed);
+  SubmitJob* previous = atomic_exchange_explicit(&this->head, job, memory_order_acq_rel);
+  atomic_store_explicit(&previous->next, job, memory_order_release);
+}
+
+///
+/// Pops a job from the consumer's end (submission thread only).
+///
+/// @returns The oldest job, or NULL if empty (or if a producer is between
+///          its exchange and its link, then the job comes with the next pop).
+///
+static SubmitJob* Pop(INOUT Submitter* this) {
+  SubmitJob* tail = this->tail;
+  SubmitJob* next = atomic_load_explicit(&tail->next, memory_order_acquire);
+
+  if (tail == &this->stub) {
+    if (next == NULL) { return NULL; }
+    this->tail = tail = next;
+    next = atomic_load_explicit(&next->next, memory_order_acquire);
+  }
+
+  if (next != NULL) {
+    this->tail = next;
+    return tail;
+  }
+
+  if (tail != atomic_load_explicit(&this->head, memory_order_acquire)) {
+    return NULL;
+  }
+
+  // The last job is only popped once the stub is behind it.
+  Push(this, &this->stub);
+  next = atomic_load_explicit(&tail->next, memory_order_acquire);
+  if (next != NULL) {
+    this->tail = next;
+    return tail;
+  }
+
+  return NULL;
+}
+
+void Submitter_Submit(INOUT Submitter* this, INOUT SubmitJob* job) {
+  assert(this != NULL && job != NULL && job->kernel != NULL);
+
+  atomic_fetch_add_explicit(&this->jobs, 1u, memory_order_relaxed);
+  Push(this, job);
+
+  // Only a sleeping submission thread needs the lock.
+  if (atomic_load_explicit(&this->sleeping, memory_order_acquire)) {
+    mtx_lock(&this->mutex);
+    cnd_signal(&this->condition);
+    mtx_unlock(&this->mutex);
+  }
+}
+
+// ╔═╗┬ ┬┌┐ ┌┬┐┬┌─┐┌─┐┬┌─┐┌┐┌
+// ╚═╗│ │├┴┐│││││└─┐└─┐││ ││││
+// ╚═╝└─┘└─┘┴ ┴┴└─┘└─┘┴└─┘┘└┘
+
+///
+/// Called by the OpenCL runtime once every job of the batch is complete.
+///
+static void CL_CALLBACK OnBatchComplete(IN cl_event event, IN cl_int status, IN void* data) {
+  SubmitBatch* batch = (SubmitBatch*) data;
+  for (size_t index = 0u; index < batch->count; ++index) {
+    CompleteJob(batch->jobs[index], status, batch->count);
+  }
+
+  clReleaseEvent(event);
+  free(batch);
+}
+
+///
+/// Whether two jobs can be coalesced (same kernel and launch shape).
+///
+static bool SameShape(IN SubmitJob const* a, IN SubmitJob const* b) {
+  return a->kernel == b->kernel && a->dimensions == b->dimensions && a->hasLocalSize == b->hasLocalSize
+    && memcmp(a->globalSize, b->globalSize, sizeof(a->globalSize)) == 0
+    && memcmp(a->localSize, b->localSize, sizeof(a->localSize)) == 0;
+}
+
+///
+/// Sets the arguments of a job on the clone of the submission thread, then
+/// enqueues it.
+///
+static cl_int EnqueueJob(IN cl_command_queue queue, IN SubmitJob const* job) {
+  cl_kernel kernel = Submitter_ThreadKernel(job->kernel);
+  if (kernel == NULL) {
+    return CL_INVALID_KERNEL;
+  }
+
+  cl_int error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < job->argumentCount && error == CL_SUCCESS; ++index) {
+    SubmitArgument const* argument = &job->arguments[index];
+    error = clSetKernelArg(kernel, index, argument->size, argument->local ? NULL : argument->value);
+  }
+
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Submitter)", error);
+    return error;
+  }
+
+  error = clEnqueueNDRangeKernel(queue, kernel, job->dimensions, NULL,
+    job->globalSize, job->hasLocalSize ? job->localSize : NULL, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(Submitter)", error);
+  }
+
+  return error;
+}
+
+///
+/// Launches the same-shaped jobs of `jobs` together, one batch per shape.
+///
+static void LaunchJobs(INOUT Submitter* this, INOUT SubmitJob** jobs, IN size_t count) {
+  bool taken[TR_SUBMIT_MAX_BATCH] = { false };
+
+  for (size_t first = 0u; first < count; ++first) {
+    if (taken[first]) { continue; }
+
+    SubmitBatch* batch = (SubmitBatch*) malloc(sizeof(SubmitBatch));
+    if (batch == NULL) {
+      TR_ERROR("malloc(SubmitBatch) failed");
+      CompleteJob(jobs[first], CL_OUT_OF_HOST_MEMORY, 1u);
+      continue;
+    }
+
+    cl_command_queue queue = this->openCl->streams[this->nextStream];
+    this->nextStream = (this->nextStream + 1u) % this->openCl->streamCount;
+    batch->count = 0u;
+
+    for (size_t index = first; index < count; ++index) {
+      if (taken[index] || !SameShape(jobs[first], jobs[index])) { continue; }
+      taken[index] = true;
+
+      cl_int error = EnqueueJob(queue, jobs[index]);
+      if (error != CL_SUCCESS) {
+        CompleteJob(jobs[index], error, 1u);
+        continue;
+      }
+
+      batch->jobs[batch->count++] = jobs[index];
+    }
+
+    // One marker, flush and callback for the whole batch (in-order queue).
+    cl_event marker = NULL;
+    cl_int error = batch->count == 0u ? CL_SUCCESS : clEnqueueMarkerWithWaitList(queue, 0u, NULL, &marker);
+    if (error == CL_SUCCESS && marker != NULL) { error = clFlush(queue); }
+    if (error == CL_SUCCESS && marker != NULL) { error = clSetEventCallback(marker, CL_COMPLETE, OnBatchComplete, batch); }
+
+    if (batch->count == 0u || error != CL_SUCCESS) {
+      if (error != CL_SUCCESS) { TR_FAILED("clEnqueueMarkerWithWaitList(Submitter)", error); }
+      if (marker != NULL) { clWaitForEvents(1, &marker); clReleaseEvent(marker); }
+      for (size_t index = 0u; index < batch->count; ++index) {
+        CompleteJob(batch->jobs[index], error, batch->count);
+      }
+
+      free(batch);
+      continue;
+    }
+
+    atomic_fetch_add_explicit(&this->batches, 1u, memory_order_relaxed);
+  }
+}
+
+///
+/// The submission thread: takes every queued job, launches them by batches,
+/// and sleeps when there is nothing to launch.
+///
+static int SubmissionThread(IN void* data) {
+  Submitter* this = (Submitter*) data;
+  SubmitJob* jobs[TR_SUBMIT_MAX_BATCH];
+
+  for (;;) {
+    size_t count = 0u;
+    while (count < TR_SUBMIT_MAX_BATCH && (jobs[count] = Pop(this)) != NULL) {
+      count += 1u;
+    }
+
+    if (count > 0u) {
+      LaunchJobs(this, jobs, count);
+      continue;
+    }
+
+    if (atomic_load_explicit(&this->stopping, memory_order_acquire)) {
+      // A last look, in case of a push racing with the stop.
+      if ((jobs[0] = Pop(this)) == NULL) { break; }
+      LaunchJobs(this, jobs, 1u);
+      continue;
+    }
+
+    // The timeout bounds a wake-up missed between the check and the wait.
+    mtx_lock(&this->mutex);
+    atomic_store_explicit(&this->sleeping, true, memory_order_release);
+    struct timespec until;
+    timespec_get(&until, TIME_UTC);
+    until.tv_nsec += TR_SUBMIT_SLEEP_NANOSECONDS;
+    if (until.tv_nsec >= 1000000000l) { until.tv_sec += 1; until.tv_nsec -= 1000000000l; }
+    cnd_timedwait(&this->condition, &this->mutex, &until);
+    atomic_store_explicit(&this->sleeping, false, memory_order_release);
+    mtx_unlock(&this->mutex);
+  }
+
+  // Completes the callbacks before the submitter goes away.
+  for (size_t stream = 0u; stream < this->openCl->streamCount; ++stream) {
+    clFinish(this->openCl->streams[stream]);
+  }
+
+  return 0;
+}
+
+bool Submitter_Start(IN OpenClContext* openCl, OUT Submitter* this) {
+  assert(openCl != NULL && openCl->context != NULL && openCl->streamCount >= 1u);
+  assert(this != NULL);
+
+  *this = (Submitter) { .openCl = openCl };
+  atomic_init(&this->stub.next, NULL);
+  atomic_init(&this->head, &this->stub);
+  this->tail = &this->stub;
+  atomic_init(&this->sleeping, false);
+  atomic_init(&this->stopping, false);
+  atomic_init(&this->jobs, 0u);
+  atomic_init(&this->batches, 0u);
+
+  if (mtx_init(&this->mutex, mtx_plain) != thrd_success) {
+    TR_ERROR("mtx_init() failed");
+    return false;
+  }
+
+  if (cnd_init(&this->condition) != thrd_success) {
+    TR_ERROR("cnd_init() failed");
+    mtx_destroy(&this->mutex);
+    return false;
+  }
+
+  if (thrd_create(&this->thread, SubmissionThread, this) != thrd_success) {
+    TR_ERROR("thrd_create(Submitter) failed");
+    cnd_destroy(&this->condition);
+    mtx_destroy(&this->mutex);
+    return false;
+  }
+
+  return true;
+}
+
+bool Submitter_Stop(INOUT Submitter* this) {
+  assert(this != NULL);
+
+  atomic_store_explicit(&this->stopping, true, memory_order_release);
+  mtx_lock(&this->mutex);
+  cnd_signal(&this->condition);
+  mtx_unlock(&this->mutex);
+
+  int result = 0;
+  bool success = thrd_join(this->thread, &result) == thrd_success;
+  if (!success) {
+    TR_ERROR("thrd_join(Submitter) failed");
+  }
+
+  cnd_destroy(&this->condition);
+  mtx_destroy(&this->mutex);
+  return success;
+}
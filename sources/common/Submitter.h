@@ -0,0 +1,177 @@
+#ifndef TR_COMMON_SUBMITTER_H
+#define TR_COMMON_SUBMITTER_H
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdatomic.h> // _Atomic, atomic_bool, atomic_size_t
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <threads.h> // thrd_t, mtx_t, cnd_t
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, INOUT, OUT
+
+/// Maximum number of arguments of a job, and size of an argument kept by value.
+#define TR_SUBMIT_MAX_ARGUMENTS 16u
+#define TR_SUBMIT_ARGUMENT_SIZE 16u
+
+/// Maximum number of jobs taken from the queue at once (thus coalesced).
+#define TR_SUBMIT_MAX_BATCH 64u
+
+/// Maximum number of kernel clones kept per thread (see `Submitter_ThreadKernel()`).
+#define TR_SUBMIT_THREAD_KERNELS 8u
+
+struct SubmitJob;
+
+///
+/// Called by the OpenCL runtime thread once the job is complete (before its
+/// waiters are woken up), it must not block.
+///
+typedef void (*SubmitCallback)(INOUT struct SubmitJob* job, INOUT void* data);
+
+///
+/// A kernel argument kept by value, `local` being a `__local` buffer of `size` bytes.
+///
+typedef struct SubmitArgument {
+  size_t size;
+  bool local;
+  unsigned char value[TR_SUBMIT_ARGUMENT_SIZE];
+} SubmitArgument;
+
+///
+/// A kernel launch submitted from any thread, with its completion future.
+///
+/// The arguments are copied into the job, thus the kernel itself is never
+/// modified, and the job must stay alive until `SubmitJob_Wait()` returns.
+/// Jobs are independent: a job depending on another one must be submitted
+/// once the latter is complete.
+///
+typedef struct SubmitJob {
+  /// Link of the lock-free queue (owned by the submitter once submitted).
+  _Atomic(struct SubmitJob*) next;
+
+  cl_kernel kernel;
+  cl_uint dimensions;
+  size_t globalSize[3], localSize[3];
+  bool hasLocalSize;
+
+  SubmitArgument arguments[TR_SUBMIT_MAX_ARGUMENTS];
+  cl_uint argumentCount;
+
+  SubmitCallback callback;
+  void* callbackData;
+
+  /// The future: `status` is `CL_COMPLETE` (0) on success, negative otherwise.
+  mtx_t mutex;
+  cnd_t condition;
+  bool done;
+  cl_int status;
+
+  /// Number of jobs of the launch this job was coalesced into.
+  size_t batchSize;
+} SubmitJob;
+
+///
+/// A thread-safe front-end to a device: any thread submits jobs to a lock-free
+/// multi-producer single-consumer queue, emptied by a dedicated submission
+/// thread, the only one enqueuing OpenCL commands.
+///
+/// Same-shaped jobs (same kernel, sizes and dimensions) taken together are
+/// coalesced: enqueued back-to-back on one stream, with a single flush and a
+/// single completion event for the whole batch.
+///
+typedef struct Submitter {
+  OpenClContext* openCl;
+
+  /// Vyukov's intrusive MPSC queue, `head` being the producers' end.
+  _Atomic(SubmitJob*) head;
+  SubmitJob* tail;
+  SubmitJob stub;
+
+  /// The submission thread sleeps (with a timeout) when the queue is empty.
+  thrd_t thread;
+  mtx_t mutex;
+  cnd_t condition;
+  atomic_bool sleeping;
+  atomic_bool stopping;
+
+  /// Round-robin over the streams of the context, one batch each.
+  size_t nextStream;
+
+  /// Counters since the start (jobs submitted, batches launched).
+  atomic_size_t jobs, batches;
+} Submitter;
+
+///
+/// Starts the submission thread of the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `context` is not NULL and initialized, `submitter` is not NULL.
+/// @post `submitter` must be stopped with `Submitter_Stop()`, and must not move.
+/// @post May display error on stderr.
+///
+bool Submitter_Start(IN OpenClContext* context, OUT Submitter* submitter);
+
+///
+/// Launches the jobs still queued, waits for their completion, then stops the
+/// submission thread.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre No job is submitted concurrently.
+/// @post May display error on stderr.
+///
+bool Submitter_Stop(INOUT Submitter* submitter);
+
+///
+/// Initializes a job launching `kernel` on `dimensions` dimensions, `localSize`
+/// being optional (NULL lets the implementation pick it).
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `job`, `kernel` and `globalSize` are not NULL, `1 <= dimensions <= 3`.
+/// @post `job` must be submitted, then waited with `SubmitJob_Wait()`.
+///
+bool SubmitJob_Init(
+  OUT SubmitJob* job, IN cl_kernel kernel, IN cl_uint dimensions,
+  IN size_t const* globalSize, IN size_t const* localSize
+);
+
+///
+/// Copies the argument `index` of the job, `value` being NULL for a `__local`
+/// buffer of `size` bytes.
+///
+/// @returns `true` on success, `false` if the index or the size is too large.
+///
+bool SubmitJob_SetArgument(INOUT SubmitJob* job, IN cl_uint index, IN size_t size, IN void const* value);
+
+///
+/// Submits the job (lock-free, from any thread).
+///
+/// @pre `job` is initialized and its arguments are set.
+///
+void Submitter_Submit(INOUT Submitter* submitter, INOUT SubmitJob* job);
+
+///
+/// Waits for the completion of a job, then releases its future.
+///
+/// @returns `CL_COMPLETE` (0) on success, the OpenCL error otherwise.
+///
+cl_int SubmitJob_Wait(INOUT SubmitJob* job);
+
+///
+/// Returns a clone of `prototype` owned by the calling thread, so that its
+/// arguments can be set without racing with other threads (kernels are not
+/// thread-safe for `clSetKernelArg()`, e.g. when shared by the program cache).
+///
+/// The clones are cached per thread, keyed by their prototype which they keep
+/// retained, and released (with it) when the thread exits.
+///
+/// @returns The clone (not retained for the caller), or NULL on failure.
+///
+/// @post May display error on stderr.
+///
+cl_kernel Submitter_ThreadKernel(IN cl_kernel prototype);
+
+#endif // TR_COMMON_SUBMITTER_H
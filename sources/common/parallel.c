@@ -0,0 +1,73 @@
+// sysconf() is POSIX, not ISO C (see `man feature_test_macros`).
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h> // assert()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // fprintf(), stderr
+#include <threads.h> // thrd_create(), thrd_join()
+#include <unistd.h> // sysconf()
+
+#include "common/helper.h" // IN, INOUT, TR_ERROR()
+#include "common/parallel.h" // Self
+
+typedef struct ParallelChunk {
+  size_t begin, end;
+  ParallelBody body;
+  void* data;
+} ParallelChunk;
+
+static int RunChunk(IN void* argument) {
+  ParallelChunk* chunk = (ParallelChunk*) argument;
+  chunk->body(chunk->begin, chunk->end, chunk->data);
+  return 0;
+}
+
+size_t ParallelThreadCount(void) {
+  long count = sysconf(_SC_NPROCESSORS_ONLN);
+  if (count < 1) return 1u;
+  if ((unsigned long) count > TR_PARALLEL_MAX_THREADS) return TR_PARALLEL_MAX_THREADS;
+  return (size_t) count;
+}
+
+bool ParallelFor(IN size_t count, IN ParallelBody body, INOUT void* data) {
+  assert(body != NULL);
+
+  size_t threadCount = ParallelThreadCount();
+  if (threadCount > count) threadCount = count;
+  if (threadCount <= 1u) {
+    if (count > 0u) body(0u, count, data);
+    return true;
+  }
+
+  bool success = true;
+  thrd_t threads[TR_PARALLEL_MAX_THREADS];
+  bool started[TR_PARALLEL_MAX_THREADS] = { false };
+  ParallelChunk chunks[TR_PARALLEL_MAX_THREADS];
+
+  for (size_t index = 0u; index < threadCount; ++index) {
+    chunks[index] = (ParallelChunk) {
+      .begin = count * index / threadCount,
+      .end = count * (index + 1u) / threadCount,
+      .body = body,
+      .data = data,
+    };
+  }
+
+  for (size_t index = 0u; index + 1u < threadCount; ++index) {
+    started[index] = thrd_create(&threads[index], RunChunk, &chunks[index]) == thrd_success;
+    if (!started[index]) {
+      TR_ERROR("thrd_create() failed, chunk %zu runs on the calling thread.", index);
+      success = false;
+    }
+  }
+
+  RunChunk(&chunks[threadCount - 1u]);
+
+  for (size_t index = 0u; index + 1u < threadCount; ++index) {
+    if (started[index]) thrd_join(threads[index], NULL);
+    else RunChunk(&chunks[index]);
+  }
+
+  return success;
+}
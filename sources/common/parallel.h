@@ -0,0 +1,34 @@
+#ifndef TR_COMMON_PARALLEL_H
+#define TR_COMMON_PARALLEL_H
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/helper.h" // IN, INOUT
+
+/// Maximum number of host threads used by `ParallelFor()`.
+#define TR_PARALLEL_MAX_THREADS 64u
+
+///
+/// Processes the items `[begin, end)`, `data` being the one given to `ParallelFor()`.
+///
+typedef void (*ParallelBody)(IN size_t begin, IN size_t end, INOUT void* data);
+
+///
+/// Returns the number of online processors (at least 1, at most `TR_PARALLEL_MAX_THREADS`).
+///
+size_t ParallelThreadCount(void);
+
+///
+/// Splits `[0, count)` into contiguous chunks processed concurrently by one
+/// host thread each (the calling thread takes the last chunk).
+///
+/// @returns `true` on success, `false` if a thread could not be created (the
+///          whole range is processed anyway, possibly with less threads).
+///
+/// @pre `body` is not NULL.
+/// @post `body` has been called for every item exactly once.
+///
+bool ParallelFor(IN size_t count, IN ParallelBody body, INOUT void* data);
+
+#endif // TR_COMMON_PARALLEL_H
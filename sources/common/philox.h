@@ -0,0 +1,76 @@
+#ifndef TR_COMMON_PHILOX_H
+#define TR_COMMON_PHILOX_H
+
+#include <stdint.h> // uint32_t, uint64_t
+
+#include "common/helper.h" // IN, INOUT
+
+///
+/// Philox4x32-10 counter-based random number generator (Salmon et al., "Parallel
+/// Random Numbers: As Easy as 1, 2, 3", SC'11).
+///
+/// Each `(counter, key)` pair gives four independent 32-bit random numbers, so
+/// any element can be generated on its own, in any order and on any device.
+///
+/// IMPORTANT: `matrix/Random.cl` implements the exact same functions in OpenCL C,
+/// both must be kept bit-identical.
+///
+
+#define TR_PHILOX_M0 0xD2511F53u
+#define TR_PHILOX_M1 0xCD9E8D57u
+#define TR_PHILOX_W0 0x9E3779B9u
+#define TR_PHILOX_W1 0xBB67AE85u
+#define TR_PHILOX_ROUNDS 10
+
+///
+/// Scrambles the given counter in place with the given key.
+///
+static inline void Philox4x32(INOUT uint32_t counter[4], IN uint32_t const key[2]) {
+  uint32_t k0 = key[0], k1 = key[1];
+
+  for (int round = 0; round < TR_PHILOX_ROUNDS; ++round) {
+    uint64_t product0 = (uint64_t) TR_PHILOX_M0 * counter[0];
+    uint64_t product1 = (uint64_t) TR_PHILOX_M1 * counter[2];
+
+    uint32_t c0 = (uint32_t) (product1 >> 32) ^ counter[1] ^ k0;
+    uint32_t c1 = (uint32_t) product1;
+    uint32_t c2 = (uint32_t) (product0 >> 32) ^ counter[3] ^ k1;
+    uint32_t c3 = (uint32_t) product0;
+
+    counter[0] = c0; counter[1] = c1; counter[2] = c2; counter[3] = c3;
+    k0 += TR_PHILOX_W0; k1 += TR_PHILOX_W1;
+  }
+}
+
+///
+/// Converts 24 random bits into a float in [-1, 1) (exactly, no rounding involved).
+///
+static inline float PhiloxToFloat(IN uint32_t x) {
+  return (float) (x >> 8) * 0x1.0p-23f - 1.0f;
+}
+
+///
+/// Converts 53 random bits into a double in [-1, 1) (exactly, no rounding involved).
+///
+static inline double PhiloxToDouble(IN uint32_t high, IN uint32_t low) {
+  uint64_t bits = ((uint64_t) high << 21) ^ (uint64_t) (low >> 11);
+  return (double) bits * 0x1.0p-52 - 1.0;
+}
+
+///
+/// Returns the random value of the element `(row, column)` of the matrix
+/// identified by `stream` (e.g. 0 for A, 1 for B) for the given `seed`.
+///
+static inline uint32_t PhiloxElement(
+  IN uint64_t seed, IN uint32_t stream,
+  IN uint32_t row, IN uint32_t column,
+  OUT uint32_t* second)
+{
+  uint32_t counter[4] = { column, row, stream, 0u };
+  uint32_t key[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+  Philox4x32(counter, key);
+  *second = counter[1];
+  return counter[0];
+}
+
+#endif // TR_COMMON_PHILOX_H
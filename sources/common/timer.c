@@ -0,0 +1,12 @@
+// clock_gettime() and CLOCK_MONOTONIC are POSIX, not ISO C (see `man feature_test_macros`).
+#define _POSIX_C_SOURCE 200809L
+
+#include <time.h> // clock_gettime(), CLOCK_MONOTONIC
+
+#include "common/timer.h" // Self
+
+double TimerNow(void) {
+  struct timespec now = { 0 };
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
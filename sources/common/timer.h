@@ -0,0 +1,11 @@
+#ifndef TR_COMMON_TIMER_H
+#define TR_COMMON_TIMER_H
+
+///
+/// Returns the current time of a monotonic clock, in seconds.
+///
+/// Only differences between two calls are meaningful.
+///
+double TimerNow(void);
+
+#endif // TR_COMMON_TIMER_H
@@ -0,0 +1,580 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+#include <getopt.h> // getopt_long()
+#include <limits.h> // INT_MAX
+#include <math.h> // fabs()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t
+#include <stdio.h> // FILE, fprintf(), printf(), snprintf()
+#include <stdlib.h> // malloc(), free()
+#include <string.h> // strlen()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "common/parallel.h" // ParallelFor()
+#include "common/parse.h" // ParseNumbers()
+#include "common/philox.h" // PhiloxElement(), PhiloxToFloat(), PhiloxToDouble()
+#include "common/prefix.h" // IsPrefix()
+#include "conv/Conv2d.h" // Self
+#include "matrix/MatMulContext.h" // MatMulContext_DefaultBlockSize(), MatMulContext_FitsBlockSize()
+
+/// Defaults of the command line (see `Conv2d_ArgumentsUsage()`).
+#define TR_CONV2D_DEFAULT_INPUT "1,64,56,56"
+#define TR_CONV2D_DEFAULT_FILTER "64,3,3"
+#define TR_CONV2D_DEFAULT_SEED 0x5EEDu
+
+/// Random streams of the input and of the filters, and the one of the
+/// sampled outputs.
+#define TR_CONV2D_STREAM_INPUT 0u
+#define TR_CONV2D_STREAM_FILTERS 1u
+#define TR_CONV2D_STREAM_SAMPLES 2u
+
+/// Outputs checked without `--cpu-check`.
+#define TR_CONV2D_SAMPLES 256u
+
+// Define convConv2dStart and convConv2dEnd.
+TR_OPENCL_IMPORT(conv, Conv2d)
+
+///
+/// The shape of a convolution, the output one (OH, OW) being derived from the
+/// others (see `ComputeOutputShape()`).
+///
+typedef struct Conv2dShape {
+  size_t N, C, H, W; // Input.
+  size_t K, R, S; // Filters.
+  size_t OH, OW; // Output.
+  size_t strideH, strideW;
+  size_t padH, padW;
+  size_t dilationH, dilationW;
+  bool nhwc;
+  bool doublePrecision;
+} Conv2dShape;
+
+///
+/// Computes the output shape, `(H + 2 * pad - dilation * (R - 1) - 1) / stride + 1`.
+///
+/// @returns `false` if the dilated kernel does not fit the padded input.
+///
+static bool ComputeOutputShape(INOUT Conv2dShape* shape) {
+  size_t heightSpan = shape->dilationH * (shape->R - 1u) + 1u;
+  size_t widthSpan = shape->dilationW * (shape->S - 1u) + 1u;
+  if (shape->H + 2u * shape->padH < heightSpan || shape->W + 2u * shape->padW < widthSpan) {
+    return false;
+  }
+
+  shape->OH = (shape->H + 2u * shape->padH - heightSpan) / shape->strideH + 1u;
+  shape->OW = (shape->W + 2u * shape->padW - widthSpan) / shape->strideW + 1u;
+  return true;
+}
+
+// ╔╦╗┌─┐┌┬┐┌─┐
+//  ║║├─┤ │ ├─┤
+// ═╩╝┴ ┴ ┴ ┴ ┴
+
+static double GetValue(IN void const* data, IN size_t index, IN bool doublePrecision) {
+  return doublePrecision ? ((double const*) data)[index] : (double) ((float const*) data)[index];
+}
+
+typedef struct Conv2dFillTask {
+  uint64_t seed;
+  uint32_t stream;
+  bool doublePrecision;
+  void* data;
+} Conv2dFillTask;
+
+///
+/// Fills the elements `[begin, end)` with the values of the stream, whatever
+/// the layout (the flat index being split into the row and the column).
+///
+static void FillElements(IN size_t begin, IN size_t end, INOUT void* data) {
+  Conv2dFillTask const* task = data;
+
+  for (size_t index = begin; index < end; ++index) {
+    uint32_t second = 0u;
+    uint32_t first = PhiloxElement(task->seed, task->stream, (uint32_t) (index >> 32), (uint32_t) index, &second);
+    if (task->doublePrecision) {
+      ((double*) task->data)[index] = PhiloxToDouble(first, second);
+    }
+    else {
+      ((float*) task->data)[index] = PhiloxToFloat(first);
+    }
+  }
+}
+
+typedef struct Conv2dCheckTask {
+  Conv2dShape const* shape;
+  uint64_t seed;
+  bool sampled;
+  void const *input, *filters, *output;
+  double* errors; // Per checked output.
+} Conv2dCheckTask;
+
+///
+/// Computes the errors of the checked outputs `[begin, end)` against a direct
+/// convolution in double-precision, relative to `|input| * |filters|`.
+///
+static void CheckOutputs(IN size_t begin, IN size_t end, INOUT void* data) {
+  Conv2dCheckTask const* task = data;
+  Conv2dShape const* shape = task->shape;
+  bool dp = shape->doublePrecision;
+
+  size_t pixels = shape->N * shape->OH * shape->OW;
+  for (size_t index = begin; index < end; ++index) {
+    size_t pixel = index / shape->K, k = index % shape->K;
+    if (task->sampled) {
+      uint32_t second = 0u;
+      pixel = PhiloxElement(task->seed, TR_CONV2D_STREAM_SAMPLES, (uint32_t) index, 0u, &second) % pixels;
+      k = second % shape->K;
+    }
+
+    size_t n = pixel / (shape->OH * shape->OW);
+    size_t oh = pixel / shape->OW % shape->OH;
+    size_t ow = pixel % shape->OW;
+
+    double reference = 0.0, magnitude = 0.0;
+    for (size_t c = 0u; c < shape->C; ++c) {
+      for (size_t r = 0u; r < shape->R; ++r) {
+        for (size_t s = 0u; s < shape->S; ++s) {
+          // Unsigned wrap-around: the padding is past H (or W) too.
+          size_t ih = oh * shape->strideH + r * shape->dilationH - shape->padH;
+          size_t iw = ow * shape->strideW + s * shape->dilationW - shape->padW;
+          if (ih >= shape->H || iw >= shape->W) { continue; }
+
+          size_t i = shape->nhwc
+            ? ((n * shape->H + ih) * shape->W + iw) * shape->C + c
+            : ((n * shape->C + c) * shape->H + ih) * shape->W + iw;
+          size_t f = shape->nhwc
+            ? ((k * shape->R + r) * shape->S + s) * shape->C + c
+            : ((k * shape->C + c) * shape->R + r) * shape->S + s;
+
+          double product = GetValue(task->input, i, dp) * GetValue(task->filters, f, dp);
+          reference += product;
+          magnitude += fabs(product);
+        }
+      }
+    }
+
+    size_t o = shape->nhwc
+      ? pixel * shape->K + k
+      : (n * shape->K + k) * shape->OH * shape->OW + oh * shape->OW + ow;
+    double error = fabs(GetValue(task->output, o, dp) - reference);
+    task->errors[index] = magnitude > 0.0 ? error / magnitude : error;
+  }
+}
+
+// ╦═╗┬ ┬┌┐┌
+// ╠╦╝│ ││││
+// ╩╚═└─┘┘└┘
+
+///
+/// Runs the implicit-GEMM kernel once, displays its time and performance,
+/// then checks the output against a direct convolution on the host.
+///
+static bool RunConvolution(
+  IN OpenClContext* openCl, IN Conv2dShape const* shape,
+  IN size_t blockSize, IN uint64_t seed, IN bool cpuCheck)
+{
+  cl_int error;
+  bool success = false;
+  cl_kernel kernel = NULL;
+  cl_mem inputBuffer = NULL, filtersBuffer = NULL, outputBuffer = NULL;
+  cl_event event = NULL;
+  void *input = NULL, *filters = NULL, *output = NULL;
+  double* errors = NULL;
+
+  size_t M = shape->N * shape->OH * shape->OW;
+  size_t N = shape->C * shape->R * shape->S;
+  size_t P = shape->K;
+  size_t checked = cpuCheck ? M * P : TR_CONV2D_SAMPLES;
+
+  size_t elementSize = shape->doublePrecision ? sizeof(double) : sizeof(float);
+  size_t inputCount = shape->N * shape->C * shape->H * shape->W;
+  size_t filtersCount = P * N;
+  size_t outputCount = M * P;
+
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options),
+    "-DCONV_BLOCKSIZE=%zu -DCONV_REAL=%s%s"
+    " -DCONV_N=%zu -DCONV_C=%zu -DCONV_H=%zu -DCONV_W=%zu -DCONV_K=%zu -DCONV_R=%zu -DCONV_S=%zu"
+    " -DCONV_OH=%zu -DCONV_OW=%zu -DCONV_STRIDE_H=%zu -DCONV_STRIDE_W=%zu"
+    " -DCONV_PAD_H=%zu -DCONV_PAD_W=%zu -DCONV_DILATION_H=%zu -DCONV_DILATION_W=%zu"
+    , blockSize, shape->doublePrecision ? "double" : "float", shape->nhwc ? " -DCONV_NHWC" : ""
+    , shape->N, shape->C, shape->H, shape->W, shape->K, shape->R, shape->S
+    , shape->OH, shape->OW, shape->strideH, shape->strideW
+    , shape->padH, shape->padW, shape->dilationH, shape->dilationW
+  );
+
+  kernel = ProgramCache_GetKernel(openCl, convConv2dStart, convConv2dEnd, options, "Conv2d");
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(Conv2d) failed");
+    goto out;
+  }
+
+  input = malloc(elementSize * inputCount);
+  filters = malloc(elementSize * filtersCount);
+  output = malloc(elementSize * outputCount);
+  errors = (double*) malloc(sizeof(double) * checked);
+  if (input == NULL || filters == NULL || output == NULL || errors == NULL) {
+    TR_ERROR("malloc(Conv2d) failed");
+    goto out;
+  }
+
+  Conv2dFillTask inputTask = { seed, TR_CONV2D_STREAM_INPUT, shape->doublePrecision, input };
+  Conv2dFillTask filtersTask = { seed, TR_CONV2D_STREAM_FILTERS, shape->doublePrecision, filters };
+  ParallelFor(inputCount, FillElements, &inputTask);
+  ParallelFor(filtersCount, FillElements, &filtersTask);
+
+  inputBuffer = clCreateBuffer(openCl->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, elementSize * inputCount, input, &error);
+  if (error != CL_SUCCESS || inputBuffer == NULL) { TR_FAILED("clCreateBuffer(Input)", error); goto out; }
+  filtersBuffer = clCreateBuffer(openCl->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, elementSize * filtersCount, filters, &error);
+  if (error != CL_SUCCESS || filtersBuffer == NULL) { TR_FAILED("clCreateBuffer(Filters)", error); goto out; }
+  outputBuffer = clCreateBuffer(openCl->context, CL_MEM_WRITE_ONLY, elementSize * outputCount, NULL, &error);
+  if (error != CL_SUCCESS || outputBuffer == NULL) { TR_FAILED("clCreateBuffer(Output)", error); goto out; }
+
+  error  = clSetKernelArg(kernel, 0, sizeof(cl_mem), &inputBuffer);
+  error |= clSetKernelArg(kernel, 1, sizeof(cl_mem), &filtersBuffer);
+  error |= clSetKernelArg(kernel, 2, sizeof(cl_mem), &outputBuffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Conv2d)", error);
+    goto out;
+  }
+
+  size_t globalSize[2] = { // (x, y) or (filters, pixels)
+    (P + blockSize - 1u) / blockSize * blockSize,
+    (M + blockSize - 1u) / blockSize * blockSize,
+  };
+
+  size_t localSize[2] = { blockSize, blockSize };
+  error = clEnqueueNDRangeKernel(openCl->queue, kernel, 2, NULL, globalSize, localSize, 0, NULL, &event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(Conv2d)", error);
+    goto out;
+  }
+
+  error = clEnqueueReadBuffer(openCl->queue, outputBuffer, CL_TRUE, 0u, elementSize * outputCount, output, 1, &event, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueReadBuffer(Output)", error);
+    goto out;
+  }
+
+  cl_ulong start = 0u, end = 0u;
+  error  = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo()", error);
+  }
+
+  // The operations of the GEMM view, the padding of the image included.
+  double nanoseconds = (double) (end - start);
+  double operations = 2.0 * (double) M * (double) N * (double) P;
+  double im2colBytes = (double) elementSize * (double) M * (double) N;
+
+  printf(
+    TAB0 "Convolution Results:" LF
+    TAB1 "Kernel.Time............: %.3f ms" LF
+    TAB1 "Performance............: %.3f GFLOP/s" LF
+    TAB1 "Im2col.Avoided.........: %.1f MiB" LF
+    , nanoseconds * 1e-6
+    , nanoseconds > 0.0 ? operations / nanoseconds : 0.0
+    , im2colBytes / (1024.0 * 1024.0)
+  );
+
+  Conv2dCheckTask check = {
+    .shape = shape, .seed = seed, .sampled = !cpuCheck,
+    .input = input, .filters = filters, .output = output, .errors = errors,
+  };
+
+  ParallelFor(checked, CheckOutputs, &check);
+
+  double maxError = 0.0;
+  for (size_t index = 0u; index < checked; ++index) {
+    maxError = errors[index] > maxError ? errors[index] : maxError;
+  }
+
+  double tolerance = 2.0 * (double) N * (shape->doublePrecision ? DBL_EPSILON : (double) FLT_EPSILON);
+  success = maxError <= tolerance;
+  printf(
+    TAB1 "CPU.Check..............: %s (%zu %s outputs)" LF
+    TAB1 "Max.Relative.Error.....: %g of |I|*|F| (tolerance %g)" LFLF
+    , success ? "Passed" : "Failed", checked, cpuCheck ? "checked" : "sampled"
+    , maxError, tolerance
+  );
+
+out:
+  if (event != NULL && CL_SUCCESS != (error = clReleaseEvent(event))) { TR_FAILED("clReleaseEvent()", error); }
+  if (kernel != NULL && CL_SUCCESS != (error = clReleaseKernel(kernel))) { TR_FAILED("clReleaseKernel()", error); }
+  if (outputBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(outputBuffer))) { TR_FAILED("clReleaseMemObject(Output)", error); }
+  if (filtersBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(filtersBuffer))) { TR_FAILED("clReleaseMemObject(Filters)", error); }
+  if (inputBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(inputBuffer))) { TR_FAILED("clReleaseMemObject(Input)", error); }
+
+  free(errors);
+  free(output);
+  free(filters);
+  free(input);
+  return success;
+}
+
+// ╔═╗┌─┐┌┬┐┌┬┐┌─┐┌┐┌┌┬┐
+// ║  │ ││││││││├─┤│││ ││
+// ╚═╝└─┘┴ ┴┴ ┴┴ ┴┘└┘╶┴┘
+
+///
+/// Parses a comma-separated list of `count` positive (or non-negative, with
+/// `allowZero`) numbers of the given option, displaying an error otherwise.
+///
+static bool ParseList(
+  IN char const* option, IN char const* value,
+  IN size_t count, IN bool allowZero, OUT size_t* results)
+{
+  char const* cursor = value;
+  bool valid = ParseNumbers(&cursor, results, count);
+  for (size_t index = 0u; valid && index < count; ++index) {
+    valid = allowZero || results[index] > 0u;
+  }
+
+  if (!valid) {
+    int padding = cursor > value ? (int) (cursor - value) + 1 : 0;
+    fprintf(stderr, LF
+      "The %s must be a comma-separated list of %zu %s numbers:" LF
+      TAB1 "--%s %s" LF
+      TAB1 "   %*s%*c Unexpected character or value" LFLF
+      , option, count, allowZero ? "non-negative" : "positive"
+      , option, value, (int) strlen(option), "", padding, '^'
+    );
+  }
+
+  return valid;
+}
+
+void Conv2d_ArgumentsUsage(IN FILE* stream, IN char const* command) {
+  assert(stream != NULL);
+  assert(command != NULL);
+
+  fprintf(stream,
+    TAB1 BOLD("%s") LF
+
+    TAB2 "Runs a 2D convolution as an implicit GEMM (im2col gathered on the fly into the local" LF
+    TAB2 "tiles of the MatMul kernel), reports it in GFLOP/s and checks it on the host:" LFLF
+
+    TAB2 BOLD("-d, --device") " GPU | CPU | Default | Fastest | <PlatformIndex>:<DeviceIndex>" LF
+    TAB3 "Specifies which device to use (prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-i, --input") " <N>,<C>,<H>,<W>" LF
+    TAB3 "The batch size, channels, height and width of the input (default " TR_CONV2D_DEFAULT_INPUT ")." LFLF
+
+    TAB2 BOLD("-w, --filter") " <K>,<R>,<S>" LF
+    TAB3 "The number of filters (output channels), their height and width (default " TR_CONV2D_DEFAULT_FILTER ")." LFLF
+
+    TAB2 BOLD("-s, --stride") " <H>,<W>" LF
+    TAB3 "The vertical and horizontal strides (default 1,1)." LFLF
+
+    TAB2 BOLD("-p, --padding") " <H>,<W>" LF
+    TAB3 "The zero padding added to each side of the input (default 0,0)." LFLF
+
+    TAB2 BOLD("-D, --dilation") " <H>,<W>" LF
+    TAB3 "The spacing between the taps of the filters (default 1,1)." LFLF
+
+    TAB2 BOLD("-l, --layout") " NCHW | NHWC" LF
+    TAB3 "The layout of the input and output (prefix, case-insensitive), the filters being" LF
+    TAB3 "(K, C, R, S) or (K, R, S, C) respectively (default NCHW)." LFLF
+
+    TAB2 BOLD("-f, --double-precision") LF
+    TAB3 "Enables the double-precision floating-point extension." LFLF
+
+    TAB2 BOLD("-b, --block-size") " <Size>" LF
+    TAB3 "The size of the local tiles (by default, the largest fitting the work-group and local" LF
+    TAB3 "memory limits of the device, up to 32, as matmul)." LFLF
+
+    TAB2 BOLD("-S, --seed") " <Seed>" LF
+    TAB3 "The seed of the random input and filters." LFLF
+
+    TAB2 BOLD("-c, --cpu-check") LF
+    TAB3 "Checks every output against the host instead of a sample of them." LFLF
+
+    TAB2 BOLD("-h, --help") LF
+    TAB3 "Displays this help and quit." LFLF
+
+    , command
+  );
+}
+
+int Conv2d_Run(IN int argc, IN char* argv[]) {
+  assert(argc >= 1 && argv[0] != NULL);
+
+  static struct option options[] = {
+    { "device", required_argument, NULL, 'd' },
+    { "input", required_argument, NULL, 'i' },
+    { "filter", required_argument, NULL, 'w' },
+    { "stride", required_argument, NULL, 's' },
+    { "padding", required_argument, NULL, 'p' },
+    { "dilation", required_argument, NULL, 'D' },
+    { "layout", required_argument, NULL, 'l' },
+    { "double-precision", no_argument, NULL, 'f' },
+    { "block-size", required_argument, NULL, 'b' },
+    { "seed", required_argument, NULL, 'S' },
+    { "cpu-check", no_argument, NULL, 'c' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 },
+  };
+
+  int option;
+  char const* device = "Default";
+  char const* input = TR_CONV2D_DEFAULT_INPUT;
+  char const* filter = TR_CONV2D_DEFAULT_FILTER;
+  char const* stride = NULL;
+  char const* padding = NULL;
+  char const* dilation = NULL;
+  char const* layout = NULL;
+  char const* blockSize = NULL;
+  char const* seed = NULL;
+  bool doublePrecision = false;
+  bool cpuCheck = false;
+
+  opterr = 1; // Prints error on stderr.
+  while (0 <= (option = getopt_long(argc, argv, "d:i:w:s:p:D:l:fb:S:ch", options, NULL))) {
+    switch (option) {
+      case 'd': device = optarg; break;
+      case 'i': input = optarg; break;
+      case 'w': filter = optarg; break;
+      case 's': stride = optarg; break;
+      case 'p': padding = optarg; break;
+      case 'D': dilation = optarg; break;
+      case 'l': layout = optarg; break;
+      case 'f': doublePrecision = true; break;
+      case 'b': blockSize = optarg; break;
+      case 'S': seed = optarg; break;
+      case 'c': cpuCheck = true; break;
+      case 'h':
+        Conv2d_ArgumentsUsage(stdout, argv[0]);
+        return 2;
+      default:
+        return 0;
+    }
+  }
+
+  Conv2dShape shape = {
+    .strideH = 1u, .strideW = 1u, .padH = 0u, .padW = 0u, .dilationH = 1u, .dilationW = 1u,
+    .doublePrecision = doublePrecision,
+  };
+
+  size_t values[4] = { 0u };
+  if (!ParseList("input", input, 4u, false, values)) { return 0; }
+  shape.N = values[0]; shape.C = values[1]; shape.H = values[2]; shape.W = values[3];
+
+  if (!ParseList("filter", filter, 3u, false, values)) { return 0; }
+  shape.K = values[0]; shape.R = values[1]; shape.S = values[2];
+
+  if (stride != NULL) {
+    if (!ParseList("stride", stride, 2u, false, values)) { return 0; }
+    shape.strideH = values[0]; shape.strideW = values[1];
+  }
+
+  if (padding != NULL) {
+    if (!ParseList("padding", padding, 2u, true, values)) { return 0; }
+    shape.padH = values[0]; shape.padW = values[1];
+  }
+
+  if (dilation != NULL) {
+    if (!ParseList("dilation", dilation, 2u, false, values)) { return 0; }
+    shape.dilationH = values[0]; shape.dilationW = values[1];
+  }
+
+  if (layout != NULL) {
+    if (IsPrefix(layout, "NHWC", 5)) {
+      shape.nhwc = true;
+    }
+    else if (!IsPrefix(layout, "NCHW", 5)) {
+      fprintf(stderr, LF "The layout must be NCHW or NHWC:" LF TAB1 "--layout %s" LFLF, layout);
+      return 0;
+    }
+  }
+
+  uint64_t seedValue = TR_CONV2D_DEFAULT_SEED;
+  if (seed != NULL) {
+    size_t parsed = 0u;
+    char const* cursor = seed;
+    if (!ParseNumbers(&cursor, &parsed, 1)) {
+      fprintf(stderr, LF "The seed must be a number:" LF TAB1 "--seed %s" LFLF, seed);
+      return 0;
+    }
+
+    seedValue = (uint64_t) parsed;
+  }
+
+  if (!ComputeOutputShape(&shape)) {
+    fprintf(stderr, LF "The dilated filters (%zu, %zu) do not fit the padded input (%zu, %zu)." LFLF
+      , shape.dilationH * (shape.R - 1u) + 1u, shape.dilationW * (shape.S - 1u) + 1u
+      , shape.H + 2u * shape.padH, shape.W + 2u * shape.padW);
+    return 0;
+  }
+
+  // The kernel indexes the rows of the receptive fields with int.
+  if (shape.H + shape.padH > INT_MAX / 2u || shape.W + shape.padW > INT_MAX / 2u
+    || shape.OH * shape.strideH > INT_MAX / 2u || shape.OW * shape.strideW > INT_MAX / 2u)
+  {
+    fprintf(stderr, LF "The input (%zu, %zu) is too large for the kernel." LFLF, shape.H, shape.W);
+    return 0;
+  }
+
+  OpenClContext openCl;
+  if (OpenClContext_FromString(device, &openCl) != 1) {
+    fprintf(stderr, LF "The device cannot be opened:" LF TAB1 "--device %s" LFLF, device);
+    return 0;
+  }
+
+  int result = 0;
+  if (doublePrecision && !OpenClContext_EnableDoublePrecision(&openCl)) {
+    fprintf(stderr, LF "The device does not support double-precision." LFLF);
+    goto out;
+  }
+
+  // The default block size of MatMul, the kernel having its single unpadded tiles.
+  OpenClCapabilities const* capabilities = &openCl.capabilities;
+  size_t elementSize = doublePrecision ? sizeof(double) : sizeof(float);
+  size_t tileSize = MatMulContext_DefaultBlockSize(capabilities, elementSize, false, false);
+
+  if (blockSize != NULL) {
+    char const* cursor = blockSize;
+    if (!ParseNumbers(&cursor, &tileSize, 1) || tileSize == 0u
+      || !MatMulContext_FitsBlockSize(capabilities, tileSize, elementSize, false, false, capabilities->localMemorySize))
+    {
+      fprintf(stderr, LF "The block size must fit the work-group and local memory limits of the device:" LF
+        TAB1 "--block-size %s" LFLF, blockSize);
+      goto out;
+    }
+  }
+
+  printf(
+    TAB0 "Convolution:" LF
+    TAB1 "Input..................: (%zu, %zu, %zu, %zu) %s" LF
+    TAB1 "Filters................: (%zu, %zu, %zu, %zu)" LF
+    TAB1 "Output.................: (%zu, %zu, %zu, %zu)" LF
+    TAB1 "Stride.................: (%zu, %zu)" LF
+    TAB1 "Padding................: (%zu, %zu)" LF
+    TAB1 "Dilation...............: (%zu, %zu)" LF
+    TAB1 "GEMM.Shape.............: (%zu, %zu, %zu)" LF
+    TAB1 "Block.Size.............: %zu" LF
+    TAB1 "Floating.Point.........: %s" LFLF
+    , shape.N, shape.nhwc ? shape.H : shape.C, shape.nhwc ? shape.W : shape.H, shape.nhwc ? shape.C : shape.W
+    , shape.nhwc ? "NHWC" : "NCHW"
+    , shape.K, shape.nhwc ? shape.R : shape.C, shape.nhwc ? shape.S : shape.R, shape.nhwc ? shape.C : shape.S
+    , shape.N, shape.nhwc ? shape.OH : shape.K, shape.nhwc ? shape.OW : shape.OH, shape.nhwc ? shape.K : shape.OW
+    , shape.strideH, shape.strideW, shape.padH, shape.padW, shape.dilationH, shape.dilationW
+    , shape.N * shape.OH * shape.OW, shape.C * shape.R * shape.S, shape.K
+    , tileSize, doublePrecision ? "Double-Precision" : "Single-Precision"
+  );
+
+  result = RunConvolution(&openCl, &shape, tileSize, seedValue, cpuCheck) ? 1 : 0;
+
+out:
+  if (!OpenClContext_Release(&openCl)) {
+    TR_ERROR("OpenClContext_Release() failed");
+  }
+
+  return result;
+}
@@ -0,0 +1,170 @@
+#ifndef CONV_BLOCKSIZE
+#error CONV_BLOCKSIZE is undefined.
+#endif
+
+#ifndef CONV_REAL
+#define CONV_REAL float
+#endif
+
+#if !defined(CONV_N) || !defined(CONV_C) || !defined(CONV_H) || !defined(CONV_W) \
+  || !defined(CONV_K) || !defined(CONV_R) || !defined(CONV_S) \
+  || !defined(CONV_OH) || !defined(CONV_OW)
+#error The convolution shape is undefined.
+#endif
+
+#if !defined(CONV_STRIDE_H) || !defined(CONV_STRIDE_W) \
+  || !defined(CONV_PAD_H) || !defined(CONV_PAD_W) \
+  || !defined(CONV_DILATION_H) || !defined(CONV_DILATION_W)
+#error The convolution stride, padding or dilation is undefined.
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+
+typedef CONV_REAL Real;
+
+///
+/// The GEMM view of the convolution, `Output(M, P) = Im2col(M, N) * Filters(N, P)`:
+///   - M: the output pixels `(n, oh, ow)`,
+///   - N: the reduction `(c, r, s)` in NCHW, `(r, s, c)` in NHWC,
+///   - P: the filters `k`.
+///
+#define GEMM_M ((size_t) CONV_N * CONV_OH * CONV_OW)
+#define GEMM_N ((size_t) CONV_C * CONV_R * CONV_S)
+#define GEMM_P ((size_t) CONV_K)
+
+///
+/// Returns the element `(pixel, reduction)` of the (virtual) im2col matrix, the
+/// pixel being given by its image `n` and the top-left corner `(ihBase, iwBase)`
+/// of its receptive field, 0 in the padding and past the bounds of the GEMM.
+///
+/// The shape being given at build time, the divisions are by constants.
+///
+static Real LoadIm2col(
+  IN __global Real const* input,
+  IN size_t const n, IN int const ihBase, IN int const iwBase,
+  IN bool const valid, IN size_t const reduction)
+{
+  if (!valid || reduction >= GEMM_N) {
+    return (Real) 0;
+  }
+
+#ifndef CONV_NHWC
+  size_t const c = reduction / (CONV_R * CONV_S);
+  size_t const r = reduction / CONV_S % CONV_R;
+  size_t const s = reduction % CONV_S;
+#else // CONV_NHWC
+  size_t const r = reduction / (CONV_S * CONV_C);
+  size_t const s = reduction / CONV_C % CONV_S;
+  size_t const c = reduction % CONV_C;
+#endif // CONV_NHWC
+
+  int const ih = ihBase + (int) r * CONV_DILATION_H;
+  int const iw = iwBase + (int) s * CONV_DILATION_W;
+  if (ih < 0 || ih >= CONV_H || iw < 0 || iw >= CONV_W) {
+    return (Real) 0;
+  }
+
+#ifndef CONV_NHWC
+  return input[((n * CONV_C + c) * CONV_H + (size_t) ih) * CONV_W + (size_t) iw];
+#else // CONV_NHWC
+  return input[((n * CONV_H + (size_t) ih) * CONV_W + (size_t) iw) * CONV_C + c];
+#endif // CONV_NHWC
+}
+
+///
+/// Computes a 2D convolution (cross-correlation) as an implicit GEMM with the
+/// local tiles of the MatMul kernel (see `matrix/MatMul.cl`), the tile of the
+/// im2col matrix being gathered from the input while loading it:
+///   - `CONV_NHWC` undefined: input (N, C, H, W), filters (K, C, R, S), output (N, K, OH, OW),
+///   - `CONV_NHWC` defined:   input (N, H, W, C), filters (K, R, S, C), output (N, OH, OW, K).
+///
+/// The filters are thus a row-major (P, N) matrix in both layouts, i.e. the
+/// `TRANS_B` storage of MatMul. The im2col tile is loaded along the pixels in
+/// NCHW (consecutive `ow`) and along the reduction in NHWC (consecutive `c`),
+/// so that consecutive work-items read consecutive addresses in both layouts.
+///
+/// Nothing is padded: the blocks past the bounds of the GEMM load 0 and do not
+/// store anything.
+///
+/// The tile loop is deliberately a copy of the single-buffered one of MatMul:
+/// every `.cl` file is embedded and built on its own (see `TR_OPENCL_IMPORT()`),
+/// so there is no header to share it through, and only the 3-line inner product
+/// would be common, the loads (gathered im2col, bounds instead of padding) and
+/// the store being specific. The MatMul variants (`--local-tiles`, `--operands`,
+/// epilogues) are thus not available here.
+///
+/// @pre get_global_size(0, 1) is (P, M) rounded up to CONV_BLOCKSIZE.
+///
+__attribute__((reqd_work_group_size(CONV_BLOCKSIZE, CONV_BLOCKSIZE, 1)))
+__kernel void Conv2d(
+  IN  __global Real const* input,
+  IN  __global Real const* filters,
+  OUT __global Real      * output)
+{
+  __local Real ALocal[CONV_BLOCKSIZE][CONV_BLOCKSIZE]; // [pixel][reduction]
+  __local Real BLocal[CONV_BLOCKSIZE][CONV_BLOCKSIZE]; // [filter][reduction]
+
+  size_t const xGlobal = get_global_id(0); // [0..P] (Filter)
+  size_t const yGlobal = get_global_id(1); // [0..M] (Pixel)
+
+  size_t const xLocal = get_local_id(0);
+  size_t const yLocal = get_local_id(1);
+
+  size_t const xBlock = get_group_id(0);
+  size_t const yBlock = get_group_id(1);
+
+#ifndef CONV_NHWC
+  size_t const ARow = xLocal, AColumn = yLocal; // Transpose.
+#else // CONV_NHWC
+  size_t const ARow = yLocal, AColumn = xLocal;
+#endif // CONV_NHWC
+
+  // The pixel of the im2col row loaded by this work-item, decomposed once.
+  size_t const pixel = yBlock * CONV_BLOCKSIZE + ARow;
+  bool const validPixel = pixel < GEMM_M;
+  size_t const n = pixel / (CONV_OH * CONV_OW);
+  int const ihBase = (int) (pixel / CONV_OW % CONV_OH) * CONV_STRIDE_H - CONV_PAD_H;
+  int const iwBase = (int) (pixel % CONV_OW) * CONV_STRIDE_W - CONV_PAD_W;
+
+  size_t const filter = xBlock * CONV_BLOCKSIZE + yLocal;
+  bool const validFilter = filter < GEMM_P;
+  __global Real const* filterRow = filters + filter * GEMM_N;
+
+  Real accumulator = (Real) 0;
+
+  size_t const numberOfBlocks = (GEMM_N + CONV_BLOCKSIZE - 1u) / CONV_BLOCKSIZE;
+  for (size_t nBlock = 0; nBlock < numberOfBlocks; ++nBlock) {
+    size_t const base = nBlock * CONV_BLOCKSIZE;
+
+    ALocal[ARow][AColumn] = LoadIm2col(input, n, ihBase, iwBase, validPixel, base + AColumn);
+    BLocal[yLocal][xLocal] = validFilter && base + xLocal < GEMM_N ? filterRow[base + xLocal] : (Real) 0;
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    #pragma unroll
+    for (size_t nLocal = 0; nLocal < CONV_BLOCKSIZE; ++nLocal) {
+      accumulator += ALocal[yLocal][nLocal] * BLocal[xLocal][nLocal];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (yGlobal >= GEMM_M || xGlobal >= GEMM_P) {
+    return;
+  }
+
+#ifndef CONV_NHWC
+  size_t const image = yGlobal / (CONV_OH * CONV_OW);
+  size_t const offset = yGlobal % (CONV_OH * CONV_OW);
+  output[(image * CONV_K + xGlobal) * (CONV_OH * CONV_OW) + offset] = accumulator;
+#else // CONV_NHWC
+  output[yGlobal * GEMM_P + xGlobal] = accumulator;
+#endif // CONV_NHWC
+}
@@ -0,0 +1,27 @@
+#ifndef TR_CONV_CONV2D_H
+#define TR_CONV_CONV2D_H
+
+#include <stdio.h> // FILE
+
+#include "common/helper.h" // IN, INOUT, OUT
+
+///
+/// Displays the usage of the `conv2d` command.
+///
+/// @pre `stream` and `command` are not NULL.
+///
+void Conv2d_ArgumentsUsage(IN FILE* stream, IN char const* command);
+
+///
+/// Runs a 2D convolution (the `conv2d` command) as an implicit GEMM: the
+/// output pixels are the rows, the filters the columns and the (channel,
+/// kernel row, kernel column) triplets the reduction, the im2col matrix being
+/// never materialized (see `conv/Conv2d.cl`).
+///
+/// @returns `0` on failure (check included), `1` on success, `2` for `--help`.
+///
+/// @post Display content on stdout, may display error on stderr.
+///
+int Conv2d_Run(IN int argc, IN char* argv[]);
+
+#endif // TR_CONV_CONV2D_H
@@ -1,14 +1,36 @@
 #include <stdio.h> // FILE, stdout, stderr
 #include <stdlib.h> // EXIT_SUCCESS, EXIT_FAILURE
 
+#include "common/Devices.h" // Devices_Display()
+#include "common/helper.h" // TAB, LF, BOLD()
 #include "common/prefix.h" // IsPrefix()
+#include "common/Roofline.h" // Roofline_Run()
+#include "conv/Conv2d.h" // Conv2d_Run()
 #include "matrix/MatMulContext.h" // Self{}
 #include "matrix/MatMulProgram.h" //
+#include "matrix/Perf.h" // Perf_Run()
+#include "vector/Fusion.h" // Fusion_Run()
 
 #define TR_COMMAND_MATMUL "matmul"
+#define TR_COMMAND_DEVICES "devices"
+#define TR_COMMAND_PERF "perf"
+#define TR_COMMAND_ROOFLINE "roofline"
+#define TR_COMMAND_CONV2D "conv2d"
+#define TR_COMMAND_FUSE "fuse"
 
 static void Usage(FILE* stream) {
   MatMulContext_ArgumentsUsage(stream, TR_COMMAND_MATMUL);
+
+  fprintf(stream,
+    TAB1 BOLD(TR_COMMAND_DEVICES) LF
+    TAB2 "Lists every OpenCL platform and device with their key capabilities" LF
+    TAB2 "(and their probe scores once ranked by --device Fastest)." LFLF
+  );
+
+  Perf_ArgumentsUsage(stream, TR_COMMAND_PERF);
+  Roofline_ArgumentsUsage(stream, TR_COMMAND_ROOFLINE);
+  Conv2d_ArgumentsUsage(stream, TR_COMMAND_CONV2D);
+  Fusion_ArgumentsUsage(stream, TR_COMMAND_FUSE);
 }
 
 int main(int argc, char* argv[]) {
@@ -33,6 +55,34 @@ int main(int argc, char* argv[]) {
     return result == 0 ? EXIT_FAILURE : EXIT_SUCCESS;
   }
 
+  if (IsPrefix(argv[1], TR_COMMAND_DEVICES, sizeof(TR_COMMAND_DEVICES))) {
+    return Devices_Display() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
+  if (IsPrefix(argv[1], TR_COMMAND_PERF, sizeof(TR_COMMAND_PERF))) {
+    argv[1] = TR_COMMAND_PERF;
+    int result = Perf_Run(argc - 1, argv + 1);
+    return result == 0 ? EXIT_FAILURE : EXIT_SUCCESS; // 2 is --help
+  }
+
+  if (IsPrefix(argv[1], TR_COMMAND_ROOFLINE, sizeof(TR_COMMAND_ROOFLINE))) {
+    argv[1] = TR_COMMAND_ROOFLINE;
+    int result = Roofline_Run(argc - 1, argv + 1);
+    return result == 0 ? EXIT_FAILURE : EXIT_SUCCESS; // 2 is --help
+  }
+
+  if (IsPrefix(argv[1], TR_COMMAND_CONV2D, sizeof(TR_COMMAND_CONV2D))) {
+    argv[1] = TR_COMMAND_CONV2D;
+    int result = Conv2d_Run(argc - 1, argv + 1);
+    return result == 0 ? EXIT_FAILURE : EXIT_SUCCESS; // 2 is --help
+  }
+
+  if (IsPrefix(argv[1], TR_COMMAND_FUSE, sizeof(TR_COMMAND_FUSE))) {
+    argv[1] = TR_COMMAND_FUSE;
+    int result = Fusion_Run(argc - 1, argv + 1);
+    return result == 0 ? EXIT_FAILURE : EXIT_SUCCESS; // 2 is --help
+  }
+
   Usage(stdout);
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,252 @@
+#ifndef TR_MATRIX_COMPARE_C
+#ifndef TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // fprintf(), snprintf()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+
+#define GETKERNEL(TYPE) TR_JOIN2(_, GetCompareKernel, TYPE)
+
+/// Work-group size of the reductions (a power of 2), and their number of work-groups.
+#define TR_COMPARE_GROUP 64u
+#define TR_COMPARE_GROUPS 256u
+
+// Define matrixCompareStart and matrixCompareEnd.
+TR_OPENCL_IMPORT(matrix, Compare)
+
+#define TR_MATRIX_PRECISION float
+#include "matrix/Compare.c"
+#undef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION double
+#  include "matrix/Compare.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_COMPARE_C
+#else // TR_MATRIX_PRECISION
+
+#include "matrix/Compare.h" // Compare(), CompareStatistics{}
+
+#undef TR_EPSILON
+#define TR_EPSILON _Generic((TR_MATRIX_PRECISION) 0, float: FLT_EPSILON, double: DBL_EPSILON)
+
+#undef TR_COMPARE_INT
+#define TR_COMPARE_INT _Generic((TR_MATRIX_PRECISION) 0, float: "int", double: "long")
+
+///
+/// Returns the kernel `name` of `matrix/Compare.cl` (built once per precision).
+///
+/// @returns A retained kernel, or NULL on failure.
+///
+static cl_kernel GETKERNEL(TR_MATRIX_PRECISION)(IN OpenClContext* openCl, IN char const* name) {
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options),
+    "-DCOMPARE_REAL=%s -DCOMPARE_INT=%s -DCOMPARE_GROUP=%u -DCOMPARE_BUCKETS=%u"
+    , TR_STRINGIFY(TR_MATRIX_PRECISION), TR_COMPARE_INT, TR_COMPARE_GROUP, TR_COMPARE_BUCKETS
+  );
+
+  return ProgramCache_GetKernel(openCl, matrixCompareStart, matrixCompareEnd, options, name);
+}
+
+bool Compare(Buffers)(
+  IN MatMulContext* this,
+  IN cl_mem C, IN cl_mem R, IN cl_mem bound,
+  OUT CompareStatistics* statistics)
+{
+  assert(this != NULL && statistics != NULL);
+  assert(C != NULL && R != NULL && bound != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_context context = this->openCl.context;
+  cl_command_queue queue = this->openCl.queue;
+  cl_kernel blocks = NULL, reduce = NULL;
+  cl_mem maximaBuffer = NULL, countsBuffer = NULL;
+
+  size_t const counts = TR_COMPARE_BUCKETS + 2u; // Histogram, non-finite, failures.
+
+  *statistics = (CompareStatistics) {
+    .tolerance = 2.0 * (double) this->N * TR_EPSILON,
+  };
+
+  blocks = GETKERNEL(TR_MATRIX_PRECISION)(&this->openCl, "CompareBlocks");
+  reduce = GETKERNEL(TR_MATRIX_PRECISION)(&this->openCl, "CompareReduce");
+  if (blocks == NULL || reduce == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(CompareBlocks, CompareReduce) failed");
+    goto out;
+  }
+
+  maximaBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * 2u * TR_COMPARE_GROUPS, NULL, &error);
+  if (error != CL_SUCCESS || maximaBuffer == NULL) { TR_FAILED("clCreateBuffer(maxima)", error); goto out; }
+  countsBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(cl_uint) * counts * TR_COMPARE_GROUPS, NULL, &error);
+  if (error != CL_SUCCESS || countsBuffer == NULL) { TR_FAILED("clCreateBuffer(counts)", error); goto out; }
+
+  cl_uint arguments[4] = {
+    (cl_uint) this->M, (cl_uint) this->P,
+    (cl_uint) (this->P + this->paddingP),
+    TR_COMPARE_GROUPS,
+  };
+
+  TR_MATRIX_PRECISION tolerance = (TR_MATRIX_PRECISION) statistics->tolerance;
+
+  error  = clSetKernelArg(blocks, 0, sizeof(cl_uint), &arguments[0]);
+  error |= clSetKernelArg(blocks, 1, sizeof(cl_uint), &arguments[1]);
+  error |= clSetKernelArg(blocks, 2, sizeof(cl_uint), &arguments[2]);
+  error |= clSetKernelArg(blocks, 3, sizeof(TR_MATRIX_PRECISION), &tolerance);
+  error |= clSetKernelArg(blocks, 4, sizeof(cl_mem), &C);
+  error |= clSetKernelArg(blocks, 5, sizeof(cl_mem), &R);
+  error |= clSetKernelArg(blocks, 6, sizeof(cl_mem), &bound);
+  error |= clSetKernelArg(blocks, 7, sizeof(cl_mem), &maximaBuffer);
+  error |= clSetKernelArg(blocks, 8, sizeof(cl_mem), &countsBuffer);
+  error |= clSetKernelArg(reduce, 0, sizeof(cl_uint), &arguments[3]);
+  error |= clSetKernelArg(reduce, 1, sizeof(cl_mem), &maximaBuffer);
+  error |= clSetKernelArg(reduce, 2, sizeof(cl_mem), &countsBuffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Compare)", error);
+    goto out;
+  }
+
+  size_t localSize = TR_COMPARE_GROUP;
+  size_t globalSize = TR_COMPARE_GROUP * TR_COMPARE_GROUPS;
+  error = clEnqueueNDRangeKernel(queue, blocks, 1, NULL, &globalSize, &localSize, 0, NULL, NULL);
+  if (error != CL_SUCCESS) { TR_FAILED("clEnqueueNDRangeKernel(CompareBlocks)", error); goto out; }
+  error = clEnqueueNDRangeKernel(queue, reduce, 1, NULL, &localSize, &localSize, 0, NULL, NULL);
+  if (error != CL_SUCCESS) { TR_FAILED("clEnqueueNDRangeKernel(CompareReduce)", error); goto out; }
+
+  // Only the reduced values are read back (a few bytes instead of C).
+  TR_MATRIX_PRECISION maxima[2] = { 0 };
+  cl_uint values[TR_COMPARE_BUCKETS + 2u] = { 0u };
+  error  = clEnqueueReadBuffer(queue, maximaBuffer, CL_FALSE, 0u, sizeof(maxima), maxima, 0, NULL, NULL);
+  error |= clEnqueueReadBuffer(queue, countsBuffer, CL_TRUE, 0u, sizeof(values), values, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueReadBuffer(Compare)", error);
+    goto out;
+  }
+
+  statistics->maxAbsoluteError = (double) maxima[0];
+  statistics->maxRelativeError = (double) maxima[1];
+  for (size_t bucket = 0u; bucket < TR_COMPARE_BUCKETS; ++bucket) {
+    statistics->histogram[bucket] = values[bucket];
+  }
+
+  statistics->nonFinite = values[TR_COMPARE_BUCKETS];
+  statistics->failures = values[TR_COMPARE_BUCKETS + 1u];
+
+  success = true;
+
+out:
+  // Pending commands use the host memory.
+  if (queue != NULL) { clFinish(queue); }
+
+  if (countsBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(countsBuffer))) { TR_FAILED("clReleaseMemObject(counts)", error); }
+  if (maximaBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(maximaBuffer))) { TR_FAILED("clReleaseMemObject(maxima)", error); }
+  if (reduce != NULL) { clReleaseKernel(reduce); }
+  if (blocks != NULL) { clReleaseKernel(blocks); }
+
+  return success;
+}
+
+bool Compare(NewReference)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B,
+  OUT cl_mem* R, OUT cl_mem* bound)
+{
+  assert(this != NULL && R != NULL && bound != NULL);
+  assert(A != NULL && B != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_context context = this->openCl.context;
+  cl_command_queue queue = this->openCl.queue;
+  cl_kernel reference = NULL;
+  cl_mem RBuffer = NULL, boundBuffer = NULL;
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+  size_t bytes = sizeof(TR_MATRIX_PRECISION) * M * P;
+
+  reference = GETKERNEL(TR_MATRIX_PRECISION)(&this->openCl, "Reference");
+  if (reference == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(Reference) failed");
+    goto out;
+  }
+
+  RBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, NULL, &error);
+  if (error != CL_SUCCESS || RBuffer == NULL) { TR_FAILED("clCreateBuffer(R)", error); goto out; }
+  boundBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, bytes, NULL, &error);
+  if (error != CL_SUCCESS || boundBuffer == NULL) { TR_FAILED("clCreateBuffer(bound)", error); goto out; }
+
+  cl_uint arguments[8] = {
+    (cl_uint) this->M, (cl_uint) this->N, (cl_uint) this->P,
+    (cl_uint) (this->transA ? M : N),
+    (cl_uint) (this->transB ? N : P),
+    (cl_uint) P,
+    this->transA ? 1u : 0u,
+    this->transB ? 1u : 0u,
+  };
+
+  error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < 8u; ++index) {
+    error |= clSetKernelArg(reference, index, sizeof(cl_uint), &arguments[index]);
+  }
+
+  error |= clSetKernelArg(reference, 8, sizeof(cl_mem), &A);
+  error |= clSetKernelArg(reference, 9, sizeof(cl_mem), &B);
+  error |= clSetKernelArg(reference, 10, sizeof(cl_mem), &RBuffer);
+  error |= clSetKernelArg(reference, 11, sizeof(cl_mem), &boundBuffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Reference)", error);
+    goto out;
+  }
+
+  size_t globalSize[2] = { this->P, this->M }; // (columns, rows)
+  error = clEnqueueNDRangeKernel(queue, reference, 2, NULL, globalSize, NULL, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(Reference)", error);
+    goto out;
+  }
+
+  // Ownership goes to the caller.
+  *R = RBuffer; RBuffer = NULL;
+  *bound = boundBuffer; boundBuffer = NULL;
+  success = true;
+
+out:
+  if (boundBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(boundBuffer))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (RBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(RBuffer))) { TR_FAILED("clReleaseMemObject(R)", error); }
+  if (reference != NULL) { clReleaseKernel(reference); }
+
+  return success;
+}
+
+bool Compare(Reference)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  OUT CompareStatistics* statistics)
+{
+  assert(this != NULL && statistics != NULL);
+  assert(A != NULL && B != NULL && C != NULL);
+
+  cl_int error;
+  cl_mem R = NULL, bound = NULL;
+  if (!Compare(NewReference)(this, A, B, &R, &bound)) {
+    return false;
+  }
+
+  // The in-order queue runs the comparison after the reference.
+  bool success = Compare(Buffers)(this, C, R, bound, statistics);
+
+  if (CL_SUCCESS != (error = clReleaseMemObject(bound))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (CL_SUCCESS != (error = clReleaseMemObject(R))) { TR_FAILED("clReleaseMemObject(R)", error); }
+
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_COMPARE_C
@@ -0,0 +1,237 @@
+#ifndef COMPARE_REAL
+#define COMPARE_REAL float
+#endif
+
+#ifndef COMPARE_INT // Integer of the same size as COMPARE_REAL (int | long).
+#define COMPARE_INT int
+#endif
+
+#ifndef COMPARE_GROUP // Work-group size, must be a power of 2.
+#define COMPARE_GROUP 64
+#endif
+
+#ifndef COMPARE_BUCKETS // Number of buckets of the ULP histogram.
+#define COMPARE_BUCKETS 16
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+#define INOUT
+
+#define CONCAT_HELPER(A, B) A##B
+#define CONCAT(A, B) CONCAT_HELPER(A, B)
+
+typedef COMPARE_REAL Real;
+typedef unsigned COMPARE_INT Unsigned;
+
+/// Per work-group counters: the ULP histogram, then the non-finite elements
+/// of C, then the elements out of tolerance.
+#define COMPARE_NONFINITE (COMPARE_BUCKETS)
+#define COMPARE_FAILURES (COMPARE_BUCKETS + 1)
+#define COMPARE_COUNTS (COMPARE_BUCKETS + 2)
+
+///
+/// Computes the reference `R = op(A) * op(B)` and its error bound
+/// `Bound = |op(A)| * |op(B)|` with a naive, one work-item per element, product.
+///
+/// Same storage as the MatMul kernel (see `matrix/MatMul.cl`), `lda`, `ldb` and
+/// `ldc` being the padded leading dimensions.
+///
+/// @pre get_global_size(0, 1) >= (P, M)
+///
+__kernel void Reference(
+  IN unsigned int const M,
+  IN unsigned int const N,
+  IN unsigned int const P,
+  IN unsigned int const lda,
+  IN unsigned int const ldb,
+  IN unsigned int const ldc,
+  IN unsigned int const transA,
+  IN unsigned int const transB,
+
+  IN  __global Real const* A,
+  IN  __global Real const* B,
+  OUT __global Real      * R,
+  OUT __global Real      * Bound)
+{
+  size_t column = get_global_id(0);
+  size_t row = get_global_id(1);
+  if (row >= M || column >= P) return;
+
+  size_t AIndex = transA ? row : row * lda, AStep = transA ? lda : 1;
+  size_t BIndex = transB ? column * ldb : column, BStep = transB ? 1 : ldb;
+
+  Real sum = 0, sumAbs = 0;
+  for (size_t n = 0; n < N; ++n, AIndex += AStep, BIndex += BStep) {
+    Real product = A[AIndex] * B[BIndex];
+    sum += product;
+    sumAbs += fabs(product);
+  }
+
+  R[row * ldc + column] = sum;
+  Bound[row * ldc + column] = sumAbs;
+}
+
+///
+/// Maps the bits of `x` to an unsigned integer with the same order as `x`,
+/// so that the difference of two keys is the distance in ULPs.
+///
+static Unsigned OrderedKey(IN Real x) {
+  Unsigned bits = CONCAT(as_u, COMPARE_INT)(x);
+  Unsigned sign = (Unsigned) 1 << (sizeof(Unsigned) * 8 - 1);
+  return (bits & sign) ? ~bits : bits | sign;
+}
+
+///
+/// Compares C with the reference R and reduces, per work-group, the maximum
+/// absolute and relative errors, the ULP histogram (bucket 0 for 0 ULP, then
+/// `[2^(b-1), 2^b)` for the bucket b, the last one being open), the number of
+/// non-finite elements of C and of the elements out of `tolerance * Bound`.
+///
+/// Each work-group `g` writes `maxima[2g .. 2g+1]` and `counts[g * COMPARE_COUNTS ..]`,
+/// reduced afterwards by `CompareReduce`.
+///
+/// @pre get_local_size(0) == COMPARE_GROUP
+///
+__attribute__((reqd_work_group_size(COMPARE_GROUP, 1, 1)))
+__kernel void CompareBlocks(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned int const ld,
+  IN Real const tolerance,
+
+  IN  __global Real const* C,
+  IN  __global Real const* R,
+  IN  __global Real const* Bound,
+  OUT __global Real      * maxima,
+  OUT __global unsigned int* counts)
+{
+  __local Real absolutes[COMPARE_GROUP];
+  __local Real relatives[COMPARE_GROUP];
+  __local unsigned int localCounts[COMPARE_COUNTS];
+
+  size_t localId = get_local_id(0);
+  size_t group = get_group_id(0);
+
+  for (size_t index = localId; index < COMPARE_COUNTS; index += COMPARE_GROUP) {
+    localCounts[index] = 0u;
+  }
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  Real absolute = 0, relative = 0;
+  size_t size = (size_t) rows * columns;
+
+  // Grid-stride loop, the number of work-groups does not depend on the sizes.
+  for (size_t index = get_global_id(0); index < size; index += get_global_size(0)) {
+    size_t offset = (index / columns) * ld + index % columns;
+    Real c = C[offset], r = R[offset];
+
+    if (!isfinite(c)) {
+      atomic_inc(&localCounts[COMPARE_NONFINITE]);
+      continue;
+    }
+
+    Real error = fabs(c - r);
+    absolute = fmax(absolute, error);
+    relative = fmax(relative, error / fmax(fabs(r), (Real) FLT_MIN));
+
+    if (error > tolerance * Bound[offset]) {
+      atomic_inc(&localCounts[COMPARE_FAILURES]);
+    }
+
+    Unsigned keyC = OrderedKey(c), keyR = OrderedKey(r);
+    Unsigned ulps = keyC > keyR ? keyC - keyR : keyR - keyC;
+    unsigned int bucket = ulps == 0 ? 0u : (unsigned int) (sizeof(Unsigned) * 8 - clz(ulps));
+    atomic_inc(&localCounts[min(bucket, (unsigned int) COMPARE_BUCKETS - 1u)]);
+  }
+
+  absolutes[localId] = absolute;
+  relatives[localId] = relative;
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (size_t stride = COMPARE_GROUP / 2; stride > 0; stride >>= 1) {
+    if (localId < stride) {
+      absolutes[localId] = fmax(absolutes[localId], absolutes[localId + stride]);
+      relatives[localId] = fmax(relatives[localId], relatives[localId + stride]);
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (localId == 0) {
+    maxima[2 * group + 0] = absolutes[0];
+    maxima[2 * group + 1] = relatives[0];
+  }
+
+  for (size_t index = localId; index < COMPARE_COUNTS; index += COMPARE_GROUP) {
+    counts[group * COMPARE_COUNTS + index] = localCounts[index];
+  }
+}
+
+///
+/// Reduces the `groups` partial results of `CompareBlocks` in place, into
+/// `maxima[0 .. 1]` and `counts[0 .. COMPARE_COUNTS - 1]`.
+///
+/// @pre get_global_size(0) == get_local_size(0) == COMPARE_GROUP (a single work-group)
+///
+__attribute__((reqd_work_group_size(COMPARE_GROUP, 1, 1)))
+__kernel void CompareReduce(
+  IN unsigned int const groups,
+
+  INOUT __global Real* maxima,
+  INOUT __global unsigned int* counts)
+{
+  __local Real absolutes[COMPARE_GROUP];
+  __local Real relatives[COMPARE_GROUP];
+  __local unsigned int localCounts[COMPARE_COUNTS];
+
+  size_t localId = get_local_id(0);
+
+  Real absolute = 0, relative = 0;
+  for (size_t group = localId; group < groups; group += COMPARE_GROUP) {
+    absolute = fmax(absolute, maxima[2 * group + 0]);
+    relative = fmax(relative, maxima[2 * group + 1]);
+  }
+
+  absolutes[localId] = absolute;
+  relatives[localId] = relative;
+
+  // Few counters, one work-item per counter.
+  for (size_t index = localId; index < COMPARE_COUNTS; index += COMPARE_GROUP) {
+    unsigned int sum = 0u;
+    for (size_t group = 0; group < groups; ++group) {
+      sum += counts[group * COMPARE_COUNTS + index];
+    }
+
+    localCounts[index] = sum;
+  }
+
+  // Every partial result has been read before being overwritten below.
+  barrier(CLK_LOCAL_MEM_FENCE | CLK_GLOBAL_MEM_FENCE);
+
+  for (size_t stride = COMPARE_GROUP / 2; stride > 0; stride >>= 1) {
+    if (localId < stride) {
+      absolutes[localId] = fmax(absolutes[localId], absolutes[localId + stride]);
+      relatives[localId] = fmax(relatives[localId], relatives[localId + stride]);
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (localId == 0) {
+    maxima[0] = absolutes[0];
+    maxima[1] = relatives[0];
+  }
+
+  for (size_t index = localId; index < COMPARE_COUNTS; index += COMPARE_GROUP) {
+    counts[index] = localCounts[index];
+  }
+}
@@ -0,0 +1,112 @@
+#ifndef TR_MATRIX_COMPARE_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/Compare.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/Compare.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_COMPARE_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+#include "matrix/MatMulContext.h" // MatMulContext{}
+
+#ifndef TR_MATRIX_COMPARE_STATISTICS
+#define TR_MATRIX_COMPARE_STATISTICS
+
+/// Number of buckets of the ULP histogram.
+#define TR_COMPARE_BUCKETS 16u
+
+///
+/// Error statistics of C against a reference R, reduced on the device so that
+/// only this structure is read back instead of C.
+///
+typedef struct CompareStatistics {
+  /// Largest `|c - r|` and `|c - r| / |r|` over the finite elements of C.
+  double maxAbsoluteError, maxRelativeError;
+
+  /// Bucket 0 counts the exact elements, bucket `b` those in `[2^(b-1), 2^b)`
+  /// ULPs, the last bucket being open.
+  size_t histogram[TR_COMPARE_BUCKETS];
+
+  /// Number of NaN or infinite elements of C (not part of the above).
+  size_t nonFinite;
+
+  /// Number of elements with `|c - r| > tolerance * (|op(A)| * |op(B)|)`.
+  size_t failures;
+
+  /// Accepted error relative to the bound above: `2 N epsilon`.
+  double tolerance;
+} CompareStatistics;
+
+#endif // TR_MATRIX_COMPARE_STATISTICS
+
+#undef Compare
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Compare(suffix) TR_JOIN2(_, CompareFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Compare(suffix) TR_JOIN2(_, CompareDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// Computes the reference of `C = op(A) * op(B)` with a naive OpenCL kernel on
+/// the same device, then compares it with C (see `Compare(Buffers)`).
+///
+/// @returns `true` if the comparison could be run (see `statistics` for its outcome).
+///
+/// @pre `context` is not NULL and initialized.
+/// @pre `A`, `B` and `C` are the buffers of the matrix multiplication.
+/// @post May display error on stderr.
+///
+bool Compare(Reference)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  OUT CompareStatistics* statistics
+);
+
+///
+/// Computes the reference `R = op(A) * op(B)` and its error bound
+/// `|op(A)| * |op(B)|` into two new buffers stored as C, with a naive OpenCL
+/// kernel, so that several results can be compared with `Compare(Buffers)`.
+///
+/// @returns `true` on success, `false` otherwise (then no buffer is returned).
+///
+/// @post `R` and `bound` must be released with `clReleaseMemObject()`.
+///
+bool Compare(NewReference)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B,
+  OUT cl_mem* R, OUT cl_mem* bound
+);
+
+///
+/// Compares the device-resident C with the reference R (and its error bound),
+/// computed by any means on the device of `context`.
+///
+/// All buffers are stored as C, i.e. (M, P) with the padded leading dimension.
+/// Only the reduced statistics are read back.
+///
+/// @returns `true` if the comparison could be run (see `statistics` for its outcome).
+///
+bool Compare(Buffers)(
+  IN MatMulContext* context,
+  IN cl_mem C, IN cl_mem R, IN cl_mem bound,
+  OUT CompareStatistics* statistics
+);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_COMPARE_H
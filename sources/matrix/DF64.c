@@ -0,0 +1,264 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <limits.h> // UINT_MAX
+#include <math.h> // fabsl(), log2()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t
+#include <stdio.h> // printf(), snprintf()
+
+#include "common/HostArena.h" // HostArena_Create(), HostArena_Allocate(), HostArena_Fill()
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "common/parallel.h" // ParallelFor()
+#include "common/philox.h" // PhiloxElement(), PhiloxToDouble()
+#include "matrix/DF64.h" // Self
+#include "matrix/MatMulContext.h" // MatMulContext{}
+#include "matrix/RandomStreams.h" // TR_STREAM_A, TR_STREAM_B, TR_STREAM_SAMPLES
+
+/// Elements of C checked without `--cpu-check`.
+#define TR_DF64_SAMPLES 256u
+
+/// Relative error assumed of one double-single operation, with u = 2^-24 the
+/// unit roundoff of float: at most 3u^2 for the accurate addition of
+/// `matrix/DF64.cl` (two TwoSums, Joldes, Muller & Popescu 2017), and about 5u^2
+/// for the multiplication without the `a.y * b.y` term, i.e. about 2 * 4u^2 per
+/// multiply-add of the inner product (see the tolerance of `DF64_Run()`).
+#define TR_DF64_EPSILON 0x1p-46
+
+// Define matrixDF64Start and matrixDF64End.
+TR_OPENCL_IMPORT(matrix, DF64)
+
+typedef struct DF64FillTask {
+  size_t rows, columns, stride;
+  uint32_t stream;
+  uint64_t seed;
+  float* matrix; // (hi, lo) pairs.
+} DF64FillTask;
+
+///
+/// Fills the rows `[begin, end)` with the double-precision values of the
+/// stream, split into (hi, lo) pairs, and zeroes the padding.
+///
+static void FillRows(IN size_t begin, IN size_t end, INOUT void* data) {
+  DF64FillTask const* task = data;
+
+  for (size_t row = begin; row < end; ++row) {
+    float* line = task->matrix + 2u * row * task->stride;
+    for (size_t column = 0u; column < task->stride; ++column) {
+      double value = 0.0;
+      if (row < task->rows && column < task->columns) {
+        uint32_t second = 0u;
+        uint32_t first = PhiloxElement(task->seed, task->stream, (uint32_t) row, (uint32_t) column, &second);
+        value = PhiloxToDouble(first, second);
+      }
+
+      float high = (float) value;
+      line[2u * column + 0u] = high;
+      line[2u * column + 1u] = (float) (value - (double) high);
+    }
+  }
+}
+
+typedef struct DF64CheckTask {
+  MatMulContext const* context;
+  size_t M, N, P; // Padded.
+  float const *A, *B, *C;
+  bool sampled;
+  double* errors; // Per checked element.
+} DF64CheckTask;
+
+///
+/// Computes the errors of the checked elements `[begin, end)` of C against a
+/// long double reference from the same (hi, lo) operands, relative to
+/// `|op(A)| * |op(B)|`.
+///
+static void CheckElements(IN size_t begin, IN size_t end, INOUT void* data) {
+  DF64CheckTask const* task = data;
+  MatMulContext const* this = task->context;
+
+  size_t LDA = this->transA ? task->M : task->N;
+  size_t LDB = this->transB ? task->N : task->P;
+
+  for (size_t index = begin; index < end; ++index) {
+    size_t row = index / this->P, column = index % this->P;
+    if (task->sampled) {
+      uint32_t second = 0u;
+      row = PhiloxElement(this->seed, TR_STREAM_SAMPLES, (uint32_t) index, 0u, &second) % this->M;
+      column = second % this->P;
+    }
+
+    long double reference = 0.0L, magnitude = 0.0L;
+    for (size_t n = 0u; n < this->N; ++n) {
+      size_t a = this->transA ? n * LDA + row : row * LDA + n;
+      size_t b = this->transB ? column * LDB + n : n * LDB + column;
+      long double x = (long double) task->A[2u * a] + (long double) task->A[2u * a + 1u];
+      long double y = (long double) task->B[2u * b] + (long double) task->B[2u * b + 1u];
+      reference += x * y;
+      magnitude += fabsl(x * y);
+    }
+
+    size_t c = row * task->P + column;
+    long double value = (long double) task->C[2u * c] + (long double) task->C[2u * c + 1u];
+    task->errors[index] = magnitude > 0.0L ? (double) (fabsl(value - reference) / magnitude) : (double) fabsl(value - reference);
+  }
+}
+
+bool DF64_Run(IN MatMulContext* this) {
+  assert(this != NULL && this->df64);
+
+  cl_int error;
+  bool success = false;
+  cl_context context = this->openCl.context;
+  cl_command_queue queue = this->openCl.queue;
+  cl_kernel kernel = NULL;
+  cl_mem ABuffer = NULL, BBuffer = NULL, CBuffer = NULL;
+  cl_event event = NULL;
+  HostArena arena = { 0 };
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+  if (M > UINT_MAX || N > UINT_MAX || P > UINT_MAX) {
+    TR_ERROR("The matrix sizes (%zu, %zu, %zu) overflow the kernel arguments.", M, N, P);
+    return false;
+  }
+
+  size_t pair = 2u * sizeof(float);
+  size_t ABytes = pair * M * N, BBytes = pair * N * P, CBytes = pair * M * P;
+  size_t checked = this->cpuCheck ? this->M * this->P : TR_DF64_SAMPLES;
+
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options), "-DDF64_BLOCKSIZE=%zu%s%s"
+    , this->blockSize
+    , this->transA ? " -DTRANS_A" : ""
+    , this->transB ? " -DTRANS_B" : ""
+  );
+
+  TR_MATMUL_LOG(this, 2, "Build Options: %s", options);
+  kernel = ProgramCache_GetKernel(&this->openCl, matrixDF64Start, matrixDF64End, options, "MatMulDF64");
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(MatMulDF64) failed");
+    goto out;
+  }
+
+  size_t arenaBytes = ABytes + BBytes + CBytes + sizeof(double) * checked + 4u * TR_HOSTARENA_ALIGNMENT;
+  TR_MATMUL_LOG(this, 1, "Reserve the Host Arena (%zu bytes).", arenaBytes);
+  if (!HostArena_Create(arenaBytes, this->hugePages, &arena)) {
+    TR_ERROR("HostArena_Create() failed");
+    goto out;
+  }
+
+  float* A = HostArena_Allocate(&arena, ABytes);
+  float* B = HostArena_Allocate(&arena, BBytes);
+  float* C = HostArena_Allocate(&arena, CBytes);
+  double* errors = HostArena_Allocate(&arena, sizeof(double) * checked);
+  if (A == NULL || B == NULL || C == NULL || errors == NULL) {
+    goto out;
+  }
+
+  // A is stored as (M, N), or (N, M) if transposed, same for B with (N, P).
+  TR_MATMUL_LOG(this, 1, "Initialize Host Matrixes (double-single pairs).");
+  DF64FillTask ATask = {
+    .rows = this->transA ? this->N : this->M, .columns = this->transA ? this->M : this->N,
+    .stride = this->transA ? M : N, .stream = TR_STREAM_A, .seed = this->seed, .matrix = A,
+  };
+
+  DF64FillTask BTask = {
+    .rows = this->transB ? this->P : this->N, .columns = this->transB ? this->N : this->P,
+    .stride = this->transB ? N : P, .stream = TR_STREAM_B, .seed = this->seed, .matrix = B,
+  };
+
+  HostArena_Fill(&arena, this->transA ? N : M, FillRows, &ATask);
+  HostArena_Fill(&arena, this->transB ? P : N, FillRows, &BTask);
+  HostArena_Touch(&arena, C, CBytes);
+
+  TR_MATMUL_LOG(this, 1, "Create OpenCL Buffers.");
+  ABuffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, ABytes, A, &error);
+  if (error != CL_SUCCESS || ABuffer == NULL) { TR_FAILED("clCreateBuffer(A)", error); goto out; }
+  BBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, BBytes, B, &error);
+  if (error != CL_SUCCESS || BBuffer == NULL) { TR_FAILED("clCreateBuffer(B)", error); goto out; }
+  CBuffer = clCreateBuffer(context, CL_MEM_WRITE_ONLY, CBytes, NULL, &error);
+  if (error != CL_SUCCESS || CBuffer == NULL) { TR_FAILED("clCreateBuffer(C)", error); goto out; }
+
+  cl_uint arguments[3] = { (cl_uint) M, (cl_uint) N, (cl_uint) P };
+  error  = clSetKernelArg(kernel, 0, sizeof(cl_uint), &arguments[0]);
+  error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &arguments[1]);
+  error |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &arguments[2]);
+  error |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &ABuffer);
+  error |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &BBuffer);
+  error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &CBuffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(MatMulDF64)", error);
+    goto out;
+  }
+
+  TR_MATMUL_LOG(this, 1, "Enqueue OpenCL Kernel.");
+  size_t globalSize[2] = { P, M }; // (x, y) or (columns, rows)
+  size_t localSize[2] = { this->blockSize, this->blockSize };
+  error = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, globalSize, localSize, 0, NULL, &event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(MatMulDF64)", error);
+    goto out;
+  }
+
+  TR_MATMUL_LOG(this, 1, "Read OpenCL Buffer.");
+  error = clEnqueueReadBuffer(queue, CBuffer, CL_TRUE, 0u, CBytes, C, 1, &event, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueReadBuffer(C)", error);
+    goto out;
+  }
+
+  cl_ulong start = 0u, end = 0u;
+  error  = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo()", error);
+  }
+
+  // Only the useful (unpadded) operations are taken into account.
+  double nanoseconds = (double) (end - start);
+  double operations = 2.0 * (double) this->M * (double) this->N * (double) this->P;
+
+  printf(
+    TAB0 "Matrix Multiplication Results:" LF
+    TAB1 "Kernel.Time............: %.3f ms" LF
+    TAB1 "Performance............: %.3f GFLOP/s (emulated double-precision)" LF
+    , nanoseconds * 1e-6
+    , nanoseconds > 0.0 ? operations / nanoseconds : 0.0
+  );
+
+  TR_MATMUL_LOG(this, 1, "Check Result against an Extended-Precision Reference.");
+  DF64CheckTask check = {
+    .context = this, .M = M, .N = N, .P = P,
+    .A = A, .B = B, .C = C, .sampled = !this->cpuCheck, .errors = errors,
+  };
+
+  ParallelFor(checked, CheckElements, &check);
+
+  double maxError = 0.0;
+  for (size_t index = 0u; index < checked; ++index) {
+    maxError = errors[index] > maxError ? errors[index] : maxError;
+  }
+
+  double tolerance = 2.0 * (double) this->N * TR_DF64_EPSILON;
+  success = maxError <= tolerance;
+  printf(
+    TAB1 "DF64.Check.............: %s (%zu %s elements)" LF
+    TAB1 "Max.Relative.Error.....: %g of |A|*|B| (%.1f bits, tolerance %g)" LFLF
+    , success ? "Passed" : "Failed", checked, this->cpuCheck ? "checked" : "sampled"
+    , maxError, maxError > 0.0 ? -log2(maxError) : 0.0, tolerance
+  );
+
+out:
+  if (event != NULL && CL_SUCCESS != (error = clReleaseEvent(event))) { TR_FAILED("clReleaseEvent()", error); }
+  if (kernel != NULL && CL_SUCCESS != (error = clReleaseKernel(kernel))) { TR_FAILED("clReleaseKernel()", error); }
+  if (CBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(CBuffer))) { TR_FAILED("clReleaseMemObject(C)", error); }
+  if (BBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(BBuffer))) { TR_FAILED("clReleaseMemObject(B)", error); }
+  if (ABuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(ABuffer))) { TR_FAILED("clReleaseMemObject(A)", error); }
+
+  if (!HostArena_Release(&arena)) { TR_ERROR("HostArena_Release() failed"); }
+  return success;
+}
@@ -0,0 +1,154 @@
+#ifndef DF64_BLOCKSIZE
+#error DF64_BLOCKSIZE is undefined.
+#endif
+
+// The error-free transformations below rely on every operation being rounded
+// on its own, i.e. never contracted into a fused multiply-add.
+#pragma OPENCL FP_CONTRACT OFF
+
+#define IN
+#define OUT
+
+///
+/// A double-single value: `x` is the float nearest to the value and `y` the
+/// (float) rest, `x + y` having about 48 bits of mantissa.
+///
+typedef float2 DF64;
+
+///
+/// Exact sum `s + e = a + b` (Knuth).
+///
+static DF64 TwoSum(IN float const a, IN float const b) {
+  float const s = a + b;
+  float const v = s - a;
+  float const e = (a - (s - v)) + (b - v);
+  return (DF64) (s, e);
+}
+
+///
+/// Exact sum `s + e = a + b` when `|a| >= |b|` (Dekker).
+///
+static DF64 QuickTwoSum(IN float const a, IN float const b) {
+  float const s = a + b;
+  float const e = b - (s - a);
+  return (DF64) (s, e);
+}
+
+///
+/// Exact product `p + e = a * b`, the rounding error coming from `fma()`.
+///
+static DF64 TwoProd(IN float const a, IN float const b) {
+  float const p = a * b;
+  float const e = fma(a, b, -p);
+  return (DF64) (p, e);
+}
+
+static DF64 Add(IN DF64 const a, IN DF64 const b) {
+  DF64 s = TwoSum(a.x, b.x);
+  DF64 const t = TwoSum(a.y, b.y);
+  s.y += t.x;
+  s = QuickTwoSum(s.x, s.y);
+  s.y += t.y;
+  return QuickTwoSum(s.x, s.y);
+}
+
+static DF64 Multiply(IN DF64 const a, IN DF64 const b) {
+  DF64 p = TwoProd(a.x, b.x);
+  p.y = fma(a.x, b.y, fma(a.y, b.x, p.y));
+  return QuickTwoSum(p.x, p.y);
+}
+
+///
+/// Computes `C = op(A) * op(B)` in double-single arithmetic, with the same
+/// storage, work-groups and local tiles as the MatMul kernel (see
+/// `matrix/MatMul.cl`), `-DTRANS_A` and `-DTRANS_B` included.
+///
+/// @pre get_global_size(0, 1) is (P, M), (x, y) or (columns, rows)
+///
+__attribute__((reqd_work_group_size(DF64_BLOCKSIZE, DF64_BLOCKSIZE, 1)))
+__kernel void MatMulDF64(
+  IN unsigned int const M,
+  IN unsigned int const N,
+  IN unsigned int const P,
+
+  IN  __global DF64 const* A,
+  IN  __global DF64 const* B,
+  OUT __global DF64      * C)
+{
+#ifndef TRANS_A
+  size_t const LDA = N;
+#else // TRANS_A
+  size_t const LDA = M;
+#endif // TRANS_A
+
+#ifndef TRANS_B
+  size_t const LDB = P;
+#else // TRANS_B
+  size_t const LDB = N;
+#endif // TRANS_B
+
+  size_t const LDC = P;
+
+  __local DF64 ALocal[DF64_BLOCKSIZE][DF64_BLOCKSIZE];
+  __local DF64 BLocal[DF64_BLOCKSIZE][DF64_BLOCKSIZE];
+
+  size_t xGlobal = get_global_id(0); // [0..P] (Column)
+  size_t yGlobal = get_global_id(1); // [0..M] (Row)
+
+  size_t xLocal = get_local_id(0);
+  size_t yLocal = get_local_id(1);
+
+  size_t xBlock = get_group_id(0);
+  size_t yBlock = get_group_id(1);
+
+#ifndef TRANS_A
+  size_t ABase = yBlock * DF64_BLOCKSIZE * LDA;
+  size_t AStep = DF64_BLOCKSIZE;
+#else // TRANS_A
+  size_t ABase = yBlock * DF64_BLOCKSIZE;
+  size_t AStep = DF64_BLOCKSIZE * LDA;
+#endif // TRANS_A
+
+#ifndef TRANS_B
+  size_t BBase = xBlock * DF64_BLOCKSIZE;
+  size_t BStep = DF64_BLOCKSIZE * LDB;
+#else // TRANS_B
+  size_t BBase = xBlock * DF64_BLOCKSIZE * LDB;
+  size_t BStep = DF64_BLOCKSIZE;
+#endif // TRANS_B
+
+  size_t const AOffset = yLocal * LDA + xLocal;
+  size_t const BOffset = yLocal * LDB + xLocal;
+
+  DF64 accumulator = (DF64) (0.0f, 0.0f);
+
+  size_t const numberOfBlocks = N / DF64_BLOCKSIZE;
+  for (size_t nBlock = 0; nBlock < numberOfBlocks; ++nBlock) {
+
+#ifndef TRANS_A
+    ALocal[yLocal][xLocal] = A[ABase + AOffset];
+#else // TRANS_A
+    ALocal[xLocal][yLocal] = A[ABase + AOffset]; // Transpose.
+#endif // TRANS_A
+
+#ifndef TRANS_B
+    BLocal[xLocal][yLocal] = B[BBase + BOffset]; // Transpose.
+#else // TRANS_B
+    BLocal[yLocal][xLocal] = B[BBase + BOffset];
+#endif // TRANS_B
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    #pragma unroll
+    for (size_t nLocal = 0; nLocal < DF64_BLOCKSIZE; ++nLocal) {
+      accumulator = Add(accumulator, Multiply(ALocal[yLocal][nLocal], BLocal[xLocal][nLocal]));
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    ABase += AStep;
+    BBase += BStep;
+  }
+
+  C[yGlobal * LDC + xGlobal] = accumulator;
+}
@@ -0,0 +1,24 @@
+#ifndef TR_MATRIX_DF64_H
+#define TR_MATRIX_DF64_H
+
+#include <stdbool.h> // bool, true, false
+
+#include "common/helper.h" // IN, OUT, INOUT
+#include "matrix/MatMulContext.h" // MatMulContext{}
+
+///
+/// Runs `C = op(A) * op(B)` in emulated double-precision (`--precision DF64`):
+/// the operands are generated in double on the host (the same values as the
+/// double-precision run), stored as (hi, lo) pairs of floats, and multiplied
+/// with the error-free transformations of `matrix/DF64.cl`, then the result is
+/// checked on the host against an extended-precision reference (a sample of
+/// the elements of C, or all of them with `--cpu-check`).
+///
+/// @returns `true` on success and when the check passes, `false` otherwise.
+///
+/// @pre `context` is not NULL and initialized with `df64`.
+/// @post Displays on stdout, may display error on stderr.
+///
+bool DF64_Run(IN MatMulContext* context);
+
+#endif // TR_MATRIX_DF64_H
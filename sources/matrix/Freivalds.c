@@ -0,0 +1,363 @@
+#ifndef TR_MATRIX_FREIVALDS_C
+#ifndef TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+#include <math.h> // fabs(), ldexp(), INFINITY
+#include <stdbool.h> // bool, true, false
+#include <stdint.h> // uint32_t
+#include <stdio.h> // fprintf()
+
+#include "common/HostArena.h" // HostArena_Allocate()
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "common/parallel.h" // ParallelFor()
+#include "common/philox.h" // PhiloxElement()
+#include "matrix/RandomStreams.h" // TR_STREAM_FREIVALDS
+
+#define MATVECTASK(TYPE) TR_JOIN2(_, MatVecTask, TYPE)
+#define MATVECROWS(TYPE) TR_JOIN2(_, MatVecRows, TYPE)
+#define MATTVECCOLUMNS(TYPE) TR_JOIN2(_, MatTVecColumns, TYPE)
+#define MATVEC(TYPE) TR_JOIN2(_, MatVec, TYPE)
+#define RANDOMVECTOR(TYPE) TR_JOIN2(_, RandomVector, TYPE)
+#define COMPARE(TYPE) TR_JOIN2(_, Compare, TYPE)
+#define INITIALIZERESULT(TYPE) TR_JOIN2(_, InitializeResult, TYPE)
+
+/// Work-group size of the MatVec kernel (halved down to the device limit).
+#define TR_FREIVALDS_GROUP 128u
+
+// Define matrixFreivaldsStart and matrixFreivaldsEnd.
+TR_OPENCL_IMPORT(matrix, Freivalds)
+
+///
+/// Enqueues `y = op(X) * x` (and the absolute values) with the MatVec kernel,
+/// one work-group of `group` work-items per row, if X is not transposed or the
+/// MatTVec kernel, one work-item per column, otherwise.
+///
+/// @param shape { rows, columns, ld } of the stored matrix X.
+///
+static bool EnqueueMatVec(
+  IN cl_command_queue queue, IN cl_kernel matVec, IN cl_kernel matTVec, IN bool transposed,
+  IN size_t group, IN size_t const shape[3],
+  IN cl_mem X, IN cl_mem x, IN cl_mem xAbs, IN cl_mem y, IN cl_mem yAbs)
+{
+  cl_kernel kernel = transposed ? matTVec : matVec;
+  cl_uint arguments[3] = { (cl_uint) shape[0], (cl_uint) shape[1], (cl_uint) shape[2] };
+
+  cl_int error = CL_SUCCESS;
+  error |= clSetKernelArg(kernel, 0, sizeof(cl_uint), &arguments[0]);
+  error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &arguments[1]);
+  error |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &arguments[2]);
+  error |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &X);
+  error |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &x);
+  error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &xAbs);
+  error |= clSetKernelArg(kernel, 6, sizeof(cl_mem), &y);
+  error |= clSetKernelArg(kernel, 7, sizeof(cl_mem), &yAbs);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(MatVec)", error);
+    return false;
+  }
+
+  size_t length = transposed ? shape[1] : shape[0] * group;
+  error = clEnqueueNDRangeKernel(queue, kernel, 1, NULL, &length, transposed ? NULL : &group, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(MatVec)", error);
+    return false;
+  }
+
+  return true;
+}
+
+#define TR_MATRIX_PRECISION float
+#include "matrix/Freivalds.c"
+#undef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION double
+#  include "matrix/Freivalds.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_FREIVALDS_C
+#else // TR_MATRIX_PRECISION
+
+#include "matrix/Freivalds.h" // Freivalds(), FreivaldsResult{}
+
+#undef TR_EPSILON
+#define TR_EPSILON _Generic((TR_MATRIX_PRECISION) 0, float: FLT_EPSILON, double: DBL_EPSILON)
+
+///
+/// Initializes the result of `trials` trials for the given sizes.
+///
+static void INITIALIZERESULT(TR_MATRIX_PRECISION)(IN size_t trials, IN size_t N, IN size_t P, OUT FreivaldsResult* result) {
+  *result = (FreivaldsResult) {
+    .trials = trials,
+    .failures = 0u,
+    .maxError = 0.0,
+    .tolerance = 2.0 * (double) (N + P + 2u) * TR_EPSILON,
+    .confidence = 1.0 - ldexp(1.0, -(int) (trials < 1024u ? trials : 1024u)),
+  };
+}
+
+typedef struct MATVECTASK(TR_MATRIX_PRECISION) {
+  size_t rows, columns, ld;
+  TR_MATRIX_PRECISION const* X;
+  TR_MATRIX_PRECISION const* x;
+  TR_MATRIX_PRECISION const* xAbs;
+  TR_MATRIX_PRECISION* y;
+  TR_MATRIX_PRECISION* yAbs;
+} MATVECTASK(TR_MATRIX_PRECISION);
+
+static void MATVECROWS(TR_MATRIX_PRECISION)(IN size_t begin, IN size_t end, INOUT void* data) {
+  MATVECTASK(TR_MATRIX_PRECISION) const* task = data;
+
+  for (size_t row = begin; row < end; ++row) {
+    TR_MATRIX_PRECISION const* line = task->X + row * task->ld;
+    TR_MATRIX_PRECISION sum = 0, sumAbs = 0;
+    for (size_t column = 0u; column < task->columns; ++column) {
+      sum += line[column] * task->x[column];
+      sumAbs += (TR_MATRIX_PRECISION) fabs(line[column]) * task->xAbs[column];
+    }
+
+    task->y[row] = sum;
+    task->yAbs[row] = sumAbs;
+  }
+}
+
+static void MATTVECCOLUMNS(TR_MATRIX_PRECISION)(IN size_t begin, IN size_t end, INOUT void* data) {
+  MATVECTASK(TR_MATRIX_PRECISION) const* task = data;
+
+  for (size_t column = begin; column < end; ++column) {
+    task->y[column] = task->yAbs[column] = 0;
+  }
+
+  // Row by row to read contiguous memory.
+  for (size_t row = 0u; row < task->rows; ++row) {
+    TR_MATRIX_PRECISION const* line = task->X + row * task->ld;
+    for (size_t column = begin; column < end; ++column) {
+      task->y[column] += line[column] * task->x[row];
+      task->yAbs[column] += (TR_MATRIX_PRECISION) fabs(line[column]) * task->xAbs[row];
+    }
+  }
+}
+
+///
+/// Computes `y = op(X) * x` on the host with every thread.
+///
+/// @param shape { rows, columns, ld } of the stored matrix X.
+///
+static void MATVEC(TR_MATRIX_PRECISION)(
+  IN bool transposed, IN size_t const shape[3],
+  IN TR_MATRIX_PRECISION const* X,
+  IN TR_MATRIX_PRECISION const* x, IN TR_MATRIX_PRECISION const* xAbs,
+  OUT TR_MATRIX_PRECISION* y, OUT TR_MATRIX_PRECISION* yAbs)
+{
+  MATVECTASK(TR_MATRIX_PRECISION) task = {
+    .rows = shape[0], .columns = shape[1], .ld = shape[2],
+    .X = X, .x = x, .xAbs = xAbs, .y = y, .yAbs = yAbs,
+  };
+
+  if (transposed) ParallelFor(shape[1], MATTVECCOLUMNS(TR_MATRIX_PRECISION), &task);
+  else            ParallelFor(shape[0], MATVECROWS(TR_MATRIX_PRECISION), &task);
+}
+
+///
+/// Generates the random vector `r` in {0, 1}^length of the given trial.
+///
+static void RANDOMVECTOR(TR_MATRIX_PRECISION)(
+  IN size_t seed, IN size_t trial, IN size_t length,
+  OUT TR_MATRIX_PRECISION* r)
+{
+  for (size_t index = 0u; index < length; ++index) {
+    uint32_t second = 0u;
+    uint32_t bits = PhiloxElement(seed, TR_STREAM_FREIVALDS + (uint32_t) trial, 0u, (uint32_t) index, &second);
+    r[index] = (TR_MATRIX_PRECISION) (bits >> 31);
+  }
+}
+
+///
+/// Compares `v = A(Br)` with `w = Cr` given their absolute bounds and updates the result.
+///
+static void COMPARE(TR_MATRIX_PRECISION)(
+  IN size_t rows,
+  IN TR_MATRIX_PRECISION const* v, IN TR_MATRIX_PRECISION const* vAbs,
+  IN TR_MATRIX_PRECISION const* w, IN TR_MATRIX_PRECISION const* wAbs,
+  INOUT FreivaldsResult* result)
+{
+  bool failed = false;
+  for (size_t row = 0u; row < rows; ++row) {
+    double difference = fabs((double) v[row] - (double) w[row]);
+    double magnitude = (double) vAbs[row] + (double) wAbs[row];
+    double error = difference == 0.0 ? 0.0 : magnitude > 0.0 ? difference / magnitude : INFINITY;
+    if (!(error <= result->tolerance)) { failed = true; } // NaN fails too.
+    if (!(error <= result->maxError)) { result->maxError = error; }
+  }
+
+  result->failures += failed ? 1u : 0u;
+}
+
+bool Freivalds(Host)(
+  IN MatMulContext const* this,
+  IN TR_MATRIX_PRECISION const* A,
+  IN TR_MATRIX_PRECISION const* B,
+  IN TR_MATRIX_PRECISION const* C,
+  OUT FreivaldsResult* result)
+{
+  assert(this != NULL && result != NULL);
+  assert(A != NULL && B != NULL && C != NULL);
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  INITIALIZERESULT(TR_MATRIX_PRECISION)(this->freivalds, this->N, this->P, result);
+
+  // One allocation for r (P), u and |u| (N), v, |v|, w and |w| (M).
+  size_t mark = HostArena_Mark(this->arena);
+  TR_MATRIX_PRECISION* r = HostArena_Allocate(this->arena, sizeof(TR_MATRIX_PRECISION) * (P + 2u * N + 4u * M));
+  if (r == NULL) {
+    TR_ERROR("HostArena_Allocate(r) failed");
+    return false;
+  }
+
+  TR_MATRIX_PRECISION* u = r + P, *uAbs = u + N;
+  TR_MATRIX_PRECISION* v = uAbs + N, *vAbs = v + M;
+  TR_MATRIX_PRECISION* w = vAbs + M, *wAbs = w + M;
+
+  // { rows, columns, ld } of the stored matrixes.
+  size_t const AShape[3] = { this->transA ? this->N : this->M, this->transA ? this->M : this->N, this->transA ? M : N };
+  size_t const BShape[3] = { this->transB ? this->P : this->N, this->transB ? this->N : this->P, this->transB ? N : P };
+  size_t const CShape[3] = { this->M, this->P, P };
+
+  for (size_t trial = 0u; trial < this->freivalds; ++trial) {
+    RANDOMVECTOR(TR_MATRIX_PRECISION)(this->seed, trial, this->P, r);
+    MATVEC(TR_MATRIX_PRECISION)(this->transB, BShape, B, r, r, u, uAbs); // |r| = r
+    MATVEC(TR_MATRIX_PRECISION)(this->transA, AShape, A, u, uAbs, v, vAbs);
+    MATVEC(TR_MATRIX_PRECISION)(false, CShape, C, r, r, w, wAbs);
+    COMPARE(TR_MATRIX_PRECISION)(this->M, v, vAbs, w, wAbs, result);
+  }
+
+  HostArena_Reset(this->arena, mark);
+  return true;
+}
+
+bool Freivalds(Device)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  OUT FreivaldsResult* result)
+{
+  assert(this != NULL && result != NULL);
+  assert(A != NULL && B != NULL && C != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_context context = this->openCl.context;
+  cl_command_queue queue = this->openCl.queue;
+  cl_kernel matVec = NULL, matTVec = NULL;
+  cl_mem buffers[7] = { NULL }; // r, u, |u|, v, |v|, w, |w|
+  TR_MATRIX_PRECISION* host = NULL;
+  size_t mark = HostArena_Mark(this->arena);
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  INITIALIZERESULT(TR_MATRIX_PRECISION)(this->freivalds, this->N, this->P, result);
+
+  size_t group = TR_FREIVALDS_GROUP;
+  size_t limit = this->openCl.capabilities.maxWorkGroupSize;
+  while (limit != 0u && group > limit && group > 1u) { group /= 2u; }
+
+  char options[64] = { 0x0 };
+  snprintf(options, sizeof(options), "-DFREIVALDS_REAL=%s -DFREIVALDS_GROUP=%zu", TR_STRINGIFY(TR_MATRIX_PRECISION), group);
+  matVec = ProgramCache_GetKernel(&this->openCl, matrixFreivaldsStart, matrixFreivaldsEnd, options, "MatVec");
+  matTVec = ProgramCache_GetKernel(&this->openCl, matrixFreivaldsStart, matrixFreivaldsEnd, options, "MatTVec");
+  if (matVec == NULL || matTVec == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(MatVec, MatTVec) failed");
+    goto out;
+  }
+
+  // Host side: r (P) then v, |v|, w and |w| (M).
+  host = HostArena_Allocate(this->arena, sizeof(TR_MATRIX_PRECISION) * (P + 4u * M));
+  if (host == NULL) {
+    TR_ERROR("HostArena_Allocate(r, v, w) failed");
+    goto out;
+  }
+
+  size_t const lengths[7] = { P, N, N, M, M, M, M };
+  for (size_t index = 0u; index < 7u; ++index) {
+    buffers[index] = clCreateBuffer(context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * lengths[index], NULL, &error);
+    if (error != CL_SUCCESS || buffers[index] == NULL) {
+      TR_FAILED("clCreateBuffer(Freivalds)", error);
+      goto out;
+    }
+  }
+
+  // { rows, columns, ld } of the stored matrixes.
+  size_t const AShape[3] = { this->transA ? this->N : this->M, this->transA ? this->M : this->N, this->transA ? M : N };
+  size_t const BShape[3] = { this->transB ? this->P : this->N, this->transB ? this->N : this->P, this->transB ? N : P };
+  size_t const CShape[3] = { this->M, this->P, P };
+
+  TR_MATRIX_PRECISION* r = host;
+  TR_MATRIX_PRECISION* v = host + P, *vAbs = v + M, *w = vAbs + M, *wAbs = w + M;
+
+  for (size_t trial = 0u; trial < this->freivalds; ++trial) {
+    RANDOMVECTOR(TR_MATRIX_PRECISION)(this->seed, trial, this->P, r);
+
+    error = clEnqueueWriteBuffer(queue, buffers[0], CL_FALSE, 0u, sizeof(TR_MATRIX_PRECISION) * this->P, r, 0, NULL, NULL);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clEnqueueWriteBuffer(r)", error);
+      goto out;
+    }
+
+    // u = op(B) r, v = op(A) u, w = C r (the in-order queue chains them).
+    // With r in {0, 1}, |r| = r.
+    if (!EnqueueMatVec(queue, matVec, matTVec, this->transB, group, BShape, B, buffers[0], buffers[0], buffers[1], buffers[2])
+      || !EnqueueMatVec(queue, matVec, matTVec, this->transA, group, AShape, A, buffers[1], buffers[2], buffers[3], buffers[4])
+      || !EnqueueMatVec(queue, matVec, matTVec, false, group, CShape, C, buffers[0], buffers[0], buffers[5], buffers[6])) {
+      goto out;
+    }
+
+    TR_MATRIX_PRECISION* outputs[4] = { v, vAbs, w, wAbs };
+    for (size_t index = 0u; index < 4u; ++index) {
+      error = clEnqueueReadBuffer(queue, buffers[3u + index], CL_FALSE,
+        0u, sizeof(TR_MATRIX_PRECISION) * this->M, outputs[index], 0, NULL, NULL);
+      if (error != CL_SUCCESS) {
+        TR_FAILED("clEnqueueReadBuffer(Freivalds)", error);
+        goto out;
+      }
+    }
+
+    // A failed kernel or read must not be compared as a result.
+    error = clFinish(queue);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clFinish(Freivalds)", error);
+      goto out;
+    }
+
+    COMPARE(TR_MATRIX_PRECISION)(this->M, v, vAbs, w, wAbs, result);
+  }
+
+  success = true;
+
+out:
+  // Pending commands use the host memory.
+  if (queue != NULL && CL_SUCCESS != (error = clFinish(queue))) {
+    TR_FAILED("clFinish(Freivalds)", error);
+    success = false;
+  }
+
+  for (size_t index = 0u; index < 7u; ++index) {
+    if (buffers[index] != NULL && CL_SUCCESS != (error = clReleaseMemObject(buffers[index]))) {
+      TR_FAILED("clReleaseMemObject(Freivalds)", error);
+    }
+  }
+
+  if (matVec != NULL) { clReleaseKernel(matVec); }
+  if (matTVec != NULL) { clReleaseKernel(matTVec); }
+  HostArena_Reset(this->arena, mark);
+
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_FREIVALDS_C
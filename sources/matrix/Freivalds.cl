@@ -0,0 +1,110 @@
+#ifndef FREIVALDS_REAL
+#define FREIVALDS_REAL float
+#endif
+
+#ifndef FREIVALDS_GROUP // Work-group size of MatVec, must be a power of 2.
+#define FREIVALDS_GROUP 128
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+
+typedef FREIVALDS_REAL Real;
+
+///
+/// Computes `y = X * x` and `yAbs = |X| * xAbs` (the latter bounds the
+/// rounding errors) for a row-major `(rows, columns)` matrix X.
+///
+/// One work-group per row, as `GemvRows` (see `matrix/Gemv.cl`): the work-items
+/// of a group read consecutive elements of the row (coalesced), then their
+/// partial dot products are reduced in local memory.
+///
+/// @pre get_local_size(0) is FREIVALDS_GROUP.
+/// @pre get_num_groups(0) is `rows`.
+///
+__attribute__((reqd_work_group_size(FREIVALDS_GROUP, 1, 1)))
+__kernel void MatVec(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned int const ld,
+
+  IN  __global Real const* X,
+  IN  __global Real const* x,
+  IN  __global Real const* xAbs,
+  OUT __global Real      * y,
+  OUT __global Real      * yAbs)
+{
+  __local Real partial[FREIVALDS_GROUP];
+  __local Real partialAbs[FREIVALDS_GROUP];
+
+  size_t const row = get_group_id(0);
+  size_t const local = get_local_id(0);
+  __global Real const* line = X + row * ld;
+
+  Real sum = 0, sumAbs = 0;
+  for (size_t column = local; column < columns; column += FREIVALDS_GROUP) {
+    Real value = line[column];
+    sum += value * x[column];
+    sumAbs += fabs(value) * xAbs[column];
+  }
+
+  partial[local] = sum;
+  partialAbs[local] = sumAbs;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (size_t stride = FREIVALDS_GROUP / 2; stride > 0u; stride /= 2u) {
+    if (local < stride) {
+      partial[local] += partial[local + stride];
+      partialAbs[local] += partialAbs[local + stride];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  (void) rows; // Given by the number of work-groups.
+
+  if (local == 0u) {
+    y[row] = partial[0];
+    yAbs[row] = partialAbs[0];
+  }
+}
+
+///
+/// Computes `y = X^T * x` and `yAbs = |X^T| * xAbs` for a row-major `(rows, columns)`
+/// matrix X, i.e. y has `columns` elements.
+///
+/// One work-item per column, consecutive work-items read consecutive addresses.
+///
+/// @pre get_global_size(0) >= columns
+///
+__kernel void MatTVec(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned int const ld,
+
+  IN  __global Real const* X,
+  IN  __global Real const* x,
+  IN  __global Real const* xAbs,
+  OUT __global Real      * y,
+  OUT __global Real      * yAbs)
+{
+  size_t column = get_global_id(0);
+  if (column >= columns) return;
+
+  Real sum = 0, sumAbs = 0;
+
+  for (size_t row = 0; row < rows; ++row) {
+    Real value = X[row * ld + column];
+    sum += value * x[row];
+    sumAbs += fabs(value) * xAbs[row];
+  }
+
+  y[column] = sum;
+  yAbs[column] = sumAbs;
+}
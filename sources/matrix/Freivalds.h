@@ -0,0 +1,91 @@
+#ifndef TR_MATRIX_FREIVALDS_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/Freivalds.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/Freivalds.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_FREIVALDS_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+#include "matrix/MatMulContext.h" // MatMulContext{}
+
+#ifndef TR_MATRIX_FREIVALDS_RESULT
+#define TR_MATRIX_FREIVALDS_RESULT
+
+///
+/// Outcome of a Freivalds verification of `C = op(A) * op(B)`.
+///
+/// Each trial checks `op(A) * (op(B) * r) == C * r` for a random vector `r` in
+/// {0, 1}^P, in O(n²) instead of the O(n³) of a full recomputation. A wrong C
+/// passes a trial with a probability of at most 1/2, thus at most 2^-k for k
+/// independent trials.
+///
+typedef struct FreivaldsResult {
+  /// Number of trials (k) and how many of them failed.
+  size_t trials, failures;
+
+  /// Largest `|A(Br) - Cr| / (|A||B|r + |C|r)` over every row and trial.
+  double maxError;
+
+  /// Accepted value of the above ratio, derived from the floating-point error
+  /// bounds of the three matrix-vector products: `2 (N + P + 2) epsilon`.
+  double tolerance;
+
+  /// Lower bound of the probability that a wrong C would have been detected.
+  double confidence;
+} FreivaldsResult;
+
+#endif // TR_MATRIX_FREIVALDS_RESULT
+
+#undef Freivalds
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Freivalds(suffix) TR_JOIN2(_, FreivaldsFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Freivalds(suffix) TR_JOIN2(_, FreivaldsDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// Runs `context->freivalds` Freivalds trials with matrix-vector OpenCL kernels
+/// on the device-resident (padded) operands and result.
+///
+/// @returns `true` if the verification could be run (see `result` for its outcome).
+///
+/// @pre `context` is not NULL and initialized, its host arena holds the vectors.
+/// @pre `A`, `B` and `C` are the buffers of the matrix multiplication.
+/// @post May display error on stderr.
+///
+bool Freivalds(Device)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  OUT FreivaldsResult* result
+);
+
+///
+/// Same as `Freivalds(Device)` with host-resident matrixes, using every host thread.
+///
+bool Freivalds(Host)(
+  IN MatMulContext const* context,
+  IN TR_MATRIX_PRECISION const* A,
+  IN TR_MATRIX_PRECISION const* B,
+  IN TR_MATRIX_PRECISION const* C,
+  OUT FreivaldsResult* result
+);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_FREIVALDS_H
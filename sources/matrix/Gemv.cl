@@ -0,0 +1,147 @@
+#ifndef GEMV_REAL
+#define GEMV_REAL float
+#endif
+
+#ifndef GEMV_GROUP // Work-group size, must be a power of 2.
+#define GEMV_GROUP 128
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+#define INOUT
+
+#define CONCAT_HELPER(A, B) A##B
+#define CONCAT(A, B) CONCAT_HELPER(A, B)
+
+typedef GEMV_REAL Real;
+typedef CONCAT(GEMV_REAL, 4) Real4;
+
+///
+/// Computes `y = X * v` with one work-group per row of X, X being stored
+/// row-major as (rows, columns) with the leading dimension `ld`.
+///
+/// The work-items of a group read consecutive `Real4` of the row (coalesced),
+/// then their partial dot products are reduced in local memory.
+///
+/// Covers `C = A * b` (A stored as (M, N)) and `C = a * B^T` (B stored as (P, N)).
+///
+/// @pre get_local_size(0) is GEMV_GROUP.
+/// @pre get_num_groups(0) is `rows`.
+///
+__attribute__((reqd_work_group_size(GEMV_GROUP, 1, 1)))
+__kernel void GemvRows(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned int const ld,
+
+  IN  __global Real const* X,
+  IN  __global Real const* v,
+  OUT __global Real      * y)
+{
+  __local Real partial[GEMV_GROUP];
+
+  size_t const row = get_group_id(0);
+  size_t const local = get_local_id(0);
+  __global Real const* line = X + row * ld;
+
+  // vload4() only requires the alignment of Real, whatever `ld`.
+  Real sum = (Real) 0;
+  size_t const vectors = columns / 4u;
+  for (size_t index = local; index < vectors; index += GEMV_GROUP) {
+    sum += dot(vload4(index, line), vload4(index, v));
+  }
+
+  for (size_t index = vectors * 4u + local; index < columns; index += GEMV_GROUP) {
+    sum += line[index] * v[index];
+  }
+
+  partial[local] = sum;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (size_t stride = GEMV_GROUP / 2; stride > 0u; stride /= 2u) {
+    if (local < stride) {
+      partial[local] += partial[local + stride];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  (void) rows; // Given by the number of work-groups.
+
+  if (local == 0u) {
+    y[row] = partial[0];
+  }
+}
+
+///
+/// Loads the 4 elements of `line` from `first`, the ones past `columns` being 0.
+///
+static Real4 LoadColumns(IN __global Real const* line, IN size_t const first, IN size_t const columns) {
+  if (first + 4u <= columns) {
+    return vload4(0, line + first);
+  }
+
+  Real4 values = (Real4) (0);
+  if (first + 0u < columns) { values.s0 = line[first + 0u]; }
+  if (first + 1u < columns) { values.s1 = line[first + 1u]; }
+  if (first + 2u < columns) { values.s2 = line[first + 2u]; }
+  return values;
+}
+
+///
+/// Computes `y = v * X` with 4 consecutive columns of X per work-item, X being
+/// stored row-major as (rows, columns) with the leading dimension `ld`.
+///
+/// Every row of X is read once and coalesced, the vector v is staged by chunks
+/// of GEMV_GROUP elements in local memory and shared by the work-group.
+///
+/// Covers `C = a * B` (B stored as (N, P)) and `C = A^T * b` (A stored as (N, M)).
+///
+/// @pre get_local_size(0) is GEMV_GROUP.
+/// @pre get_global_size(0) >= ceil(columns / 4).
+///
+__attribute__((reqd_work_group_size(GEMV_GROUP, 1, 1)))
+__kernel void GemvColumns(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned int const ld,
+
+  IN  __global Real const* X,
+  IN  __global Real const* v,
+  OUT __global Real      * y)
+{
+  __local Real vLocal[GEMV_GROUP];
+
+  size_t const first = get_global_id(0) * 4u;
+  size_t const local = get_local_id(0);
+
+  Real4 sum = (Real4) (0);
+  for (size_t base = 0u; base < rows; base += GEMV_GROUP) {
+    vLocal[local] = base + local < rows ? v[base + local] : (Real) 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+
+    size_t const count = min((size_t) (rows - base), (size_t) GEMV_GROUP);
+    if (first < columns) {
+      for (size_t index = 0u; index < count; ++index) {
+        sum += LoadColumns(X + (base + index) * ld, first, columns) * vLocal[index];
+      }
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (first + 4u <= columns) {
+    vstore4(sum, 0, y + first);
+  }
+  else {
+    if (first + 0u < columns) { y[first + 0u] = sum.s0; }
+    if (first + 1u < columns) { y[first + 1u] = sum.s1; }
+    if (first + 2u < columns) { y[first + 2u] = sum.s2; }
+  }
+}
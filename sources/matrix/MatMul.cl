@@ -2,9 +2,145 @@
 #error MATMUL_BLOCKSIZE is undefined.
 #endif
 
+#ifndef MATMUL_REAL
+#define MATMUL_REAL float
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
 #define IN
 #define OUT
 
+///
+/// Shape specialization: when `MATMUL_M`, `MATMUL_N` and `MATMUL_P` are given at
+/// build time (with the leading dimensions `MATMUL_LDA`, `MATMUL_LDB` and
+/// `MATMUL_LDC`), they replace the runtime arguments so that the loop over the
+/// blocks has a constant trip count and the index arithmetic is folded.
+///
+#if defined(MATMUL_M) && defined(MATMUL_N) && defined(MATMUL_P)
+#define MATMUL_SHAPE(CONSTANT, ARGUMENT) CONSTANT
+#else
+#define MATMUL_SHAPE(CONSTANT, ARGUMENT) ARGUMENT
+#endif
+
+///
+/// Padding of the rows of the local tiles (`-DMATMUL_LOCAL_PAD=1`), so that
+/// the transposed stores and the column reads of a tile spread over the local
+/// memory banks instead of hitting the same one.
+///
+#ifndef MATMUL_LOCAL_PAD
+#define MATMUL_LOCAL_PAD 0
+#endif
+
+typedef MATMUL_REAL Real;
+
+#if defined(MATMUL_IMAGE) && defined(MATMUL_VIEWS)
+#error MATMUL_IMAGE cannot be combined with MATMUL_VIEWS.
+#endif
+
+#ifdef MATMUL_IMAGE
+///
+/// The operands are `CL_RGBA`/`CL_FLOAT` images (`Real` is `float`), 4
+/// consecutive elements of a row per texel, so that the loads go through the
+/// texture cache. The elements are addressed by `(column, row)`.
+///
+typedef __read_only image2d_t Operand;
+
+__constant sampler_t operandSampler = CLK_NORMALIZED_COORDS_FALSE | CLK_ADDRESS_NONE | CLK_FILTER_NEAREST;
+
+static Real LoadTexel(IN Operand image, IN int2 const element) {
+  float4 const texel = read_imagef(image, operandSampler, (int2) (element.x >> 2, element.y));
+  switch (element.x & 3) {
+    case 0: return texel.x;
+    case 1: return texel.y;
+    case 2: return texel.z;
+    default: return texel.w;
+  }
+}
+#else // MATMUL_IMAGE
+typedef __global Real const* Operand;
+#endif // MATMUL_IMAGE
+
+#if defined(MATMUL_EPILOGUE) && defined(MATMUL_SPLITK)
+#error MATMUL_EPILOGUE cannot be combined with MATMUL_SPLITK.
+#endif
+
+// The previous C is read as `Real`, which a downcast storage is not.
+#if defined(MATMUL_BETA) && (defined(MATMUL_OUTPUT_HALF) || defined(MATMUL_OUTPUT_INT8))
+#error MATMUL_BETA cannot be combined with MATMUL_OUTPUT_HALF nor MATMUL_OUTPUT_INT8.
+#endif
+
+///
+/// The storage of C, `Real` unless the epilogue downcasts it. A `half` C is
+/// only written through `vstore_half` and never read, `MATMUL_BETA` being
+/// rejected above, so `cl_khr_fp16` is not required.
+///
+#if defined(MATMUL_OUTPUT_HALF)
+typedef half Output;
+#elif defined(MATMUL_OUTPUT_INT8)
+typedef char Output;
+#else
+typedef Real Output;
+#endif
+
+#ifdef MATMUL_EPILOGUE
+///
+/// Applies the stages of the epilogue selected at build time to the element
+/// `(row, column)` of the product before storing it at `C[index]`, in order:
+/// `alpha * AB + beta * C`, bias, activation, clamp then downcast.
+///
+/// `bias` holds M elements with `MATMUL_BIAS_ROWS` and P with `MATMUL_BIAS_COLUMNS`.
+///
+static void Store(
+  IN Real value,
+  IN size_t const row, IN size_t const column, IN size_t const index,
+  IN __global Real const* bias,
+  IN Real const alpha, IN Real const beta,
+  IN Real const low, IN Real const high,
+  OUT __global Output* C)
+{
+#ifdef MATMUL_ALPHA
+  value *= alpha;
+#endif
+#ifdef MATMUL_BETA
+  value += beta * C[index];
+#endif
+
+#if defined(MATMUL_BIAS_ROWS)
+  value += bias[row];
+#elif defined(MATMUL_BIAS_COLUMNS)
+  value += bias[column];
+#endif
+
+#if defined(MATMUL_RELU)
+  value = fmax(value, (Real) 0);
+#elif defined(MATMUL_GELU)
+  value = (Real) 0.5f * value * ((Real) 1 + erf(value * rsqrt((Real) 2)));
+#elif defined(MATMUL_SILU)
+  value = value / ((Real) 1 + exp(-value));
+#endif
+
+#ifdef MATMUL_CLAMP
+  value = clamp(value, low, high);
+#endif
+
+#if defined(MATMUL_OUTPUT_HALF)
+  vstore_half_rte(value, index, C);
+#elif defined(MATMUL_OUTPUT_INT8)
+  C[index] = convert_char_sat_rte(value);
+#else
+  C[index] = value;
+#endif
+
+  (void) row; (void) column; (void) bias;
+  (void) alpha; (void) beta; (void) low; (void) high;
+}
+#endif // MATMUL_EPILOGUE
+
 ///
 /// ```txt
 ///                    P
@@ -13,20 +149,104 @@
 /// M A A A    N B B B B    M C C C C
 /// ```
 ///
+/// Computes `C = op(A) * op(B)` where `op(X)` is either `X` or `X^T`, selected
+/// at build time with `-DTRANS_A` and `-DTRANS_B` (NN, NT, TN and TT variants):
+///   - `TRANS_A` undefined: A is stored row-major as (M, N),
+///   - `TRANS_A` defined:   A is stored row-major as (N, M),
+///   - `TRANS_B` undefined: B is stored row-major as (N, P),
+///   - `TRANS_B` defined:   B is stored row-major as (P, N).
+///
+/// Both local tiles are always laid out as `ALocal[row][n]` and `BLocal[column][n]`,
+/// only the global loads differ, so that consecutive work-items always read
+/// consecutive global addresses (coalesced) whatever the storage order.
+///
+/// The leading dimensions are those of the padded storage, i.e. `LDA` is N (or
+/// M if transposed), `LDB` is P (or N if transposed) and `LDC` is P.
+///
+/// With `-DMATMUL_SPLITK`, N is split over `get_num_groups(2)` work-groups per
+/// tile of C, each writing a partial product then summed by `MatMulReduceK`.
+///
+/// With `-DMATMUL_VIEWS`, the operands are views `(offset, leading dimension)`
+/// into larger matrixes, e.g. the quadrants of the Strassen-Winograd recursion
+/// (see `matrix/Strassen.c`), given as additional arguments.
+///
+/// With `-DMATMUL_DOUBLE_BUFFER`, the local tiles are ping-ponged: the global
+/// loads of the next block of N are issued into registers before the products
+/// of the current block, then stored into the other pair of tiles, so that a
+/// single barrier per block remains and the loads overlap the products.
+///
+/// With `-DMATMUL_IMAGE`, A and B are read through images (see `LoadTexel()`),
+/// the loads following the `(column, row)` of the elements instead of their
+/// linear offsets.
+///
+/// With `-DMATMUL_EPILOGUE`, the element is transformed before being stored
+/// (see `Store()`), the stages being selected with `-DMATMUL_ALPHA`,
+/// `-DMATMUL_BETA`, `-DMATMUL_BIAS_ROWS`, `-DMATMUL_BIAS_COLUMNS`,
+/// `-DMATMUL_RELU`, `-DMATMUL_GELU`, `-DMATMUL_SILU`, `-DMATMUL_CLAMP`,
+/// `-DMATMUL_OUTPUT_HALF` and `-DMATMUL_OUTPUT_INT8`, so that the product is
+/// written once instead of being read back by one pass per stage.
+///
 /// @pre get_global_size(0, 1) is (P, M), (x, y) or (columns, rows)
 ///
 __attribute__((reqd_work_group_size(MATMUL_BLOCKSIZE, MATMUL_BLOCKSIZE, 1)))
 __kernel void MatMul(
-  IN unsigned int const M,
-  IN unsigned int const N,
-  IN unsigned int const P,
+  IN unsigned int const argumentM,
+  IN unsigned int const argumentN,
+  IN unsigned int const argumentP,
 
-  IN  __global float const* A,
-  IN  __global float const* B,
-  OUT __global float      * C)
+#ifdef MATMUL_VIEWS
+  IN unsigned long const offsetA, IN unsigned int const viewLDA,
+  IN unsigned long const offsetB, IN unsigned int const viewLDB,
+  IN unsigned long const offsetC, IN unsigned int const viewLDC,
+#endif // MATMUL_VIEWS
+
+  IN  Operand A,
+  IN  Operand B,
+  OUT __global Output* C
+
+#ifdef MATMUL_EPILOGUE
+  , IN __global Real const* bias
+  , IN Real const alpha, IN Real const beta
+  , IN Real const low, IN Real const high
+#endif // MATMUL_EPILOGUE
+  )
 {
-  __local float ALocal[MATMUL_BLOCKSIZE][MATMUL_BLOCKSIZE];
-  __local float BLocal[MATMUL_BLOCKSIZE][MATMUL_BLOCKSIZE];
+  size_t const M = MATMUL_SHAPE(MATMUL_M, argumentM);
+  size_t const N = MATMUL_SHAPE(MATMUL_N, argumentN);
+  size_t const P = MATMUL_SHAPE(MATMUL_P, argumentP);
+
+#ifdef MATMUL_VIEWS
+  A += offsetA;
+  B += offsetB;
+  C += offsetC;
+
+  size_t const LDA = viewLDA;
+  size_t const LDB = viewLDB;
+  size_t const LDC = viewLDC;
+#else // MATMUL_VIEWS
+
+#ifndef TRANS_A
+  size_t const LDA = MATMUL_SHAPE(MATMUL_LDA, N);
+#else // TRANS_A
+  size_t const LDA = MATMUL_SHAPE(MATMUL_LDA, M);
+#endif // TRANS_A
+
+#ifndef TRANS_B
+  size_t const LDB = MATMUL_SHAPE(MATMUL_LDB, P);
+#else // TRANS_B
+  size_t const LDB = MATMUL_SHAPE(MATMUL_LDB, N);
+#endif // TRANS_B
+
+  size_t const LDC = MATMUL_SHAPE(MATMUL_LDC, P);
+#endif // MATMUL_VIEWS
+
+#ifndef MATMUL_DOUBLE_BUFFER
+  __local Real ALocal[MATMUL_BLOCKSIZE][MATMUL_BLOCKSIZE + MATMUL_LOCAL_PAD];
+  __local Real BLocal[MATMUL_BLOCKSIZE][MATMUL_BLOCKSIZE + MATMUL_LOCAL_PAD];
+#else // MATMUL_DOUBLE_BUFFER
+  __local Real ALocals[2][MATMUL_BLOCKSIZE][MATMUL_BLOCKSIZE + MATMUL_LOCAL_PAD];
+  __local Real BLocals[2][MATMUL_BLOCKSIZE][MATMUL_BLOCKSIZE + MATMUL_LOCAL_PAD];
+#endif // MATMUL_DOUBLE_BUFFER
 
   // get_global_size(0) == P
   // get_global_size(1) == M
@@ -40,23 +260,94 @@ __kernel void MatMul(
   size_t xBlock = get_group_id(0);
   size_t yBlock = get_group_id(1);
 
-  size_t ABase = yBlock * MATMUL_BLOCKSIZE * N;
+#ifndef TRANS_A
+  size_t ABase = yBlock * MATMUL_BLOCKSIZE * LDA;
+  size_t AStep = MATMUL_BLOCKSIZE;
+  size_t AOffset = yLocal * LDA + xLocal;
+#else // TRANS_A
+  size_t ABase = yBlock * MATMUL_BLOCKSIZE;
+  size_t AStep = MATMUL_BLOCKSIZE * LDA;
+  size_t AOffset = yLocal * LDA + xLocal;
+#endif // TRANS_A
+
+#ifndef TRANS_B
   size_t BBase = xBlock * MATMUL_BLOCKSIZE;
+  size_t BStep = MATMUL_BLOCKSIZE * LDB;
+  size_t BOffset = yLocal * LDB + xLocal;
+#else // TRANS_B
+  size_t BBase = xBlock * MATMUL_BLOCKSIZE * LDB;
+  size_t BStep = MATMUL_BLOCKSIZE;
+  size_t BOffset = yLocal * LDB + xLocal;
+#endif // TRANS_B
 
-  size_t AStep = MATMUL_BLOCKSIZE;
-  size_t BStep = MATMUL_BLOCKSIZE * P;
+#ifdef MATMUL_IMAGE
+  // The same walk as the offsets above, as (column, row) of the elements.
+#ifndef TRANS_A
+  int2 ACoordinates = (int2) ((int) xLocal, (int) (yBlock * MATMUL_BLOCKSIZE + yLocal));
+  int2 const ACoordinatesStep = (int2) (MATMUL_BLOCKSIZE, 0);
+#else // TRANS_A
+  int2 ACoordinates = (int2) ((int) (yBlock * MATMUL_BLOCKSIZE + xLocal), (int) yLocal);
+  int2 const ACoordinatesStep = (int2) (0, MATMUL_BLOCKSIZE);
+#endif // TRANS_A
+
+#ifndef TRANS_B
+  int2 BCoordinates = (int2) ((int) (xBlock * MATMUL_BLOCKSIZE + xLocal), (int) yLocal);
+  int2 const BCoordinatesStep = (int2) (0, MATMUL_BLOCKSIZE);
+#else // TRANS_B
+  int2 BCoordinates = (int2) ((int) xLocal, (int) (xBlock * MATMUL_BLOCKSIZE + yLocal));
+  int2 const BCoordinatesStep = (int2) (MATMUL_BLOCKSIZE, 0);
+#endif // TRANS_B
+
+  #define LOAD_A() LoadTexel(A, ACoordinates)
+  #define LOAD_B() LoadTexel(B, BCoordinates)
+  #define NEXT_BLOCK() (ABase += AStep, BBase += BStep, ACoordinates += ACoordinatesStep, BCoordinates += BCoordinatesStep)
+#else // MATMUL_IMAGE
+  #define LOAD_A() A[ABase + AOffset]
+  #define LOAD_B() B[BBase + BOffset]
+  #define NEXT_BLOCK() (ABase += AStep, BBase += BStep)
+#endif // MATMUL_IMAGE
+
+  Real accumulator = 0.0f;
+
+  size_t const numberOfBlocks = N / MATMUL_BLOCKSIZE;
+
+#ifdef MATMUL_SPLITK
+  // The work-groups along the third dimension each take a contiguous range of
+  // the blocks of N, and write their partial tile in their own (M, LDC) slice.
+  size_t const split = get_group_id(2);
+  size_t const firstBlock = split * numberOfBlocks / get_num_groups(2);
+  size_t const lastBlock = (split + 1) * numberOfBlocks / get_num_groups(2);
 
-  size_t AOffset = yLocal * N + xLocal;
-  size_t BOffset = yLocal * P + xLocal;
+  ABase += firstBlock * AStep;
+  BBase += firstBlock * BStep;
+  C += split * M * LDC;
 
-  float accumulator = 0.0f;
+#ifdef MATMUL_IMAGE
+  ACoordinates += (int) firstBlock * ACoordinatesStep;
+  BCoordinates += (int) firstBlock * BCoordinatesStep;
+#endif // MATMUL_IMAGE
+#else // MATMUL_SPLITK
+  size_t const firstBlock = 0;
+  size_t const lastBlock = numberOfBlocks;
+#endif // MATMUL_SPLITK
 
-  size_t numberOfBlocks = N / MATMUL_BLOCKSIZE;
+#ifndef MATMUL_DOUBLE_BUFFER
+#if defined(MATMUL_N) && !defined(MATMUL_SPLITK)
+  #pragma unroll
+#endif // MATMUL_N
+  for (size_t nBlock = firstBlock; nBlock < lastBlock; ++nBlock) {
 
-  for (size_t nBlock = 0; nBlock < numberOfBlocks; ++nBlock) {
+#ifndef TRANS_A
+    ALocal[yLocal][xLocal] = LOAD_A();
+#else // TRANS_A
+    ALocal[xLocal][yLocal] = LOAD_A(); // Transpose.
+#endif // TRANS_A
 
-    ALocal[yLocal][xLocal] = A[ABase + AOffset];
-    BLocal[xLocal][yLocal] = B[BBase + BOffset]; // Transpose.
+#ifndef TRANS_B
+    BLocal[xLocal][yLocal] = LOAD_B(); // Transpose.
+#else // TRANS_B
+    BLocal[yLocal][xLocal] = LOAD_B();
+#endif // TRANS_B
 
     barrier(CLK_LOCAL_MEM_FENCE);
 
@@ -67,9 +358,104 @@ __kernel void MatMul(
 
     barrier(CLK_LOCAL_MEM_FENCE);
 
-    ABase += AStep;
-    BBase += BStep;
+    NEXT_BLOCK();
+  }
+#else // MATMUL_DOUBLE_BUFFER
+  // The first block is loaded up front, then every step loads the next one.
+  Real ANext = (Real) 0, BNext = (Real) 0;
+  if (firstBlock < lastBlock) {
+    ANext = LOAD_A();
+    BNext = LOAD_B();
+  }
+
+#ifndef TRANS_A
+  ALocals[0][yLocal][xLocal] = ANext;
+#else // TRANS_A
+  ALocals[0][xLocal][yLocal] = ANext; // Transpose.
+#endif // TRANS_A
+
+#ifndef TRANS_B
+  BLocals[0][xLocal][yLocal] = BNext; // Transpose.
+#else // TRANS_B
+  BLocals[0][yLocal][xLocal] = BNext;
+#endif // TRANS_B
+
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (size_t nBlock = firstBlock; nBlock < lastBlock; ++nBlock) {
+    size_t const current = (nBlock - firstBlock) & 1u;
+    bool const more = nBlock + 1u < lastBlock;
+
+    NEXT_BLOCK();
+
+    // Issued before the products, consumed after them.
+    if (more) {
+      ANext = LOAD_A();
+      BNext = LOAD_B();
+    }
+
+    #pragma unroll
+    for (size_t nLocal = 0; nLocal < MATMUL_BLOCKSIZE; ++nLocal) {
+      accumulator += ALocals[current][yLocal][nLocal] * BLocals[current][xLocal][nLocal];
+    }
+
+    // The other tiles were last read before the previous barrier.
+    if (more) {
+#ifndef TRANS_A
+      ALocals[current ^ 1u][yLocal][xLocal] = ANext;
+#else // TRANS_A
+      ALocals[current ^ 1u][xLocal][yLocal] = ANext; // Transpose.
+#endif // TRANS_A
+
+#ifndef TRANS_B
+      BLocals[current ^ 1u][xLocal][yLocal] = BNext; // Transpose.
+#else // TRANS_B
+      BLocals[current ^ 1u][yLocal][xLocal] = BNext;
+#endif // TRANS_B
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+#endif // MATMUL_DOUBLE_BUFFER
+
+  #undef LOAD_A
+  #undef LOAD_B
+  #undef NEXT_BLOCK
+
+  (void) M; // Only used through the leading dimensions.
+
+#ifdef MATMUL_EPILOGUE
+  Store(accumulator, yGlobal, xGlobal, yGlobal * LDC + xGlobal, bias, alpha, beta, low, high, C);
+#else // MATMUL_EPILOGUE
+  C[yGlobal * LDC + xGlobal] = accumulator;
+#endif // MATMUL_EPILOGUE
+}
+
+#ifdef MATMUL_SPLITK
+///
+/// Sums the partial products of split-K, `splits` slices of `count` elements,
+/// into C. The slices are always added in the same order, so the result does
+/// not depend on the scheduling (unlike atomics).
+///
+/// @pre get_global_size(0) >= count
+///
+__kernel void MatMulReduceK(
+  IN unsigned long const count,
+  IN unsigned int const splits,
+
+  IN  __global Real const* partials,
+  OUT __global Real      * C)
+{
+  size_t const index = get_global_id(0);
+  if (index >= count) {
+    return;
+  }
+
+  Real sum = partials[index];
+  for (size_t split = 1; split < splits; ++split) {
+    sum += partials[split * count + index];
   }
 
-  C[yGlobal * P + xGlobal] = accumulator;
+  C[index] = sum;
 }
+#endif // MATMUL_SPLITK
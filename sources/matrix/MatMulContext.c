@@ -2,10 +2,27 @@
 #include <getopt.h> // getopt_long(), required_argument, no_argument
 #include <stdbool.h> // bool, true, false
 #include <stdio.h> // FILE, fprintf, stdout, stderr
+#include <stdlib.h> // strtod()
+#include <string.h> // strcspn(), strlen(), memcpy()
 
 #include "common/helper.h" // IN, INOUT, OUT, TAB, LF
-#include "common/parse.h" // ParseNumbers()
+#include "common/parse.h" // ParseNumber(), ParseNumbers()
+#include "common/prefix.h" // IsPrefix()
 #include "matrix/MatMulContext.h" // MatMulContext{}
+#include "matrix/RandomStreams.h" // TR_STREAM_FREIVALDS_TRIALS
+
+/// Largest Strassen-Winograd depth tried when picked from timings.
+#define TR_MATMUL_STRASSEN_AUTO_DEPTH 4u
+
+/// Largest block size picked by default, the work-groups being `BS x BS`.
+#define TR_MATMUL_MAX_DEFAULT_BLOCK_SIZE 32u
+
+/// Default number of Freivalds trials, a wrong C passes them with a probability of at most 2^-k.
+#define TR_MATMUL_FREIVALDS_TRIALS 8u
+
+/// Work-groups wanted per compute unit, and least blocks of N per slice, of the automatic split-K.
+#define TR_MATMUL_SPLITK_GROUPS 4u
+#define TR_MATMUL_SPLITK_BLOCKS 8u
 
 #define TR_MATMUL_STRING(TAB) \
   TAB "                   P"              LF \
@@ -21,6 +38,302 @@ static size_t RoundUp(IN size_t x, IN size_t n) {
   return r == 0 ? x : x + n - r;
 }
 
+///
+/// Returns the local memory of a `BS x BS` work-group of the MatMul kernel,
+/// its two `BS x (BS + pad)` tiles, twice when double-buffered.
+///
+static size_t LocalTileBytes(IN size_t blockSize, IN size_t elementSize, IN bool doubleBuffer, IN bool padLocal) {
+  size_t tiles = doubleBuffer ? 4u : 2u;
+  return tiles * blockSize * (blockSize + (padLocal ? 1u : 0u)) * elementSize;
+}
+
+///
+/// Picks the number of slices of N of split-K: enough work-groups to give
+/// each compute unit `TR_MATMUL_SPLITK_GROUPS` of them when the tiles of C are
+/// too few, while keeping at least `TR_MATMUL_SPLITK_BLOCKS` blocks of N per
+/// slice and the partial tiles within one buffer.
+///
+/// @returns The number of slices, 1 when the tiles of C already fill the device.
+///
+static size_t AutoSplitK(IN MatMulContext const* this, IN size_t elementSize) {
+  OpenClCapabilities const* capabilities = &this->openCl.capabilities;
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+  size_t tiles = (M / this->blockSize) * (P / this->blockSize);
+  size_t wanted = (size_t) (capabilities->computeUnits > 0u ? capabilities->computeUnits : 1u) * TR_MATMUL_SPLITK_GROUPS;
+  if (tiles == 0u || tiles >= wanted) {
+    return 1u;
+  }
+
+  size_t splits = (wanted + tiles - 1u) / tiles;
+  size_t most = (N / this->blockSize) / TR_MATMUL_SPLITK_BLOCKS;
+  splits = splits < most ? splits : most;
+  splits = splits < TR_MATMUL_MAX_SPLITK ? splits : TR_MATMUL_MAX_SPLITK;
+
+  while (splits > 1u && capabilities->maxAllocationSize != 0u
+    && splits * M * P * elementSize > capabilities->maxAllocationSize) {
+    splits -= 1u;
+  }
+
+  return splits > 1u ? splits : 1u;
+}
+
+///
+/// Rejects the configurations that the device cannot run (work-groups, local
+/// memory and buffer sizes) before anything is allocated.
+///
+/// @returns `true` if the configuration fits, `false` otherwise.
+///
+/// @post May display error on stderr.
+///
+static bool CheckCapabilities(IN MatMulContext const* this, IN size_t elementSize) {
+  OpenClCapabilities const* capabilities = &this->openCl.capabilities;
+
+  if (!MatMulContext_FitsBlockSize(capabilities, this->blockSize, elementSize
+    , this->doubleBuffer, this->padLocal, capabilities->localMemorySize))
+  {
+    fprintf(stderr, LF
+      "The block size does not fit the device:" LF
+      TAB1 "--block-size %zu" LFLF
+      "A work-group has %zu work-items and %zu bytes of local memory, but the device allows:" LF
+      TAB1 "%zu work-items (%zu x %zu) and %llu bytes of local memory." LFLF
+      , this->blockSize
+      , this->blockSize * this->blockSize, LocalTileBytes(this->blockSize, elementSize, this->doubleBuffer, this->padLocal)
+      , capabilities->maxWorkGroupSize, capabilities->maxWorkItemSizes[0], capabilities->maxWorkItemSizes[1]
+      , (unsigned long long) capabilities->localMemorySize
+    );
+
+    return false;
+  }
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+  size_t bytes[3] = { M * N * elementSize, N * P * elementSize, M * P * elementSize };
+  size_t largest = bytes[0] > bytes[1] ? bytes[0] : bytes[1];
+  largest = largest > bytes[2] ? largest : bytes[2];
+
+  if ((capabilities->maxAllocationSize != 0u && largest > capabilities->maxAllocationSize)
+    || (capabilities->globalMemorySize != 0u && bytes[0] + bytes[1] + bytes[2] > capabilities->globalMemorySize)) {
+    fprintf(stderr, LF
+      "The matrixes do not fit the device memory:" LF
+      TAB1 "--matrix-size %zu,%zu,%zu" LFLF
+      "A, B and C (with padding) take %zu, %zu and %zu bytes, but the device allows:" LF
+      TAB1 "%llu bytes per buffer and %llu bytes overall." LFLF
+      , this->M, this->N, this->P
+      , bytes[0], bytes[1], bytes[2]
+      , (unsigned long long) capabilities->maxAllocationSize
+      , (unsigned long long) capabilities->globalMemorySize
+    );
+
+    return false;
+  }
+
+  cl_device_svm_capabilities svm = capabilities->svmCapabilities;
+  if (this->svm && (svm & (CL_DEVICE_SVM_COARSE_GRAIN_BUFFER | CL_DEVICE_SVM_FINE_GRAIN_BUFFER)) == 0u) {
+    fprintf(stderr, LF
+      "Shared virtual memory was required but the device does not support it:" LF
+      TAB1 "--memory SVM" LFLF
+    );
+
+    return false;
+  }
+
+  if (this->imageOperands) {
+    // A is (M, N) or (N, M), B is (N, P) or (P, N), 4 elements per texel.
+    size_t AWidth = this->transA ? M : N, AHeight = this->transA ? N : M;
+    size_t BWidth = this->transB ? N : P, BHeight = this->transB ? P : N;
+    size_t width = AWidth > BWidth ? AWidth : BWidth;
+    size_t height = AHeight > BHeight ? AHeight : BHeight;
+
+    char const* reason = NULL;
+    if (!capabilities->imageSupport) { reason = "The device does not support images."; }
+    else if (elementSize != sizeof(float)) { reason = "The images hold single-precision values only (read_imagef)."; }
+    else if (this->svm) { reason = "The images are created from buffers, not from shared virtual memory."; }
+    else if (this->blockSize % 4u != 0u) { reason = "The block size must be a multiple of 4 (the texels)."; }
+    else if ((capabilities->image2dMaxWidth != 0u && width / 4u > capabilities->image2dMaxWidth)
+      || (capabilities->image2dMaxHeight != 0u && height > capabilities->image2dMaxHeight)) {
+      reason = "The operands exceed the largest 2D image of the device.";
+    }
+
+    if (reason != NULL) {
+      fprintf(stderr, LF
+        "The operands cannot be read through images:" LF
+        TAB1 "--operands Image" LFLF
+        "%s" LFLF
+        , reason
+      );
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
+///
+/// Parses `Classic | Strassen[:<Depth>]` into the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool ParseAlgorithm(IN char const* algorithm, INOUT MatMulContext* this) {
+  char method[16] = { 0 };
+  size_t length = strcspn(algorithm, ":");
+  if (length == 0u || length >= sizeof(method)) { return false; }
+
+  memcpy(method, algorithm, length);
+  char const* cursor = algorithm + length;
+
+  if (IsPrefix(method, "Classic", 8)) {
+    this->strassen = false;
+    return *cursor == '\0';
+  }
+
+  if (!IsPrefix(method, "Strassen", 9)) { return false; }
+
+  this->strassen = true;
+  this->strassenDepth = 0u; // Picked from timings.
+
+  if (*cursor == ':') {
+    cursor += 1;
+    if (!ParseNumber(&cursor, &this->strassenDepth)) { return false; }
+    if (this->strassenDepth == 0u || this->strassenDepth > TR_MATMUL_STRASSEN_MAX_DEPTH) { return false; }
+  }
+
+  return *cursor == '\0';
+}
+
+///
+/// Parses `Freivalds[:<Trials>][,Host | ,Device]` into the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool ParseVerification(IN char const* verify, INOUT MatMulContext* this) {
+  char method[16] = { 0 };
+  size_t length = strcspn(verify, ":,");
+  if (length == 0u || length >= sizeof(method)) { return false; }
+
+  memcpy(method, verify, length);
+  if (!IsPrefix(method, "Freivalds", 10)) { return false; }
+
+  char const* cursor = verify + length;
+  this->freivalds = TR_MATMUL_FREIVALDS_TRIALS;
+
+  if (*cursor == ':') {
+    cursor += 1;
+    if (!ParseNumber(&cursor, &this->freivalds) || this->freivalds == 0u
+      || this->freivalds > TR_STREAM_FREIVALDS_TRIALS) { return false; }
+  }
+
+  if (*cursor == ',') {
+    cursor += 1;
+    if (*cursor != '\0' && IsPrefix(cursor, "Host", 5)) { this->freivaldsOnHost = true; }
+    else if (*cursor == '\0' || !IsPrefix(cursor, "Device", 7)) { return false; }
+    cursor += strlen(cursor);
+  }
+
+  return *cursor == '\0';
+}
+
+///
+/// Parses the local tiles option `Single | Double[,Padded]` into the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool ParseLocalTiles(IN char const* tiles, INOUT MatMulContext* this) {
+  char buffers[16] = { 0 };
+  size_t length = strcspn(tiles, ",");
+  if (length == 0u || length >= sizeof(buffers)) { return false; }
+
+  memcpy(buffers, tiles, length);
+  char const* cursor = tiles + length;
+
+  if (IsPrefix(buffers, "Single", 7)) { this->doubleBuffer = false; }
+  else if (IsPrefix(buffers, "Double", 7)) { this->doubleBuffer = true; }
+  else { return false; }
+
+  this->padLocal = false;
+  if (*cursor == ',') {
+    cursor += 1;
+    if (*cursor == '\0' || !IsPrefix(cursor, "Padded", 7)) { return false; }
+    this->padLocal = true;
+  }
+
+  return true;
+}
+
+///
+/// Parses a number following a `:` of an epilogue stage.
+///
+static bool ParseScalar(INOUT char const** cursor, OUT double* value) {
+  if (**cursor != ':') { return false; }
+
+  char* end = NULL;
+  *value = strtod(*cursor + 1, &end);
+  if (end == *cursor + 1) { return false; }
+
+  *cursor = end;
+  return true;
+}
+
+///
+/// Parses the comma-separated stages `Alpha:<Scalar>`, `Beta:<Scalar>`,
+/// `Bias:Rows | Bias:Columns`, `ReLU | GELU | SiLU`, `Clamp:<Low>:<High>` and
+/// `Half | Int8` into the context.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool ParseEpilogue(IN char const* epilogue, INOUT MatMulContext* this) {
+  MatMulEpilogue* stages = &this->epilogue;
+  *stages = (MatMulEpilogue) { .enabled = true, .alpha = 1.0, .beta = 0.0 };
+
+  char const* cursor = epilogue;
+  do {
+    char stage[16] = { 0 };
+    size_t length = strcspn(cursor, ":,");
+    if (length == 0u || length >= sizeof(stage)) { return false; }
+
+    memcpy(stage, cursor, length);
+    cursor += length;
+
+    if (IsPrefix(stage, "Alpha", 6)) {
+      if (!ParseScalar(&cursor, &stages->alpha)) { return false; }
+    }
+    else if (IsPrefix(stage, "Beta", 5)) {
+      if (!ParseScalar(&cursor, &stages->beta)) { return false; }
+    }
+    else if (IsPrefix(stage, "Bias", 5)) {
+      if (*cursor != ':') { return false; }
+      size_t kind = strcspn(cursor + 1, ",");
+      char which[16] = { 0 };
+      if (kind == 0u || kind >= sizeof(which)) { return false; }
+      memcpy(which, cursor + 1, kind);
+      if (IsPrefix(which, "Rows", 5)) { stages->bias = MatMulBias_Rows; }
+      else if (IsPrefix(which, "Columns", 8)) { stages->bias = MatMulBias_Columns; }
+      else { return false; }
+      cursor += 1u + kind;
+    }
+    else if (IsPrefix(stage, "ReLU", 5)) { stages->activation = MatMulActivation_Relu; }
+    else if (IsPrefix(stage, "GELU", 5)) { stages->activation = MatMulActivation_Gelu; }
+    else if (IsPrefix(stage, "SiLU", 5)) { stages->activation = MatMulActivation_Silu; }
+    else if (IsPrefix(stage, "Clamp", 6)) {
+      stages->clamp = true;
+      if (!ParseScalar(&cursor, &stages->low) || !ParseScalar(&cursor, &stages->high) || !(stages->low <= stages->high)) {
+        return false;
+      }
+    }
+    else if (IsPrefix(stage, "Half", 5)) { stages->output = MatMulOutput_Half; }
+    else if (IsPrefix(stage, "Int8", 5)) { stages->output = MatMulOutput_Int8; }
+    else { return false; }
+
+    if (*cursor != ',' && *cursor != '\0') { return false; }
+  } while (*cursor++ == ',');
+
+  return true;
+}
+
 bool MatMulContext_ArgumentsUsage(IN FILE* stream, char const* command) {
   assert(stream != NULL);
   assert(command != NULL);
@@ -31,21 +344,103 @@ bool MatMulContext_ArgumentsUsage(IN FILE* stream, char const* command) {
     TAB2 "Multiplies two matrixes together:"  LF
     TR_MATMUL_STRING(TAB3) LF
 
-    TAB2 BOLD("-d, --device") " GPU | CPU | Default | <PlatformIndex>:<DeviceIndex>" LF // TODO: Dedup.
-    TAB3 "Specifies which device to use (prefix, case-insensitive)." LFLF
+    TAB2 BOLD("-d, --device") " GPU | CPU | Default | Fastest | <PlatformIndex>:<DeviceIndex>" LF // TODO: Dedup.
+    TAB3 "Specifies which device to use (prefix, case-insensitive), fastest runs short probe" LF
+    TAB3 "kernels on every device once and caches their ranking." LFLF
 
     TAB2 BOLD("-m, --matrix-size") " <M>,<N>,<P>" LF // TODO: Dedup.
-    TAB3 "Represents the matrixes sizes with optional multiplicative suffixes (K, Ki, M, Mi...)." LFLF
+    TAB3 "Represents the matrixes sizes with optional multiplicative suffixes (K, Ki, M, Mi...)." LF
+    TAB3 "M = 1 or P = 1 runs dedicated matrix-vector kernels, without padding." LFLF
 
     TAB2 BOLD("-f, --double-precision") LF
     TAB3 "Enables the double-precision floating-point extension." LFLF
 
+    TAB2 BOLD("-p, --precision") " Single | Double | DF64" LF
+    TAB3 "Selects the floating-point format (prefix, case-insensitive), Double being --double-precision." LF
+    TAB3 "DF64 stores each value as a (hi, lo) pair of floats and multiplies them with error-free" LF
+    TAB3 "transformations (about 48 bits of mantissa), without the double-precision extension." LFLF
+
     TAB2 BOLD("-b, --block-size") " <Size>" LF
-    TAB3 "The block size of the block-wise matrix multiplication." LFLF
+    TAB3 "The block size of the block-wise matrix multiplication (by default, the largest fitting" LF
+    TAB3 "the work-group and local memory limits of the device, up to 32)." LFLF
+
+    TAB2 BOLD("-t, --trans-a") LF
+    TAB3 "Takes A as transposed, i.e. stored as (N, M), and computes op(A) = A^T." LFLF
+
+    TAB2 BOLD("-T, --trans-b") LF
+    TAB3 "Takes B as transposed, i.e. stored as (P, N), and computes op(B) = B^T." LFLF
+
+    TAB2 BOLD("-s, --specialize") LF
+    TAB3 "Bakes the matrix shapes into the OpenCL program (built once per shape and cached)." LFLF
+
+    TAB2 BOLD("-l, --local-tiles") " Single | Double[,Padded]" LF
+    TAB3 "Double-buffers the local tiles of the kernel, the global loads of the next block of N" LF
+    TAB3 "being issued before the products of the current one (one barrier per block instead of" LF
+    TAB3 "two), and/or pads their rows by one element against local memory bank conflicts" LF
+    TAB3 "(prefix, case-insensitive, default is Single)." LFLF
+
+    TAB2 BOLD("-i, --init") " Host | Device" LF
+    TAB3 "Where A and B are randomly generated, device skips the upload (prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-S, --seed") " <Seed>" LF
+    TAB3 "The seed of the random generator, both initializations give identical values." LFLF
+
+    TAB2 BOLD("-M, --memory") " Buffer | SVM" LF
+    TAB3 "Where A, B and C live, SVM shares them with the host without copies (requires OpenCL 2.0," LF
+    TAB3 "fine-grained when supported, prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-o, --operands") " Buffer | Image" LF
+    TAB3 "How the kernel reads A and B, Image goes through the texture cache with 4 elements per" LF
+    TAB3 "texel, then also times the buffers for comparison (single-precision, block size multiple of 4," LF
+    TAB3 "prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-H, --huge-pages") LF
+    TAB3 "Backs the host arena of the operands with huge pages (reserved ones, else transparent)." LFLF
+
+    TAB2 BOLD("-a, --algorithm") " Classic | Strassen[:<Depth>]" LF
+    TAB3 "Also computes C with the Strassen-Winograd recursion (depth picked from timings by default)" LF
+    TAB3 "and reports its timing and error growth against the classic kernel (prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-q, --streams") " <N>" LF
+    TAB3 "Also runs C as independent slices of rows spread over N command queues (least-loaded)," LF
+    TAB3 "and reports the utilization of each queue (at most 16)." LFLF
+
+    TAB2 BOLD("-k, --split-k") " Auto | <Splits>" LF
+    TAB3 "Splits N over that many extra work-groups writing partial tiles of C, summed in a fixed" LF
+    TAB3 "order by a reduction kernel (default Auto, from the compute units and the shape, 1 disables it)." LFLF
+
+    TAB2 BOLD("-j, --jobs") " <Threads>" LF
+    TAB3 "Also submits the slices of rows from that many threads through the thread-safe submitter" LF
+    TAB3 "(coalesced into batches by its submission thread, at most 64)." LFLF
+
+    TAB2 BOLD("-n, --numa") LF
+    TAB3 "Also splits C by rows over the NUMA nodes of a CPU device (sub-devices by affinity domain)," LF
+    TAB3 "each node with its own queue and node-local buffers." LFLF
+
+    TAB2 BOLD("-B, --sparse-b") " <Density>" LF
+    TAB3 "Keeps a fraction (0, 1] of the elements of B, then also computes C from B in CSR with" LF
+    TAB3 "row-per-work-group and merge-based kernels (requires --init host)." LFLF
+
+    TAB2 BOLD("-e, --epilogue") " <Stage>[,<Stage>...]" LF
+    TAB3 "Fuses stages into the store of C instead of extra passes over C (prefix, case-insensitive):" LF
+    TAB3 "Alpha:<Scalar> and Beta:<Scalar> (C = alpha * A * B + beta * C), Bias:Rows | Bias:Columns," LF
+    TAB3 "ReLU | GELU | SiLU, Clamp:<Low>:<High>, then the storage of C, Half | Int8 (saturated)." LF
+    TAB3 "Only the classic product runs them, and only --cpu-check checks them." LFLF
 
     TAB2 BOLD("-c, --cpu-check") LF
     TAB3 "Checks the OpenCL result with a naive, potentially long, CPU implementation." LFLF
 
+    TAB2 BOLD("-r, --reference") " Host | Device" LF
+    TAB3 "Where the reference of the check is computed (implies --cpu-check, prefix, case-insensitive)." LF
+    TAB3 "Device runs a naive kernel and reduces the error statistics on the device." LFLF
+
+    TAB2 BOLD("-V, --verify") " Freivalds[:<Trials>][,Host | ,Device]" LF
+    TAB3 "Checks C = op(A) * op(B) with k randomized O(n²) trials (default 8, at most 65536, on the device)." LFLF
+
+    TAB2 BOLD("-R, --roofline") LF
+    TAB3 "Measures the FMA throughput and bandwidth ceilings of the device (see the roofline command)," LF
+    TAB3 "then displays the arithmetic intensity and percent of roofline of the kernel." LFLF
+
     TAB2 BOLD("-v, --verbose") LF
     TAB3 "Displays more informations (may appear multiple times)." LFLF
 
@@ -67,7 +462,27 @@ int MatMulContext_FromArguments(IN int argc, IN char* argv[], OUT MatMulContext*
     { "block-size", required_argument, NULL, 'b' },
     { "matrix-size", required_argument, NULL, 'm' },
     { "double-precision", no_argument, NULL, 'f' },
+    { "precision", required_argument, NULL, 'p' },
+    { "trans-a", no_argument, NULL, 't' },
+    { "trans-b", no_argument, NULL, 'T' },
+    { "specialize", no_argument, NULL, 's' },
+    { "local-tiles", required_argument, NULL, 'l' },
+    { "init", required_argument, NULL, 'i' },
+    { "seed", required_argument, NULL, 'S' },
+    { "memory", required_argument, NULL, 'M' },
+    { "operands", required_argument, NULL, 'o' },
+    { "huge-pages", no_argument, NULL, 'H' },
+    { "algorithm", required_argument, NULL, 'a' },
+    { "streams", required_argument, NULL, 'q' },
+    { "split-k", required_argument, NULL, 'k' },
+    { "jobs", required_argument, NULL, 'j' },
+    { "numa", no_argument, NULL, 'n' },
+    { "sparse-b", required_argument, NULL, 'B' },
+    { "epilogue", required_argument, NULL, 'e' },
     { "cpu-check", no_argument, NULL, 'c' },
+    { "reference", required_argument, NULL, 'r' },
+    { "verify", required_argument, NULL, 'V' },
+    { "roofline", no_argument, NULL, 'R' },
     { "verbose", no_argument, NULL, 'v' },
     { "help", no_argument, NULL, 'h' },
     { NULL, 0, NULL, 0 },
@@ -77,20 +492,80 @@ int MatMulContext_FromArguments(IN int argc, IN char* argv[], OUT MatMulContext*
   char const* device = NULL;
   char const* matrixSize = NULL;
   bool doublePrecision = false;
+  char const* precision = NULL;
   char const* blockSize = NULL;
+  char const* localTiles = NULL;
+  char const* initialization = NULL;
+  char const* seed = NULL;
+  char const* memory = NULL;
+  char const* operands = NULL;
+  char const* algorithm = NULL;
+  char const* sparse = NULL;
+  char const* streams = NULL;
+  char const* producers = NULL;
+  char const* splitK = NULL;
+  char const* reference = NULL;
+  char const* verify = NULL;
+  char const* epilogue = NULL;
 
-  this->blockSize = 16u; // Default.
+  this->blockSize = 0u; // Picked from the device capabilities.
+  this->transA = false;
+  this->transB = false;
+  this->specialize = false;
+  this->doubleBuffer = false;
+  this->padLocal = false;
+  this->deviceInit = false;
+  this->svm = false;
+  this->imageOperands = false;
+  this->hugePages = false;
+  this->arena = NULL;
+  this->seed = 0x5EEDu;
+  this->strassen = false;
+  this->strassenDepth = this->strassenMaxDepth = 0u;
+  this->streams = 1u;
+  this->producers = 0u;
+  this->numa = false;
+  this->gemv = false;
+  this->df64 = false;
+  this->splitK = 1u;
+  this->splitKAuto = true;
+  this->roofline = false;
+  this->epilogue = (MatMulEpilogue) { .enabled = false, .alpha = 1.0, .beta = 0.0 };
+  this->sparseDensity = 0.0;
   this->cpuCheck = false;
+  this->deviceReference = false;
+  this->freivalds = 0u;
+  this->freivaldsOnHost = false;
   this->verbose = 0u;
 
   opterr = 1; // Prints error on stderr.
-  while (0 <= (option = getopt_long(argc, argv, "d:b:m:fcvh", options, NULL))) {
+  while (0 <= (option = getopt_long(argc, argv, "d:b:m:fp:tTsl:i:S:M:o:Ha:q:k:j:nB:e:cr:V:Rvh", options, NULL))) {
     switch (option) {
       case 'd': device = optarg; break;
       case 'b': blockSize = optarg; break;
       case 'm': matrixSize = optarg; break;
+      case 't': this->transA = true; break;
+      case 'T': this->transB = true; break;
+      case 's': this->specialize = true; break;
+      case 'l': localTiles = optarg; break;
+      case 'i': initialization = optarg; break;
+      case 'S': seed = optarg; break;
+      case 'M': memory = optarg; break;
+      case 'o': operands = optarg; break;
+      case 'H': this->hugePages = true; break;
+      case 'a': algorithm = optarg; break;
+      case 'q': streams = optarg; break;
+      case 'k': splitK = optarg; break;
+      case 'j': producers = optarg; break;
+      case 'n': this->numa = true; break;
+      case 'R': this->roofline = true; break;
+      case 'B': sparse = optarg; break;
+      case 'e': epilogue = optarg; break;
       case 'c': this->cpuCheck = true; break;
-      case 'f': doublePrecision = true; break;
+      case 'r': reference = optarg; break;
+      case 'V': verify = optarg; break;
+      case 'f': doublePrecision = true; precision = NULL; break;
+      case 'p': precision = optarg; break;
       case 'v': this->verbose += 1u; break;
       case 'h':
         MatMulContext_ArgumentsUsage(stdout, argv[0]);
@@ -118,6 +593,274 @@ int MatMulContext_FromArguments(IN int argc, IN char* argv[], OUT MatMulContext*
     this->blockSize = size;
   }
 
+  if (precision != NULL) {
+    if (IsPrefix(precision, "DF64", 5)) {
+      this->df64 = true;
+      doublePrecision = false;
+    }
+    else if (IsPrefix(precision, "Double", 7)) {
+      doublePrecision = true;
+    }
+    else if (IsPrefix(precision, "Single", 7)) {
+      doublePrecision = false;
+    }
+    else {
+      fprintf(stderr, LF
+        "An invalid precision option has been found:" LF
+        TAB1 "--precision %s" LFLF
+        "The precision must be one of the following values (or prefix, case-insensitive):" LF
+        TAB1 "--precision Single | Double | DF64" LFLF
+        , precision
+      );
+
+      return false;
+    }
+  }
+
+  if (initialization != NULL) {
+    if (IsPrefix(initialization, "Device", 7)) {
+      this->deviceInit = true;
+    }
+    else if (!IsPrefix(initialization, "Host", 5)) {
+      fprintf(stderr, LF
+        "An invalid initialization option has been found:" LF
+        TAB1 "--init %s" LFLF
+        "The initialization must be one of the following values (or prefix, case-insensitive):" LF
+        TAB1 "--init Host | Device" LFLF
+        , initialization
+      );
+
+      return false;
+    }
+  }
+
+  if (memory != NULL) {
+    if (IsPrefix(memory, "SVM", 4)) {
+      this->svm = true;
+    }
+    else if (!IsPrefix(memory, "Buffer", 7)) {
+      fprintf(stderr, LF
+        "An invalid memory option has been found:" LF
+        TAB1 "--memory %s" LFLF
+        "The memory must be one of the following values (or prefix, case-insensitive):" LF
+        TAB1 "--memory Buffer | SVM" LFLF
+        , memory
+      );
+
+      return false;
+    }
+  }
+
+  if (operands != NULL) {
+    if (IsPrefix(operands, "Image", 6)) {
+      this->imageOperands = true;
+    }
+    else if (!IsPrefix(operands, "Buffer", 7)) {
+      fprintf(stderr, LF
+        "An invalid operands option has been found:" LF
+        TAB1 "--operands %s" LFLF
+        "The operands must be one of the following values (or prefix, case-insensitive):" LF
+        TAB1 "--operands Buffer | Image" LFLF
+        , operands
+      );
+
+      return false;
+    }
+  }
+
+  if (seed != NULL) {
+    char const* seedCursor = seed;
+    if (!ParseNumbers(&seedCursor, &this->seed, 1)) {
+      int padding = seedCursor > seed ? (int) (seedCursor - seed) + 1 : 0;
+      fprintf(stderr, LF
+        "The seed must be a positive number:" LF
+        TAB1 "--seed %s" LF
+        TAB1 "       %*c Unexpected character" LFLF
+        , seed, padding, '^'
+      );
+
+      return false;
+    }
+  }
+
+  if (algorithm != NULL && !ParseAlgorithm(algorithm, this)) {
+    fprintf(stderr, LF
+      "An invalid algorithm option has been found:" LF
+      TAB1 "--algorithm %s" LFLF
+      "The algorithm must be of the following form (or prefix, case-insensitive):" LF
+      TAB1 "--algorithm Classic | Strassen[:<Depth>] (with 1 <= Depth <= %u)" LFLF
+      , algorithm, TR_MATMUL_STRASSEN_MAX_DEPTH
+    );
+
+    return false;
+  }
+
+  if (streams != NULL) {
+    char const* streamsCursor = streams;
+    if (!ParseNumbers(&streamsCursor, &this->streams, 1) || this->streams == 0u || this->streams > TR_OPENCL_MAX_STREAMS) {
+      int padding = streamsCursor > streams ? (int) (streamsCursor - streams) + 1 : 0;
+      fprintf(stderr, LF
+        "The number of streams must be between 1 and %u:" LF
+        TAB1 "--streams %s" LF
+        TAB1 "          %*c Unexpected character or value" LFLF
+        , TR_OPENCL_MAX_STREAMS, streams, padding, '^'
+      );
+
+      return false;
+    }
+  }
+
+  if (splitK != NULL && !IsPrefix(splitK, "Auto", 5)) {
+    char const* splitKCursor = splitK;
+    this->splitKAuto = false;
+    if (!ParseNumbers(&splitKCursor, &this->splitK, 1) || this->splitK == 0u || this->splitK > TR_MATMUL_MAX_SPLITK) {
+      int padding = splitKCursor > splitK ? (int) (splitKCursor - splitK) + 1 : 0;
+      fprintf(stderr, LF
+        "The split-K must be Auto or a number of slices between 1 and %u:" LF
+        TAB1 "--split-k %s" LF
+        TAB1 "          %*c Unexpected character or value" LFLF
+        , TR_MATMUL_MAX_SPLITK, splitK, padding, '^'
+      );
+
+      return false;
+    }
+  }
+
+  if (producers != NULL) {
+    char const* producersCursor = producers;
+    if (!ParseNumbers(&producersCursor, &this->producers, 1) || this->producers == 0u || this->producers > TR_MATMUL_MAX_PRODUCERS) {
+      int padding = producersCursor > producers ? (int) (producersCursor - producers) + 1 : 0;
+      fprintf(stderr, LF
+        "The number of threads must be between 1 and %u:" LF
+        TAB1 "--jobs %s" LF
+        TAB1 "       %*c Unexpected character or value" LFLF
+        , TR_MATMUL_MAX_PRODUCERS, producers, padding, '^'
+      );
+
+      return false;
+    }
+  }
+
+  if (sparse != NULL) {
+    char* sparseCursor = NULL;
+    this->sparseDensity = strtod(sparse, &sparseCursor);
+    if (sparseCursor == sparse || *sparseCursor != '\0' || !(this->sparseDensity > 0.0 && this->sparseDensity <= 1.0)) {
+      fprintf(stderr, LF
+        "The density of the sparse B must be a number in (0, 1]:" LF
+        TAB1 "--sparse-b %s" LFLF
+        , sparse
+      );
+
+      return false;
+    }
+
+    // The CSR is built from the host copy of B.
+    if (this->deviceInit) {
+      fprintf(stderr, LF
+        "A sparse B is generated on the host, it cannot be combined with:" LF
+        TAB1 "--init Device" LFLF
+      );
+
+      return false;
+    }
+  }
+
+  if (reference != NULL) {
+    this->cpuCheck = true;
+    if (IsPrefix(reference, "Device", 7)) {
+      this->deviceReference = true;
+    }
+    else if (!IsPrefix(reference, "Host", 5)) {
+      fprintf(stderr, LF
+        "An invalid reference option has been found:" LF
+        TAB1 "--reference %s" LFLF
+        "The reference must be one of the following values (or prefix, case-insensitive):" LF
+        TAB1 "--reference Host | Device" LFLF
+        , reference
+      );
+
+      return false;
+    }
+  }
+
+  if (verify != NULL && !ParseVerification(verify, this)) {
+    fprintf(stderr, LF
+      "An invalid verification option has been found:" LF
+      TAB1 "--verify %s" LFLF
+      "The verification must be of the following form (or prefix, case-insensitive):" LF
+      TAB1 "--verify Freivalds[:<Trials>][,Host | ,Device]" LFLF
+      , verify
+    );
+
+    return false;
+  }
+
+  if (localTiles != NULL && !ParseLocalTiles(localTiles, this)) {
+    fprintf(stderr, LF
+      "An invalid local tiles option has been found:" LF
+      TAB1 "--local-tiles %s" LFLF
+      "The local tiles must be one of the following values (or prefix, case-insensitive):" LF
+      TAB1 "--local-tiles Single | Double[,Padded]" LFLF
+      , localTiles
+    );
+
+    return false;
+  }
+
+  // DF64 runs its own program (see `matrix/DF64.h`), only checked on the host.
+  if (this->df64 && (this->doubleBuffer || this->padLocal || this->imageOperands || this->strassen || this->streams > 1u || this->producers > 0u || this->numa
+    || this->sparseDensity > 0.0 || this->freivalds > 0u || this->deviceReference || this->svm || this->deviceInit)) {
+    fprintf(stderr, LF
+      "The emulated double-precision cannot be combined with the other algorithms and checks:" LF
+      TAB1 "--precision DF64" LFLF
+      "It only runs the classic product, initialized on the host and checked on the host, without:" LF
+      TAB1 "--local-tiles, --operands image, --algorithm, --streams, --jobs, --numa, --sparse-b," LF
+      TAB1 "--verify, --reference device, --memory svm and --init device." LFLF
+    );
+
+    return false;
+  }
+
+  if (epilogue != NULL && !ParseEpilogue(epilogue, this)) {
+    fprintf(stderr, LF
+      "An invalid epilogue option has been found:" LF
+      TAB1 "--epilogue %s" LFLF
+      "The epilogue must be a comma-separated list of the following stages (or prefix, case-insensitive):" LF
+      TAB1 "Alpha:<Scalar>, Beta:<Scalar>, Bias:Rows | Bias:Columns, ReLU | GELU | SiLU," LF
+      TAB1 "Clamp:<Low>:<High> (with Low <= High), Half | Int8" LFLF
+      , epilogue
+    );
+
+    return false;
+  }
+
+  // The epilogue is only fused into the classic kernel, whose C is the final one.
+  if (this->epilogue.enabled && (this->df64 || this->strassen || this->streams > 1u || this->producers > 0u
+    || this->numa || this->sparseDensity > 0.0 || this->freivalds > 0u || this->deviceReference || this->svm
+    || (!this->splitKAuto && this->splitK > 1u))) {
+    fprintf(stderr, LF
+      "The fused epilogue cannot be combined with the other algorithms and checks:" LF
+      TAB1 "--epilogue %s" LFLF
+      "It only runs the classic product, checked on the host, without:" LF
+      TAB1 "--precision DF64, --algorithm, --streams, --split-k, --jobs, --numa, --sparse-b," LF
+      TAB1 "--verify, --reference device and --memory svm." LFLF
+      , epilogue
+    );
+
+    return false;
+  }
+
+  // Beta reads C in the format of the operands.
+  if (this->epilogue.beta != 0.0 && this->epilogue.output != MatMulOutput_Real) {
+    fprintf(stderr, LF
+      "Beta reads the previous C, which cannot be stored as Half or Int8:" LF
+      TAB1 "--epilogue %s" LFLF
+      , epilogue
+    );
+
+    return false;
+  }
+
   size_t sizes[3] = { 0u, 0u, 0u };
   char const* matrixCursor = matrixSize;
   if (matrixSize == NULL || !ParseNumbers(&matrixCursor, sizes, 3)) {
@@ -137,10 +880,6 @@ int MatMulContext_FromArguments(IN int argc, IN char* argv[], OUT MatMulContext*
   this->N = sizes[1];
   this->P = sizes[2];
 
-  this->paddingM = RoundUp(this->M, this->blockSize) - this->M;
-  this->paddingN = RoundUp(this->N, this->blockSize) - this->N;
-  this->paddingP = RoundUp(this->P, this->blockSize) - this->P;
-
   if (device == NULL) { device = "GPU"; }
   switch (OpenClContext_FromString(device, &this->openCl)) {
     case 1: break; // Ok, true
@@ -150,7 +889,7 @@ int MatMulContext_FromArguments(IN int argc, IN char* argv[], OUT MatMulContext*
         "An invalid OpenCL device option has been found:" LF
         TAB1 "--device %s" LFLF
         "A device must be one of the following values (or prefix, case-insensitive):" LF
-        TAB1 "--device GPU | GPU | Default | <PlatformIndex>:<DeviceIndex>" LFLF
+        TAB1 "--device GPU | CPU | Default | Fastest | <PlatformIndex>:<DeviceIndex>" LFLF
         , device
       );
 
@@ -170,6 +909,53 @@ int MatMulContext_FromArguments(IN int argc, IN char* argv[], OUT MatMulContext*
     return false;
   }
 
+  size_t elementSize = MatMulContext_ElementSize(this);
+  if (this->blockSize == 0u) {
+    this->blockSize = MatMulContext_DefaultBlockSize(&this->openCl.capabilities, elementSize
+      , this->doubleBuffer, this->padLocal);
+  }
+
+  // Every Strassen-Winograd level halves the matrixes, down to whole blocks.
+  if (this->strassen) {
+    this->strassenMaxDepth = this->strassenDepth;
+    if (this->strassenDepth == 0u) {
+      size_t smallest = this->M < this->N ? this->M : this->N;
+      smallest = smallest < this->P ? smallest : this->P;
+      while (this->strassenMaxDepth < TR_MATMUL_STRASSEN_AUTO_DEPTH
+        && (this->blockSize << (this->strassenMaxDepth + 2u)) <= smallest) {
+        this->strassenMaxDepth += 1u;
+      }
+    }
+  }
+
+  // Vector-shaped products run the GEMV kernels, which need no padding,
+  // unless they are split over tiles by the other algorithms (or the tiled
+  // kernel is explicitly asked for, with an epilogue or other local tiles).
+  this->gemv = (this->M == 1u || this->P == 1u) && !this->df64
+    && !this->strassen && this->streams == 1u && this->producers == 0u
+    && !this->numa && this->sparseDensity == 0.0 && !this->epilogue.enabled
+    && !this->doubleBuffer && !this->padLocal && !this->imageOperands;
+
+  size_t multiple = this->gemv ? 1u : this->blockSize << this->strassenMaxDepth;
+  this->paddingM = RoundUp(this->M, multiple) - this->M;
+  this->paddingN = RoundUp(this->N, multiple) - this->N;
+  this->paddingP = RoundUp(this->P, multiple) - this->P;
+
+  if (this->gemv) {
+    this->splitK = 1u;
+  }
+  else if (this->splitKAuto && !this->df64 && !this->epilogue.enabled) {
+    this->splitK = AutoSplitK(this, elementSize);
+  }
+
+  if (!CheckCapabilities(this, elementSize) || !OpenClContext_CreateStreams(&this->openCl, this->streams)) {
+    if (!OpenClContext_Release(&this->openCl)) {
+      TR_ERROR("OpenClContext_Release() failed");
+    }
+
+    return false;
+  }
+
   return true;
 }
 
@@ -185,7 +971,55 @@ size_t MatMulContext_ComputeWaste(IN MatMulContext const* this) {
   size_t wasteA = (this->paddingM * this->N) + (this->paddingN * this->M) + (this->paddingM * this->paddingN);
   size_t wasteB = (this->paddingN * this->P) + (this->paddingP * this->N) + (this->paddingN * this->paddingP);
   size_t wasteC = (this->paddingM * this->P) + (this->paddingP * this->M) + (this->paddingM * this->paddingP);
-  return (wasteA + wasteB + wasteC) * (this->openCl.fp64Extension ? sizeof(double) : sizeof(float));
+  return (wasteA + wasteB + wasteC) * MatMulContext_ElementSize(this);
+}
+
+size_t MatMulContext_ElementSize(IN MatMulContext const* this) {
+  assert(this != NULL);
+  return this->df64 || this->openCl.fp64Extension ? sizeof(double) : sizeof(float);
+}
+
+size_t MatMulContext_OutputSize(IN MatMulContext const* this) {
+  assert(this != NULL);
+  switch (this->epilogue.output) {
+    case MatMulOutput_Half: return 2u;
+    case MatMulOutput_Int8: return 1u;
+    default: return MatMulContext_ElementSize(this);
+  }
+}
+
+bool MatMulContext_FitsBlockSize(
+  IN OpenClCapabilities const* capabilities,
+  IN size_t blockSize, IN size_t elementSize,
+  IN bool doubleBuffer, IN bool padLocal, IN cl_ulong localMemory)
+{
+  assert(capabilities != NULL);
+  size_t const* items = capabilities->maxWorkItemSizes;
+  return (capabilities->maxWorkGroupSize == 0u || blockSize * blockSize <= capabilities->maxWorkGroupSize)
+    && (items[0] == 0u || blockSize <= items[0]) && (items[1] == 0u || blockSize <= items[1])
+    && (localMemory == 0u || LocalTileBytes(blockSize, elementSize, doubleBuffer, padLocal) <= localMemory);
+}
+
+size_t MatMulContext_DefaultBlockSize(
+  IN OpenClCapabilities const* capabilities,
+  IN size_t elementSize, IN bool doubleBuffer, IN bool padLocal)
+{
+  assert(capabilities != NULL);
+  size_t blockSize = TR_MATMUL_MAX_DEFAULT_BLOCK_SIZE;
+  while (blockSize > 2u && !MatMulContext_FitsBlockSize(capabilities, blockSize, elementSize
+    , doubleBuffer, padLocal, capabilities->localMemorySize / 2u))
+  {
+    blockSize /= 2u;
+  }
+
+  return blockSize;
+}
+
+char const* MatMulContext_LocalTileOptions(IN MatMulContext const* this) {
+  assert(this != NULL);
+  return this->doubleBuffer
+    ? (this->padLocal ? " -DMATMUL_DOUBLE_BUFFER -DMATMUL_LOCAL_PAD=1" : " -DMATMUL_DOUBLE_BUFFER")
+    : (this->padLocal ? " -DMATMUL_LOCAL_PAD=1" : "");
 }
 
 bool MatMulContext_Display(IN MatMulContext* this) {
@@ -197,6 +1031,45 @@ bool MatMulContext_Display(IN MatMulContext* this) {
 
   size_t waste = MatMulContext_ComputeWaste(this);
 
+  char algorithm[64] = "Classic";
+  if (this->gemv) {
+    snprintf(algorithm, sizeof(algorithm), "GEMV (%s)", this->P == 1u ? "matrix-vector" : "vector-matrix");
+  }
+  else if (this->strassen && this->strassenDepth > 0u) {
+    snprintf(algorithm, sizeof(algorithm), "Classic and Strassen-Winograd (depth %zu)", this->strassenDepth);
+  }
+  else if (this->strassen) {
+    snprintf(algorithm, sizeof(algorithm), "Classic and Strassen-Winograd (depth <= %zu, timed)", this->strassenMaxDepth);
+  }
+
+  char sparsity[32] = "False";
+  if (this->sparseDensity > 0.0) {
+    snprintf(sparsity, sizeof(sparsity), "%g%% of B (CSR)", 100.0 * this->sparseDensity);
+  }
+
+  char verification[64] = "False";
+  if (this->freivalds > 0u) {
+    snprintf(verification, sizeof(verification), "%zu trial%s on the %s"
+      , this->freivalds, this->freivalds >= 2u ? "s" : "", this->freivaldsOnHost ? "host" : "device");
+  }
+
+  char epilogue[160] = "False";
+  if (this->epilogue.enabled) {
+    static char const* const biases[] = { "", ", bias of rows", ", bias of columns" };
+    static char const* const activations[] = { "", ", ReLU", ", GELU", ", SiLU" };
+    static char const* const outputs[] = { "", ", half", ", int8" };
+    MatMulEpilogue const* stages = &this->epilogue;
+
+    int length = snprintf(epilogue, sizeof(epilogue), "alpha %g, beta %g%s%s"
+      , stages->alpha, stages->beta, biases[stages->bias], activations[stages->activation]);
+    if (stages->clamp && length > 0 && (size_t) length < sizeof(epilogue)) {
+      length += snprintf(epilogue + length, sizeof(epilogue) - (size_t) length, ", clamp [%g, %g]", stages->low, stages->high);
+    }
+    if (length > 0 && (size_t) length < sizeof(epilogue)) {
+      snprintf(epilogue + length, sizeof(epilogue) - (size_t) length, "%s", outputs[stages->output]);
+    }
+  }
+
   printf(
     TAB0 "Matrix Multiplication:" LF
 
@@ -206,7 +1079,23 @@ bool MatMulContext_Display(IN MatMulContext* this) {
     TAB1 "P.Dimension.(+padding).: %zu (+%zu)" LF
     TAB1 "Total.Waste............: %zu Byte%c" LF
     TAB1 "Floating-Point.Format..: %s-Precision (%s)" LF
+    TAB1 "Operation..............: C = A%s * B%s (%c%c)" LF
+    TAB1 "Shape.Specialization...: %s" LF
+    TAB1 "Local.Tiles............: %s%s" LF
+    TAB1 "Initialization.........: %s (seed %zu)" LF
+    TAB1 "Memory.................: %s" LF
+    TAB1 "Operands...............: %s" LF
+    TAB1 "Host.Huge.Pages........: %s" LF
+    TAB1 "Algorithm..............: %s" LF
+    TAB1 "Streams................: %zu" LF
+    TAB1 "Split-K................: %zu%s" LF
+    TAB1 "Submitter.Threads......: %zu" LF
+    TAB1 "NUMA.Split.............: %s" LF
+    TAB1 "Sparse.Product.........: %s" LF
+    TAB1 "Epilogue...............: %s" LF
     TAB1 "CPU.Check..............: %s" LF
+    TAB1 "Freivalds.Check........: %s" LF
+    TAB1 "Roofline...............: %s" LF
     TAB1 "Verbose.Level..........: %zu" LFLF
 
     , this->blockSize
@@ -214,9 +1103,30 @@ bool MatMulContext_Display(IN MatMulContext* this) {
     , this->N, this->paddingN
     , this->P, this->paddingP
     , waste, waste >= 2 ? 's' : ' '
-    , this->openCl.fp64Extension ? "Double" : "Single"
-    , this->openCl.fp64Extension ? "double" : "float"
-    , this->cpuCheck ? "True" : "False"
+    , this->df64 ? "Emulated-Double" : this->openCl.fp64Extension ? "Double" : "Single"
+    , this->df64 ? "float2" : this->openCl.fp64Extension ? "double" : "float"
+    , this->transA ? "^T" : "", this->transB ? "^T" : ""
+    , this->transA ? 'T' : 'N', this->transB ? 'T' : 'N'
+    , this->specialize ? "True" : "False"
+    , this->doubleBuffer ? "Double-buffered" : "Single", this->padLocal ? " (padded)" : ""
+    , this->deviceInit ? "Device" : "Host", this->seed
+    , !this->svm ? "Buffer"
+    : this->openCl.capabilities.svmCapabilities & CL_DEVICE_SVM_FINE_GRAIN_BUFFER ? "SVM (fine-grained)"
+    : "SVM (coarse-grained)"
+    , !this->imageOperands ? "Buffer"
+    : this->openCl.capabilities.imagePitchAlignment > 0u ? "Image (views of the buffers)"
+    : "Image (copies of the buffers)"
+    , this->hugePages ? "True" : "False"
+    , algorithm
+    , this->streams
+    , this->splitK, this->splitKAuto ? " (auto)" : ""
+    , this->producers
+    , this->numa ? "True" : "False"
+    , sparsity
+    , epilogue
+    , !this->cpuCheck ? "False" : this->deviceReference ? "True (device reference)" : "True (host reference)"
+    , verification
+    , this->roofline ? "True" : "False"
     , this->verbose
   );
 
@@ -7,19 +7,73 @@
 #include <stddef.h> // size_t
 #include <stdio.h> // FILE
 
+#include "common/HostArena.h" // HostArena{}
 #include "common/OpenClContext.h" // OpenClContext{}
 #include "common/helper.h" // IN, INOUT, OUT, TR_PRINT()
 
 #define TR_MATMUL_LOG(CONTEXT, LEVEL, FORMAT, ...) \
   if (LEVEL <= CONTEXT->verbose) { TR_PRINT(FORMAT, ##__VA_ARGS__); }
 
+/// Maximum depth of the Strassen-Winograd recursion (`--algorithm strassen:<Depth>`).
+#define TR_MATMUL_STRASSEN_MAX_DEPTH 8u
+
+/// Maximum number of producer threads of `--jobs <Threads>`.
+#define TR_MATMUL_MAX_PRODUCERS 64u
+
+/// Maximum number of slices of N of `--split-k <Splits>`.
+#define TR_MATMUL_MAX_SPLITK 64u
+
+///
+/// The bias added by the fused epilogue (see `MatMulEpilogue`).
+///
+typedef enum MatMulBias {
+  MatMulBias_None,
+  MatMulBias_Rows, ///< One value per row of C (M values).
+  MatMulBias_Columns, ///< One value per column of C (P values).
+} MatMulBias;
+
+///
+/// The activation applied by the fused epilogue (see `MatMulEpilogue`).
+///
+typedef enum MatMulActivation {
+  MatMulActivation_None,
+  MatMulActivation_Relu, ///< `max(x, 0)`
+  MatMulActivation_Gelu, ///< `x * (1 + erf(x / sqrt(2))) / 2`
+  MatMulActivation_Silu, ///< `x / (1 + exp(-x))`
+} MatMulActivation;
+
+///
+/// The storage format of C written by the fused epilogue (see `MatMulEpilogue`).
+///
+typedef enum MatMulOutput {
+  MatMulOutput_Real, ///< Same as the operands.
+  MatMulOutput_Half, ///< 16-bit floats, rounded to nearest even.
+  MatMulOutput_Int8, ///< 8-bit signed integers, rounded to nearest even and saturated.
+} MatMulOutput;
+
+///
+/// The stages fused into the store of the MatMul kernel (`--epilogue`, see
+/// `matrix/MatMul.cl`), applied in this order:
+/// `C = output(clamp(activation(alpha * op(A) * op(B) + beta * C + bias), low, high))`.
+///
+typedef struct MatMulEpilogue {
+  bool enabled;
+  double alpha, beta;
+  MatMulBias bias;
+  MatMulActivation activation;
+  bool clamp;
+  double low, high;
+  MatMulOutput output;
+} MatMulEpilogue;
+
 ///
 /// Gather all the parameters to run the matrix multiplication.
 ///
 typedef struct MatMulContext {
   OpenClContext openCl;
 
-  /// The block size of the blocked matrix multiplication (must be even).
+  /// The block size of the blocked matrix multiplication (must be even), by
+  /// default the largest fitting the device (see `OpenClCapabilities`).
   size_t blockSize;
 
   /// Contains the matrix sizes with their padding.
@@ -28,10 +82,105 @@ typedef struct MatMulContext {
   size_t N, paddingN;
   size_t P, paddingP;
 
+  /// Whether A and/or B are given transposed, i.e. C = op(A) * op(B) where
+  /// A is stored as (N, M) instead of (M, N) and B as (P, N) instead of (N, P).
+  bool transA, transB;
+
+  /// Whether or not to bake the matrix shapes and leading dimensions into the
+  /// OpenCL program (one build per shape, kept in the program cache).
+  bool specialize;
+
+  /// The local tiles of the MatMul kernel (`--local-tiles`, see `matrix/MatMul.cl`):
+  /// whether they are double-buffered, the global loads of the next step being
+  /// issued before the products of the current one (a single barrier per step),
+  /// and whether their rows are padded by one element against bank conflicts.
+  bool doubleBuffer, padLocal;
+
+  /// Whether A and B are generated by an OpenCL kernel directly in the device
+  /// buffers (`--init device`) or on the host then uploaded (`--init host`).
+  /// Both produce bit-identical values for a given `seed`.
+  bool deviceInit;
+
+  /// Whether A, B and C are allocated in shared virtual memory (`--memory svm`)
+  /// rather than in buffers (`--memory buffer`), then written and read in
+  /// place by the host, without copies (see `Matrix(NewWithSvmMemory)()`).
+  bool svm;
+
+  /// Whether the MatMul kernel reads A and B through `CL_RGBA`/`CL_FLOAT` 2D
+  /// images, 4 elements per texel (`--operands image`), i.e. the texture cache,
+  /// instead of buffers. The images are views of the buffers when the device
+  /// supports cl_khr_image2d_from_buffer, copies otherwise.
+  bool imageOperands;
+
+  /// Whether the host arena of the operands asks for huge pages (`--huge-pages`),
+  /// and the arena itself while the program runs (see `common/HostArena.h`).
+  bool hugePages;
+  HostArena* arena;
+
+  /// Seed of the counter-based random number generator (see `common/philox.h`).
+  size_t seed;
+
+  /// Whether C is also computed with the Strassen-Winograd recursion, then
+  /// compared with the classic kernel (`--algorithm strassen[:<Depth>]`).
+  /// A `strassenDepth` of 0 is picked from timings up to `strassenMaxDepth`,
+  /// the paddings being multiples of `blockSize << strassenMaxDepth`.
+  bool strassen;
+  size_t strassenDepth, strassenMaxDepth;
+
+  /// Number of command queues (`--streams <N>`), more than one also runs the
+  /// product as independent slices of rows spread over the queues (see
+  /// `matrix/Streams.h`).
+  size_t streams;
+
+  /// Number of threads submitting the slices of rows through the submitter
+  /// (`--jobs <Threads>`, see `common/Submitter.h`), 0 skips it.
+  size_t producers;
+
+  /// Number of slices of N computed by separate work-groups into partial C
+  /// tiles, then summed by a reduction kernel (`--split-k`, see `matrix/MatMul.cl`),
+  /// 1 disables it. Picked from the compute units and the shape unless given.
+  size_t splitK;
+  bool splitKAuto;
+
+  /// Whether the values are emulated double-precision, pairs of floats
+  /// (`--precision DF64`, see `matrix/DF64.h`), for devices without fp64.
+  bool df64;
+
+  /// Whether the product is vector-shaped (M or P is 1), then computed by the
+  /// GEMV kernels without padding (see `matrix/Gemv.cl`), chosen automatically.
+  bool gemv;
+
+  /// Whether the product is also split by whole blocks of rows over the NUMA
+  /// nodes of the device (`--numa`, see `matrix/Numa.h`).
+  bool numa;
+
+  /// Density of the non-zeros of B in (0, 1] (`--sparse-b <Density>`), the
+  /// product is then also computed from B in CSR (see `matrix/SpMM.h`).
+  /// 0 keeps B dense.
+  double sparseDensity;
+
   /// Whether or not to check the matrix multiplication with a naive,
   /// potentially long, CPU implementation.
   bool cpuCheck;
 
+  /// Whether the reference of the above check is computed by a naive OpenCL
+  /// kernel and compared on the device (`--reference device`), C is then
+  /// never read back for the check (see `matrix/Compare.h`).
+  bool deviceReference;
+
+  /// Number of Freivalds trials verifying C in O(n²) (`--verify freivalds[:k]`),
+  /// 0 disables the verification, and whether it runs on the host threads
+  /// instead of the device (see `matrix/Freivalds.h`).
+  size_t freivalds;
+  bool freivaldsOnHost;
+
+  /// The stages fused into the store of C, instead of separate passes over C.
+  MatMulEpilogue epilogue;
+
+  /// Whether the ceilings of the device are measured to place the kernel on
+  /// its roofline (`--roofline`, see `common/Roofline.h`).
+  bool roofline;
+
   /// Verbose level.
   size_t verbose;
 } MatMulContext;
@@ -72,6 +221,55 @@ bool MatMulContext_Release(INOUT MatMulContext* context);
 ///
 size_t MatMulContext_ComputeWaste(IN MatMulContext const* this);
 
+///
+/// Returns the size of the elements of the matrixes (float, double, or the
+/// pair of floats of DF64).
+///
+/// @pre `context` is not NULL and initialized.
+///
+size_t MatMulContext_ElementSize(IN MatMulContext const* context);
+
+///
+/// Returns the size of the elements of C as stored by the kernel (see
+/// `MatMulOutput`).
+///
+/// @pre `context` is not NULL and initialized.
+///
+size_t MatMulContext_OutputSize(IN MatMulContext const* context);
+
+///
+/// Checks if the `BS x BS` work-groups of the MatMul kernel (or of a kernel with
+/// the same tiles, e.g. `conv/Conv2d.cl`) fit in the device limits, with their
+/// local tiles (see `--local-tiles`) in `localMemory` bytes. The unknown limits
+/// (0) are ignored.
+///
+/// @pre `capabilities` is not NULL.
+///
+bool MatMulContext_FitsBlockSize(
+  IN OpenClCapabilities const* capabilities,
+  IN size_t blockSize, IN size_t elementSize,
+  IN bool doubleBuffer, IN bool padLocal, IN cl_ulong localMemory);
+
+///
+/// Returns the largest power of 2 block size (up to 32) whose work-groups fit
+/// in the device, keeping half of the local memory so that at least two of
+/// them may be resident on a compute unit (the `--block-size` default).
+///
+/// @pre `capabilities` is not NULL.
+///
+size_t MatMulContext_DefaultBlockSize(
+  IN OpenClCapabilities const* capabilities,
+  IN size_t elementSize, IN bool doubleBuffer, IN bool padLocal);
+
+///
+/// Returns the build options of the local tiles of the MatMul kernel (e.g.
+/// `" -DMATMUL_DOUBLE_BUFFER"`), to be appended by every program built from
+/// `matrix/MatMul.cl`, empty for the single unpadded tiles.
+///
+/// @pre `context` is not NULL.
+///
+char const* MatMulContext_LocalTileOptions(IN MatMulContext const* context);
+
 ///
 /// Displays informations about the given context.
 ///
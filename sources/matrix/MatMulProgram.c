@@ -23,19 +23,274 @@
 #include <CL/opencl.h> // Khronos API
 
 #include <assert.h> // assert()
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+#include <limits.h> // UINT_MAX
+#include <math.h> // fabs(), erf(), exp(), ldexp(), rint()
 #include <stdbool.h> // bool, true, false
-#include <stdio.h> // printf()
+#include <stdarg.h> // va_list, va_start(), va_end()
+#include <stdio.h> // printf(), vsnprintf()
+#include <stdint.h> // uint32_t, uint64_t
+#include <string.h> // strlen(), memcpy()
 
 #include "common/helper.h" // IN, TR_CONCAT, TR_PRINT(), TR_FAILED()
+#include "common/HostArena.h" // HostArena_Fill(), HostArena_Touch()
 #include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/philox.h" // PhiloxElement(), PhiloxToFloat(), PhiloxToDouble()
+#include "common/ProgramCache.h" // ProgramCache_BuildAsync(), ProgramCache_WaitKernel()
+#include "common/Roofline.h" // Roofline_Measure(), Roofline_Display()
+#include "common/timer.h" // TimerNow()
+#include "matrix/DF64.h" // DF64_Run()
 #include "matrix/MatMulContext.h" // Self{}
 #include "matrix/MatMulProgram.h" // Self{}
+#include "matrix/RandomStreams.h" // TR_STREAM_A, TR_STREAM_B, TR_STREAM_C, TR_STREAM_BIAS
 
-#define MATMULBLOCKSIZE 16u // TOOD: 16 so far.
 #define RUNMATMULPROGRAM(TYPE) TR_JOIN2(_, RunMatMulProgram, TYPE)
+#define CHECKMATMUL(TYPE) TR_JOIN2(_, CheckMatMul, TYPE)
+#define FILLMATRIX(TYPE) TR_JOIN2(_, FillMatrix, TYPE)
+#define FILLROWS(TYPE) TR_JOIN2(_, FillRows, TYPE)
+#define FILLTASK(TYPE) TR_JOIN2(_, FillTask, TYPE)
+#define SETEPILOGUEARGUMENTS(TYPE) TR_JOIN2(_, SetEpilogueArguments, TYPE)
+#define TIMEBUFFEROPERANDS(TYPE) TR_JOIN2(_, TimeBufferOperands, TYPE)
 
 // Define matrixMatMulStart and matrixMatMulEnd.
 TR_OPENCL_IMPORT(matrix, MatMul)
+// Define matrixRandomStart and matrixRandomEnd.
+TR_OPENCL_IMPORT(matrix, Random)
+// Define matrixGemvStart and matrixGemvEnd.
+TR_OPENCL_IMPORT(matrix, Gemv)
+
+/// Work-group size of the GEMV kernels (halved down to the device limit).
+#define TR_MATMUL_GEMV_GROUP 128u
+
+/// Global size multiple of the split-K reduction (its work-group size is left to the driver).
+#define TR_MATMUL_REDUCE_GROUP 64u
+
+///
+/// How a vector-shaped product is mapped on a GEMV kernel (see `matrix/Gemv.cl`):
+/// the matrix operand X (A or B) is walked by rows (`GemvRows`, one work-group
+/// per row) when its rows are the dot products, by columns (`GemvColumns`)
+/// otherwise, and multiplied with the vector operand.
+///
+typedef struct GemvLaunch {
+  char const* kernelName;
+  cl_uint rows, columns, ld;
+  bool matrixIsA;
+  size_t globalSize, localSize;
+} GemvLaunch;
+
+static GemvLaunch GetGemvLaunch(IN MatMulContext const* this) {
+  assert(this != NULL && this->gemv);
+
+  size_t group = TR_MATMUL_GEMV_GROUP;
+  size_t limit = this->openCl.capabilities.maxWorkGroupSize;
+  while (limit != 0u && group > limit && group > 1u) { group /= 2u; }
+
+  GemvLaunch launch = { .localSize = group };
+  cl_uint M = (cl_uint) this->M, N = (cl_uint) this->N, P = (cl_uint) this->P;
+
+  // C = op(A) * b: the rows of A are the dot products unless A is stored (N, M).
+  // C = a * op(B): the columns of B are the dot products unless B is stored (P, N).
+  launch.matrixIsA = this->P == 1u && this->M != 1u;
+  bool byRows = launch.matrixIsA ? !this->transA : this->transB;
+
+  launch.kernelName = byRows ? "GemvRows" : "GemvColumns";
+  launch.rows = byRows ? (launch.matrixIsA ? M : P) : N;
+  launch.columns = byRows ? N : (launch.matrixIsA ? M : P);
+  launch.ld = launch.columns;
+
+  size_t items = byRows ? (size_t) launch.rows * group : ((size_t) launch.columns + 3u) / 4u;
+  launch.globalSize = (items + group - 1u) / group * group;
+  return launch;
+}
+
+///
+/// Appends a formatted build option to `options` of `size` bytes.
+///
+/// @returns `false` if the buffer is too small (then `options` is truncated).
+///
+__attribute__((format(printf, 3, 4)))
+static bool AppendOption(INOUT char* options, IN size_t size, IN char const* format, ...) {
+  assert(options != NULL && format != NULL);
+
+  size_t length = strlen(options);
+  if (length >= size) { return false; }
+
+  va_list arguments;
+  va_start(arguments, format);
+  int written = vsnprintf(options + length, size - length, format, arguments);
+  va_end(arguments);
+
+  return written >= 0 && (size_t) written < size - length;
+}
+
+///
+/// Enqueues the `FillRandom` kernel (see `matrix/Random.cl`) on the given buffer.
+///
+/// @param shape { rows, rowPadding, columns, columnPadding }
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool EnqueueFillRandom(
+  IN cl_command_queue queue, IN cl_kernel kernel,
+  IN size_t const shape[4], IN uint32_t stream, IN uint64_t seed,
+  OUT cl_mem buffer)
+{
+  assert(queue != NULL && kernel != NULL && buffer != NULL);
+
+  cl_uint arguments[5] = {
+    (cl_uint) shape[0], (cl_uint) shape[2], stream,
+    (cl_uint) seed, (cl_uint) (seed >> 32),
+  };
+
+  cl_int error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < 5u; ++index) {
+    error |= clSetKernelArg(kernel, index, sizeof(cl_uint), &arguments[index]);
+  }
+
+  error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &buffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(FillRandom)", error);
+    return false;
+  }
+
+  size_t globalSize[2] = { shape[2] + shape[3], shape[0] + shape[1] }; // (columns, rows)
+  error = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, globalSize, NULL, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(FillRandom)", error);
+    return false;
+  }
+
+  return true;
+}
+
+///
+/// Appends the build options of the epilogue, if any (see `Store()` in `matrix/MatMul.cl`).
+///
+/// @returns `false` if the buffer is too small (then `options` is truncated).
+///
+static bool AppendEpilogueOptions(IN MatMulContext const* this, INOUT char* options, IN size_t size) {
+  assert(this != NULL && options != NULL);
+
+  MatMulEpilogue const* stages = &this->epilogue;
+  if (!stages->enabled) {
+    return true;
+  }
+
+  static char const* const biases[] = { "", " -DMATMUL_BIAS_ROWS", " -DMATMUL_BIAS_COLUMNS" };
+  static char const* const activations[] = { "", " -DMATMUL_RELU", " -DMATMUL_GELU", " -DMATMUL_SILU" };
+  static char const* const outputs[] = { "", " -DMATMUL_OUTPUT_HALF", " -DMATMUL_OUTPUT_INT8" };
+
+  // The stages left to their neutral value are not compiled at all.
+  return AppendOption(options, size, " -DMATMUL_EPILOGUE%s%s%s%s%s%s"
+    , stages->alpha != 1.0 ? " -DMATMUL_ALPHA" : ""
+    , stages->beta != 0.0 ? " -DMATMUL_BETA" : ""
+    , biases[stages->bias]
+    , activations[stages->activation]
+    , stages->clamp ? " -DMATMUL_CLAMP" : ""
+    , outputs[stages->output]
+  );
+}
+
+///
+/// Creates a `CL_RGBA`/`CL_FLOAT` image of a row-major `(rows, columns)` buffer
+/// of floats, 4 elements per texel: a view of the buffer (cl_khr_image2d_from_buffer)
+/// when its rows fit the pitch alignment of the device, a copy otherwise
+/// (enqueued on `queue`, after the commands filling the buffer).
+///
+/// @returns The image to release with `clReleaseMemObject()`, NULL on failure.
+///
+static cl_mem CreateOperandImage(
+  IN OpenClContext const* openCl, IN cl_command_queue queue,
+  IN cl_mem buffer, IN size_t rows, IN size_t columns)
+{
+  assert(openCl != NULL && queue != NULL && buffer != NULL);
+  assert(columns % 4u == 0u);
+
+  cl_int error;
+  cl_image_format const format = { .image_channel_order = CL_RGBA, .image_channel_data_type = CL_FLOAT };
+  cl_image_desc description = { .image_type = CL_MEM_OBJECT_IMAGE2D, .image_width = columns / 4u, .image_height = rows };
+
+  size_t rowBytes = columns * sizeof(float);
+  size_t alignment = (size_t) openCl->capabilities.imagePitchAlignment * 4u * sizeof(float);
+  if (alignment > 0u && rowBytes % alignment == 0u) {
+    description.image_row_pitch = rowBytes;
+    description.buffer = buffer;
+
+    cl_mem image = clCreateImage(openCl->context, CL_MEM_READ_ONLY, &format, &description, NULL, &error);
+    if (error == CL_SUCCESS && image != NULL) {
+      return image;
+    }
+
+    // Some drivers list the extension but reject some buffers, copy them then.
+    description.image_row_pitch = 0u;
+    description.buffer = NULL;
+  }
+
+  cl_mem image = clCreateImage(openCl->context, CL_MEM_READ_ONLY, &format, &description, NULL, &error);
+  if (error != CL_SUCCESS || image == NULL) {
+    TR_FAILED("clCreateImage()", error);
+    return NULL;
+  }
+
+  size_t const origin[3] = { 0u, 0u, 0u };
+  size_t const region[3] = { columns / 4u, rows, 1u };
+  error = clEnqueueCopyBufferToImage(queue, buffer, image, 0u, origin, region, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueCopyBufferToImage()", error);
+    clReleaseMemObject(image);
+    return NULL;
+  }
+
+  return image;
+}
+
+///
+/// Decodes an IEEE 754 binary16 (the `half` stored by `vstore_half`).
+///
+static double HalfToDouble(IN uint16_t bits) {
+  double sign = (bits & 0x8000u) != 0u ? -1.0 : 1.0;
+  int exponent = (int) ((bits >> 10) & 0x1Fu);
+  int mantissa = (int) (bits & 0x3FFu);
+
+  if (exponent == 0) { return sign * ldexp((double) mantissa, -24); } // Subnormal.
+  if (exponent == 31) { return mantissa == 0 ? sign * HUGE_VAL : NAN; }
+  return sign * ldexp((double) (mantissa | 0x400), exponent - 25);
+}
+
+///
+/// Applies the epilogue to the exact product `value` of the element `(row, column)`,
+/// regenerating the previous C and the bias from their random streams.
+///
+/// @returns The element of C before its downcast (rounded and saturated for Int8).
+///
+static double ApplyEpilogue(IN MatMulContext const* this, IN double value, IN size_t row, IN size_t column) {
+  MatMulEpilogue const* stages = &this->epilogue;
+  bool doublePrecision = MatMulContext_ElementSize(this) == sizeof(double);
+  uint32_t first = 0u, second = 0u;
+
+  value *= stages->alpha;
+  if (stages->beta != 0.0) {
+    first = PhiloxElement(this->seed, TR_STREAM_C, (uint32_t) row, (uint32_t) column, &second);
+    value += stages->beta * (doublePrecision ? PhiloxToDouble(first, second) : (double) PhiloxToFloat(first));
+  }
+
+  if (stages->bias != MatMulBias_None) {
+    size_t index = stages->bias == MatMulBias_Rows ? row : column;
+    first = PhiloxElement(this->seed, TR_STREAM_BIAS, 0u, (uint32_t) index, &second);
+    value += doublePrecision ? PhiloxToDouble(first, second) : (double) PhiloxToFloat(first);
+  }
+
+  switch (stages->activation) {
+    case MatMulActivation_Relu: value = fmax(value, 0.0); break;
+    case MatMulActivation_Gelu: value = 0.5 * value * (1.0 + erf(value / sqrt(2.0))); break;
+    case MatMulActivation_Silu: value = value / (1.0 + exp(-value)); break;
+    default: break;
+  }
+
+  if (stages->clamp) { value = fmin(fmax(value, stages->low), stages->high); }
+  if (stages->output == MatMulOutput_Int8) { value = fmin(fmax(rint(value), -128.0), 127.0); }
+  return value;
+}
 
 static bool RUNMATMULPROGRAM(float)(IN MatMulContext* context);
 static bool RUNMATMULPROGRAM(double)(IN MatMulContext* context);
@@ -58,145 +313,890 @@ static bool RUNMATMULPROGRAM(double)(IN MatMulContext* context);
 // ║║║├─┤ │ ║║║│ ││  ──╠╩╗│ │ ││└┬┘
 // ╩ ╩┴ ┴ ┴ ╩ ╩└─┘┴─┘  ╚═╝└─┘╶┴┘ ┴
 
+#include "matrix/Compare.h" // Compare(), CompareStatistics{}
+#include "matrix/Freivalds.h" // Freivalds(), FreivaldsResult{}
 #include "matrix/Matrix.h" // Matrix(), Self{}
+#include "matrix/Numa.h" // Numa()
+#include "matrix/SpMM.h" // SpMM()
+#include "matrix/Streams.h" // Streams()
+#include "matrix/Strassen.h" // Strassen()
+
+#undef TR_EPSILON
+#define TR_EPSILON _Generic((TR_MATRIX_PRECISION) 0, float: FLT_EPSILON, double: DBL_EPSILON)
+
+#undef TR_RANDOM_VALUE
+#define TR_RANDOM_VALUE(FIRST, SECOND) _Generic((TR_MATRIX_PRECISION) 0, \
+  float: PhiloxToFloat(FIRST), double: PhiloxToDouble(FIRST, SECOND))
+
+typedef struct FILLTASK(TR_MATRIX_PRECISION) {
+  size_t rows, columns, stride;
+  uint32_t stream;
+  uint64_t seed;
+  double density;
+  TR_MATRIX_PRECISION* matrix;
+} FILLTASK(TR_MATRIX_PRECISION);
+
+///
+/// Fills the rows `[begin, end)` of the matrix described by the given task.
+///
+static void FILLROWS(TR_MATRIX_PRECISION)(IN size_t begin, IN size_t end, INOUT void* data) {
+  FILLTASK(TR_MATRIX_PRECISION) const* task = data;
+
+  for (size_t row = begin; row < end; ++row) {
+    TR_MATRIX_PRECISION* line = task->matrix + row * task->stride;
+    for (size_t column = 0u; column < task->stride; ++column) {
+      uint32_t second = 0u, mask = 0u;
+      uint32_t first = row < task->rows && column < task->columns
+        ? PhiloxElement(task->seed, task->stream, (uint32_t) row, (uint32_t) column, &second)
+        : 0u;
+
+      // The kept elements do not depend on the density (same stream).
+      bool kept = task->density >= 1.0 || (double) PhiloxElement(task->seed, TR_STREAM_SPARSITY,
+        (uint32_t) row, (uint32_t) column, &mask) * 0x1p-32 < task->density;
+
+      line[column] = row < task->rows && column < task->columns && kept
+        ? TR_RANDOM_VALUE(first, second)
+        : (TR_MATRIX_PRECISION) 0;
+    }
+  }
+}
+
+///
+/// Fills a row-major `(rows + rowPadding, columns + columnPadding)` matrix with
+/// random values in [-1, 1) and zeroes its padding, using every host thread
+/// (the first touch of the matrix, accounted in `arena`, see `HostArena_Fill()`).
+///
+/// Only a fraction `density` of the elements are kept (others are zeroed), a
+/// density of 1 keeps the whole matrix dense.
+///
+/// The values are bit-identical to the ones of the `FillRandom` OpenCL kernel
+/// (see `matrix/Random.cl`) for the same `seed` and `stream`.
+///
+static void FILLMATRIX(TR_MATRIX_PRECISION)(
+  IN size_t rows, IN size_t rowPadding,
+  IN size_t columns, IN size_t columnPadding,
+  IN uint32_t stream, IN uint64_t seed, IN double density,
+  INOUT HostArena* arena, OUT TR_MATRIX_PRECISION* matrix)
+{
+  assert(arena != NULL && matrix != NULL);
+
+  FILLTASK(TR_MATRIX_PRECISION) task = {
+    .rows = rows, .columns = columns, .stride = columns + columnPadding,
+    .stream = stream, .seed = seed, .density = density, .matrix = matrix,
+  };
+
+  HostArena_Fill(arena, rows + rowPadding, FILLROWS(TR_MATRIX_PRECISION), &task);
+}
+
+///
+/// Checks `C = op(A) * op(B)` with a naive, potentially long, CPU implementation.
+///
+/// The reference is accumulated in double-precision and each element of C is
+/// compared with a tolerance proportional to `N * epsilon * sum(|a * b|)`.
+///
+/// With an epilogue, the reference goes through the same stages (see
+/// `ApplyEpilogue()`), C is stored as `MatMulOutput`, and the tolerance is
+/// widened by the evaluation of the activation and the rounding of the downcast.
+///
+/// @returns `true` if every element of C is within the tolerance.
+///
+static bool CHECKMATMUL(TR_MATRIX_PRECISION)(
+  IN MatMulContext const* this,
+  IN TR_MATRIX_PRECISION const* A,
+  IN TR_MATRIX_PRECISION const* B,
+  IN void const* C,
+  OUT double* maxError)
+{
+  assert(this != NULL);
+  assert(A != NULL && B != NULL && C != NULL);
+  assert(maxError != NULL);
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  MatMulEpilogue const* epilogue = &this->epilogue;
+  size_t mismatches = 0u;
+  *maxError = 0.0;
+
+  for (size_t m = 0u; m < this->M; ++m) {
+    for (size_t p = 0u; p < this->P; ++p) {
+      double reference = 0.0, magnitude = 0.0;
+
+      for (size_t n = 0u; n < this->N; ++n) {
+        double a = this->transA ? A[n * M + m] : A[m * N + n];
+        double b = this->transB ? B[p * N + n] : B[n * P + p];
+        reference += a * b;
+        magnitude += fabs(a * b);
+      }
+
+      double tolerance = 2.0 * (double) this->N * TR_EPSILON * magnitude;
+      if (epilogue->enabled) {
+        // GELU is (slightly) steeper than 1, its erf() within a few ULPs.
+        reference = ApplyEpilogue(this, reference, m, p);
+        tolerance = 1.2 * tolerance * fabs(epilogue->alpha) + 4.0 * TR_EPSILON * (fabs(reference) + 1.0);
+        if (epilogue->output == MatMulOutput_Half) { tolerance += fabs(reference) * 0x1p-11 + 0x1p-24; }
+        if (epilogue->output == MatMulOutput_Int8) { tolerance += 1.0; } // Ties may round either way.
+      }
+
+      double value;
+      switch (epilogue->output) {
+        case MatMulOutput_Half: value = HalfToDouble(((uint16_t const*) C)[m * P + p]); break;
+        case MatMulOutput_Int8: value = (double) ((int8_t const*) C)[m * P + p]; break;
+        default: value = (double) ((TR_MATRIX_PRECISION const*) C)[m * P + p]; break;
+      }
+
+      double error = fabs(value - reference);
+      if (error > *maxError) { *maxError = error; }
+      if (!(error <= tolerance)) {
+        if (mismatches == 0u) {
+          TR_ERROR("C[%zu][%zu] = %g but %g was expected.", m, p, value, reference);
+        }
+
+        mismatches += 1u;
+      }
+    }
+  }
+
+  return mismatches == 0u;
+}
+
+///
+/// Sets the arguments of the epilogue of the MatMul kernel, if any (the bias
+/// buffer may be NULL).
+///
+static cl_int SETEPILOGUEARGUMENTS(TR_MATRIX_PRECISION)(
+  IN MatMulContext const* this, IN cl_kernel kernel, IN cl_mem biasBuffer)
+{
+  MatMulEpilogue const* epilogue = &this->epilogue;
+  if (!epilogue->enabled) {
+    return CL_SUCCESS;
+  }
+
+  // { alpha, beta, low, high }, the unused ones being compiled out.
+  TR_MATRIX_PRECISION scalars[4] = {
+    (TR_MATRIX_PRECISION) epilogue->alpha, (TR_MATRIX_PRECISION) epilogue->beta,
+    (TR_MATRIX_PRECISION) epilogue->low, (TR_MATRIX_PRECISION) epilogue->high,
+  };
+
+  cl_int error = clSetKernelArg(kernel, 6, sizeof(cl_mem), biasBuffer != NULL ? &biasBuffer : NULL);
+  for (cl_uint index = 0u; index < 4u; ++index) {
+    error |= clSetKernelArg(kernel, 7u + index, sizeof(TR_MATRIX_PRECISION), &scalars[index]);
+  }
+
+  return error;
+}
+
+///
+/// Times one more product with the MatMul kernel reading A and B from buffers,
+/// built with `options` (those of the image kernel without `-DMATMUL_IMAGE`),
+/// followed by the split-K reduction if any (`reduceKernel` not NULL, its
+/// arguments already set).
+///
+/// `result` is C, or the partial products with split-K.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+static bool TIMEBUFFEROPERANDS(TR_MATRIX_PRECISION)(
+  IN MatMulContext* this, IN char const* options, IN cl_kernel reduceKernel,
+  IN cl_mem ABuffer, IN cl_mem BBuffer, IN cl_mem result, IN cl_mem biasBuffer,
+  OUT double* nanoseconds)
+{
+  cl_int error;
+  bool success = false;
+  cl_command_queue queue = this->openCl.queue;
+  cl_event events[2] = { NULL, NULL };
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  cl_kernel kernel = ProgramCache_GetKernel(&this->openCl, matrixMatMulStart, matrixMatMulEnd, options, "MatMul");
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(MatMul) failed");
+    return false;
+  }
+
+  cl_uint arguments[3] = { (cl_uint) M, (cl_uint) N, (cl_uint) P };
+  error  = clSetKernelArg(kernel, 0, sizeof(cl_uint), &arguments[0]);
+  error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &arguments[1]);
+  error |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &arguments[2]);
+  error |= clSetKernelArg(kernel, 3, sizeof(cl_mem), &ABuffer);
+  error |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &BBuffer);
+  error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &result);
+  error |= SETEPILOGUEARGUMENTS(TR_MATRIX_PRECISION)(this, kernel, biasBuffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg()", error);
+    goto out;
+  }
+
+  size_t globalSize[3] = { P, M, this->splitK };
+  size_t localSize[3] = { this->blockSize, this->blockSize, 1u };
+  error = clEnqueueNDRangeKernel(queue, kernel, this->splitK > 1u ? 3u : 2u, NULL, globalSize, localSize, 0, NULL, &events[0]);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel()", error);
+    goto out;
+  }
+
+  if (reduceKernel != NULL) {
+    size_t reduceSize = (M * P + TR_MATMUL_REDUCE_GROUP - 1u) / TR_MATMUL_REDUCE_GROUP * TR_MATMUL_REDUCE_GROUP;
+    error = clEnqueueNDRangeKernel(queue, reduceKernel, 1, NULL, &reduceSize, NULL, 0, NULL, &events[1]);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clEnqueueNDRangeKernel(MatMulReduceK)", error);
+      goto out;
+    }
+  }
+
+  cl_event last = events[1] != NULL ? events[1] : events[0];
+  if (CL_SUCCESS != (error = clWaitForEvents(1, &last))) {
+    TR_FAILED("clWaitForEvents()", error);
+    goto out;
+  }
+
+  cl_ulong start = 0u, end = 0u;
+  error  = clGetEventProfilingInfo(events[0], CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo()", error);
+    goto out;
+  }
+
+  *nanoseconds = (double) (end - start);
+  success = true;
+
+out:
+  for (size_t index = 0u; index < 2u; ++index) {
+    if (events[index] != NULL && CL_SUCCESS != (error = clReleaseEvent(events[index]))) { TR_FAILED("clReleaseEvent()", error); }
+  }
+
+  if (CL_SUCCESS != (error = clReleaseKernel(kernel))) { TR_FAILED("clReleaseKernel()", error); }
+  return success;
+}
 
 static bool RUNMATMULPROGRAM(TR_MATRIX_PRECISION)(IN MatMulContext* this) {
   assert(matrixMatMulStart <= matrixMatMulEnd);
   assert(this != NULL);
 
-  // TODO: Check multiplication overflow?
   // TOOD: What about endianness?
 
-  (void) matrixMatMulStart;
-  (void) matrixMatMulEnd;
-
   cl_int error;
+  bool success = false;
   cl_context context = this->openCl.context;
-  cl_device_id device = this->openCl.device;
   cl_command_queue queue = this->openCl.queue;
-  cl_program program = NULL;
+  cl_kernel kernel = NULL, randomKernel = NULL, reduceKernel = NULL;
+  cl_mem ABuffer = NULL, BBuffer = NULL, CBuffer = NULL, partialBuffer = NULL, biasBuffer = NULL;
+  cl_mem AImage = NULL, BImage = NULL;
+  cl_event event = NULL, splitEvent = NULL;
+  TR_MATRIX_PRECISION *A = NULL, *B = NULL, *C = NULL, *bias = NULL;
+  Matrix() AMatrix = { 0 }, BMatrix = { 0 }, CMatrix = { 0 };
+  HostArena arena = { 0 };
+  bool svm = this->svm;
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
 
-  Matrix() Aa; (void) Aa;
+  if (M > UINT_MAX || N > UINT_MAX || P > UINT_MAX) {
+    TR_ERROR("The matrix sizes (%zu, %zu, %zu) overflow the kernel arguments.", M, N, P);
+    return false;
+  }
 
-  size_t ASize = (this->M + this->paddingM) * (this->N + this->paddingN);
-  size_t BSize = (this->N + this->paddingN) * (this->P + this->paddingP);
-  size_t CSize = (this->M + this->paddingM) * (this->P + this->paddingP);
+  size_t ASize = M * N; // TODO: Check multiplication overflow?
+  size_t BSize = N * P;
+  size_t CSize = M * P;
 
-  assert(ASize % this->blockSize == 0u);
-  assert(BSize % this->blockSize == 0u);
-  assert(CSize % this->blockSize == 0u);
+  assert(this->gemv || ASize % this->blockSize == 0u);
+  assert(this->gemv || BSize % this->blockSize == 0u);
+  assert(this->gemv || CSize % this->blockSize == 0u);
 
   // TODO: If CL_MEM_USE_HOST_PTR, alignment & exclusivity requirements
   // [...] make sure host_ptr is aligned and a multiple of a certain size (for Intel
   // devices, aligned on a 4 KB boundary and a multiple of 64 bytes).
   size_t ABytes = sizeof(TR_MATRIX_PRECISION) * ASize;
   size_t BBytes = sizeof(TR_MATRIX_PRECISION) * BSize;
-  size_t CBytes = sizeof(TR_MATRIX_PRECISION) * CSize;
+  size_t CBytes = MatMulContext_OutputSize(this) * CSize;
+
+  // The bias of the epilogue spans the (padded) rows or columns of C.
+  MatMulEpilogue const* epilogue = &this->epilogue;
+  size_t biasLength = epilogue->bias == MatMulBias_Rows ? M : epilogue->bias == MatMulBias_Columns ? P : 0u;
+  size_t biasBytes = sizeof(TR_MATRIX_PRECISION) * biasLength;
 
   TR_MATMUL_LOG(this, 2, "A (" TR_STRINGIFY(TR_MATRIX_PRECISION) ") = %zu bytes", ABytes);
   TR_MATMUL_LOG(this, 2, "B (" TR_STRINGIFY(TR_MATRIX_PRECISION) ") = %zu bytes", BBytes);
-  TR_MATMUL_LOG(this, 2, "C (" TR_STRINGIFY(TR_MATRIX_PRECISION) ") = %zu bytes", CBytes);
+  TR_MATMUL_LOG(this, 2, "C (%zu-byte elements) = %zu bytes", MatMulContext_OutputSize(this), CBytes);
   TR_MATMUL_LOG(this, 2,
     "Total waste (" TR_STRINGIFY(TR_MATRIX_PRECISION) ") = %zu bytes"
     , MatMulContext_ComputeWaste(this)
   );
 
-  TR_MATRIX_PRECISION* A = malloc(ABytes); if (NULL == A) { goto outA; }
-  TR_MATRIX_PRECISION* B = malloc(BBytes); if (NULL == B) { goto outB; }
-  TR_MATRIX_PRECISION* C = malloc(CBytes); if (NULL == C) { goto outC; }
+  // ╔╗ ┬ ┬┬┬  ┌┬┐
+  // ╠╩╗│ │││   ││
+  // ╚═╝└─┘┴┴─┘╶┴┘
+  // (Started first, the compilation overlaps with the host data preparation)
 
-  TR_MATMUL_LOG(this, 1, "Create OpenCL Program.");
-  size_t sourceLength = (size_t) (matrixMatMulEnd - matrixMatMulStart); // TODO: Overflow.
-  program = clCreateProgramWithSource(context, 1, &matrixMatMulStart, &sourceLength, &error);
-  if (error != CL_SUCCESS || program == NULL) {
-    TR_FAILED("clCreateProgramWithSource()", error);
-    goto outProgram;
-  }
+  double startTime = TimerNow();
 
-  #define TR_OPTIONS_SIZE 64
   TR_MATMUL_LOG(this, 1, "Generate Build Options.");
-  char buildOptions[TR_OPTIONS_SIZE + 1] = { 0x0 };
-  int written = snprintf(buildOptions, TR_OPTIONS_SIZE, "-DMATMUL_BLOCKSIZE=%zu", this->blockSize);
-  buildOptions[TR_OPTIONS_SIZE] = 0x0; // To be sure to avoid overflow.
-  if (written >= TR_OPTIONS_SIZE) {
+  char buildOptions[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  GemvLaunch gemv = { 0 };
+  bool fits;
+
+  if (this->gemv) {
+    gemv = GetGemvLaunch(this);
+    fits = AppendOption(buildOptions, sizeof(buildOptions),
+      "-DGEMV_GROUP=%zu -DGEMV_REAL=%s", gemv.localSize, TR_STRINGIFY(TR_MATRIX_PRECISION));
+  }
+  else {
+    fits = AppendOption(buildOptions, sizeof(buildOptions),
+      "-DMATMUL_BLOCKSIZE=%zu -DMATMUL_REAL=%s%s%s%s"
+      , this->blockSize
+      , TR_STRINGIFY(TR_MATRIX_PRECISION)
+      , this->transA ? " -DTRANS_A" : ""
+      , this->transB ? " -DTRANS_B" : ""
+      , MatMulContext_LocalTileOptions(this)
+    );
+  }
+
+  if (this->splitK > 1u) {
+    fits = fits && AppendOption(buildOptions, sizeof(buildOptions), " -DMATMUL_SPLITK");
+  }
+
+  fits = fits && AppendEpilogueOptions(this, buildOptions, sizeof(buildOptions));
+
+  if (this->specialize && !this->gemv) {
+    fits = fits && AppendOption(buildOptions, sizeof(buildOptions),
+      " -DMATMUL_M=%zu -DMATMUL_N=%zu -DMATMUL_P=%zu"
+      " -DMATMUL_LDA=%zu -DMATMUL_LDB=%zu -DMATMUL_LDC=%zu"
+      , M, N, P
+      , this->transA ? M : N
+      , this->transB ? N : P
+      , P
+    );
+  }
+
+  // The same program reading buffers, timed for comparison (see below).
+  char bufferOptions[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  memcpy(bufferOptions, buildOptions, sizeof(bufferOptions));
+  if (this->imageOperands) {
+    fits = fits && AppendOption(buildOptions, sizeof(buildOptions), " -DMATMUL_IMAGE");
+  }
+
+  if (!fits) {
     TR_ERROR("The build options buffer is too small, abort.");
-    goto outBuild;
+    return false;
   }
 
-  TR_MATMUL_LOG(this, 1, "Build OpenCL Program.");
-  error = clBuildProgram(program, 0, NULL, buildOptions, NULL, NULL);
-  if (error != CL_SUCCESS) {
-    TR_FAILED("clBuildProgram()", error);
-    OpenClContext_DisplayBuildError(program, &this->openCl);
-    goto outBuild;
+  TR_MATMUL_LOG(this, 2, "Build Options: %s", buildOptions);
+  TR_MATMUL_LOG(this, 1, "Build OpenCL Program asynchronously (or get it from cache).");
+  ProgramBuild build;
+  bool started = this->gemv
+    ? ProgramCache_BuildAsync(&this->openCl, matrixGemvStart, matrixGemvEnd, buildOptions, gemv.kernelName, &build)
+    : ProgramCache_BuildAsync(&this->openCl, matrixMatMulStart, matrixMatMulEnd, buildOptions, "MatMul", &build);
+  if (!started) {
+    TR_ERROR("ProgramCache_BuildAsync(%s) failed", this->gemv ? gemv.kernelName : "MatMul");
+    return false;
   }
 
-  (void) device; (void) queue;
+  bool building = true;
+
+  ProgramBuild randomBuild;
+  bool randomBuilding = false;
+  if (this->deviceInit) {
+    char const* randomOptions = "-DRANDOM_REAL=" TR_STRINGIFY(TR_MATRIX_PRECISION);
+    randomBuilding = ProgramCache_BuildAsync(&this->openCl, matrixRandomStart, matrixRandomEnd, randomOptions, "FillRandom", &randomBuild);
+    if (!randomBuilding) {
+      TR_ERROR("ProgramCache_BuildAsync(FillRandom) failed");
+      goto outKernel;
+    }
+  }
+
+  // ╦ ╦┌─┐┌─┐┌┬┐
+  // ╠═╣│ │└─┐ │
+  // ╩ ╩└─┘└─┘ ┴
+
+  // A is stored as (M, N), or (N, M) if transposed, same for B with (N, P).
+  // { rows, rowPadding, columns, columnPadding }
+  size_t const AShape[4] = {
+    this->transA ? this->N : this->M, this->transA ? this->paddingN : this->paddingM,
+    this->transA ? this->M : this->N, this->transA ? this->paddingM : this->paddingN,
+  };
+
+  size_t const BShape[4] = {
+    this->transB ? this->P : this->N, this->transB ? this->paddingP : this->paddingN,
+    this->transB ? this->N : this->P, this->transB ? this->paddingN : this->paddingP,
+  };
+
+  // Operands generated on the device are only needed on the host to be checked
+  // (or compressed), and C is only read back for the checks on the host.
+  bool freivaldsOnHost = this->freivalds > 0u && this->freivaldsOnHost;
+  bool hostCheck = this->cpuCheck && !this->deviceReference;
+  bool deviceCheck = (this->cpuCheck && this->deviceReference) || (this->freivalds > 0u && !freivaldsOnHost) || this->strassen;
+  bool hostOperands = !this->deviceInit || hostCheck || freivaldsOnHost || this->sparseDensity > 0.0 || this->numa;
+  bool hostResult = hostCheck || freivaldsOnHost;
+  bool previousC = epilogue->beta != 0.0; // Uploaded from the host for beta.
+
+  double allocationTime = TimerNow();
+  if (svm) {
+    // The host and the device share the same allocations, and their buffers.
+    TR_MATMUL_LOG(this, 1, "Allocate Shared Virtual Memory.");
+    if (!Matrix(NewWithSvmMemory)(&this->openCl, AShape[0] + AShape[1], AShape[2] + AShape[3], &AMatrix)
+      || !Matrix(NewWithSvmMemory)(&this->openCl, BShape[0] + BShape[1], BShape[2] + BShape[3], &BMatrix)
+      || !Matrix(NewWithSvmMemory)(&this->openCl, M, P, &CMatrix)) {
+      TR_ERROR("Matrix(NewWithSvmMemory) failed");
+      goto outKernel;
+    }
+
+    A = AMatrix.pointer; ABuffer = AMatrix.memory;
+    B = BMatrix.pointer; BBuffer = BMatrix.memory;
+    C = CMatrix.pointer; CBuffer = CMatrix.memory;
+  }
+
+  // One region for the host operands and the temporaries of the checks (at
+  // most 8 vectors of the largest dimension), first touched by their fills.
+  size_t largest = M > N ? (M > P ? M : P) : (N > P ? N : P);
+  size_t arenaBytes = 8u * sizeof(TR_MATRIX_PRECISION) * largest + 4u * TR_HOSTARENA_ALIGNMENT;
+  if (!svm && hostOperands) { arenaBytes += ABytes + BBytes; }
+  if (!svm && (hostResult || previousC)) { arenaBytes += CBytes; }
+  arenaBytes += biasBytes;
+
+  TR_MATMUL_LOG(this, 1, "Reserve the Host Arena (%zu bytes).", arenaBytes);
+  if (!HostArena_Create(arenaBytes, this->hugePages, &arena)) {
+    TR_ERROR("HostArena_Create() failed");
+    goto outKernel;
+  }
+
+  this->arena = &arena;
+  if (!svm) {
+    if (hostOperands) {
+      A = HostArena_Allocate(&arena, ABytes); if (NULL == A) { goto outKernel; }
+      B = HostArena_Allocate(&arena, BBytes); if (NULL == B) { goto outKernel; }
+    }
+    if (hostResult || previousC) {
+      C = HostArena_Allocate(&arena, CBytes); if (NULL == C) { goto outKernel; }
+      // Read back from the device, unless filled for beta below.
+      if (!previousC) { HostArena_Touch(&arena, C, CBytes); }
+    }
+  }
+
+  if (biasLength > 0u) {
+    bias = HostArena_Allocate(&arena, biasBytes); if (NULL == bias) { goto outKernel; }
+  }
+
+  // Operands generated on the device are read in place afterwards with SVM.
+  double initializationTime = TimerNow();
+  if (hostOperands && !(svm && this->deviceInit)) {
+    TR_MATMUL_LOG(this, 1, "Initialize Host Matrixes.");
+    if (!Matrix(Map)(queue, CL_MAP_WRITE_INVALIDATE_REGION, &AMatrix) || !Matrix(Map)(queue, CL_MAP_WRITE_INVALIDATE_REGION, &BMatrix)) {
+      goto outKernel;
+    }
+
+    FILLMATRIX(TR_MATRIX_PRECISION)(AShape[0], AShape[1], AShape[2], AShape[3], TR_STREAM_A, this->seed, 1.0, &arena, A);
+    FILLMATRIX(TR_MATRIX_PRECISION)(BShape[0], BShape[1], BShape[2], BShape[3], TR_STREAM_B, this->seed,
+      this->sparseDensity > 0.0 ? this->sparseDensity : 1.0, &arena, B);
+
+    if (!Matrix(Unmap)(queue, &AMatrix) || !Matrix(Unmap)(queue, &BMatrix)) {
+      goto outKernel;
+    }
+  }
+
+  // The inputs of the epilogue, C being overwritten by the product afterwards.
+  if (previousC) {
+    FILLMATRIX(TR_MATRIX_PRECISION)(this->M, this->paddingM, this->P, this->paddingP, TR_STREAM_C, this->seed, 1.0, &arena, C);
+  }
+  if (biasLength > 0u) {
+    size_t length = epilogue->bias == MatMulBias_Rows ? this->M : this->P;
+    FILLMATRIX(TR_MATRIX_PRECISION)(1u, 0u, length, biasLength - length, TR_STREAM_BIAS, this->seed, 1.0, &arena, bias);
+  }
+
+  // ╦ ╦┌─┐┬  ┌─┐┌─┐┌┬┐
+  // ║ ║├─┘│  │ │├─┤ ││
+  // ╚═╝┴  ┴─┘└─┘┴ ┴╶┴┘
 
   // https://stackoverflow.com/questions/57854782/how-opencl-memory-transfer-functions-work
+  double uploadTime = TimerNow();
+  if (!svm) {
+    TR_MATMUL_LOG(this, 1, "Create OpenCL Buffers.");
+    cl_mem_flags operandFlags = this->deviceInit ? CL_MEM_READ_WRITE : CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR;
+    ABuffer = clCreateBuffer(context, operandFlags, ABytes, this->deviceInit ? NULL : A, &error);
+    if (error != CL_SUCCESS || ABuffer == NULL) { TR_FAILED("clCreateBuffer(A)", error); goto outKernel; }
+    BBuffer = clCreateBuffer(context, operandFlags, BBytes, this->deviceInit ? NULL : B, &error);
+    if (error != CL_SUCCESS || BBuffer == NULL) { TR_FAILED("clCreateBuffer(B)", error); goto outKernel; }
+    // The checks on the device read C back from kernels.
+    // Beta reads the previous C in place.
+    cl_mem_flags resultFlags = deviceCheck ? CL_MEM_READ_WRITE : CL_MEM_WRITE_ONLY;
+    if (previousC) { resultFlags = CL_MEM_READ_WRITE | CL_MEM_COPY_HOST_PTR; }
+    CBuffer = clCreateBuffer(context, resultFlags, CBytes, previousC ? C : NULL, &error);
+    if (error != CL_SUCCESS || CBuffer == NULL) { TR_FAILED("clCreateBuffer(C)", error); goto outKernel; }
+  }
+
+  if (biasLength > 0u) {
+    biasBuffer = clCreateBuffer(context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, biasBytes, bias, &error);
+    if (error != CL_SUCCESS || biasBuffer == NULL) { TR_FAILED("clCreateBuffer(bias)", error); goto outKernel; }
+  }
+
+  if (this->deviceInit) {
+    TR_MATMUL_LOG(this, 1, "Generate Operands on Device.");
+    randomKernel = ProgramCache_WaitKernel(&randomBuild);
+    randomBuilding = false;
+    if (randomKernel == NULL) {
+      TR_ERROR("ProgramCache_WaitKernel(FillRandom) failed");
+      goto outKernel;
+    }
+
+    // The in-order queue guarantees the operands are ready before the MatMul kernel.
+    if (!EnqueueFillRandom(queue, randomKernel, AShape, TR_STREAM_A, this->seed, ABuffer)
+      || !EnqueueFillRandom(queue, randomKernel, BShape, TR_STREAM_B, this->seed, BBuffer)) {
+      goto outKernel;
+    }
+  }
+
+  // The images are created once the operands are filled (in-order queue).
+  if (this->imageOperands) {
+    TR_MATMUL_LOG(this, 1, "Create the Operand Images.");
+    AImage = CreateOperandImage(&this->openCl, queue, ABuffer, AShape[0] + AShape[1], AShape[2] + AShape[3]);
+    BImage = CreateOperandImage(&this->openCl, queue, BBuffer, BShape[0] + BShape[1], BShape[2] + BShape[3]);
+    if (AImage == NULL || BImage == NULL) {
+      TR_ERROR("CreateOperandImage() failed");
+      goto outKernel;
+    }
+  }
+
+  // ╦╔═┌─┐┬─┐┌┐┌┌─┐┬
+  // ╠╩╗├┤ ├┬┘│││├┤ │
+  // ╩ ╩└─┘┴└─┘└┘└─┘┴─┘
+
+  double waitTime = TimerNow();
+  TR_MATMUL_LOG(this, 1, "Wait for OpenCL Program.");
+  kernel = ProgramCache_WaitKernel(&build);
+  building = false;
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_WaitKernel(MatMul) failed");
+    goto outKernel;
+  }
+
+  if (this->verbose >= 2) {
+    double readyTime = TimerNow();
+    size_t hits = 0u, misses = 0u;
+    ProgramCache_Statistics(&hits, &misses);
+    TR_PRINT("Program cache: %zu hit%s, %zu miss%s.", hits, hits >= 2 ? "s" : "", misses, misses >= 2 ? "es" : "");
+
+    #define TR_PHASE(NAME, START, END) \
+      TAB1 NAME "%8.3f -> %8.3f ms" LF, ((START) - startTime) * 1e3, ((END) - startTime) * 1e3
+
+    printf(TAB0 "Startup Phases (Host Clock):" LF);
+    printf(TR_PHASE("Program.Build..........: ", build.startTime, build.endTime));
+    printf(TR_PHASE("Host.Allocation........: ", allocationTime, initializationTime));
+    printf(TR_PHASE("Host.Initialization....: ", initializationTime, uploadTime));
+    if (this->deviceInit) printf(TR_PHASE("Device.Generation......: ", uploadTime, waitTime));
+    else                  printf(TR_PHASE("Buffer.Upload..........: ", uploadTime, waitTime));
+    printf(TR_PHASE("Wait.for.Build.........: ", waitTime, readyTime));
+    printf(LF);
+    #undef TR_PHASE
+  }
+
+  // Split-K writes its partial products apart, then sums them into C.
+  if (this->splitK > 1u) {
+    TR_MATMUL_LOG(this, 1, "Create the Split-K Partial Products (%zu slices).", this->splitK);
+    reduceKernel = ProgramCache_GetKernel(&this->openCl, matrixMatMulStart, matrixMatMulEnd, buildOptions, "MatMulReduceK");
+    if (reduceKernel == NULL) {
+      TR_ERROR("ProgramCache_GetKernel(MatMulReduceK) failed");
+      goto outKernel;
+    }
+
+    partialBuffer = clCreateBuffer(context, CL_MEM_READ_WRITE, this->splitK * CBytes, NULL, &error);
+    if (error != CL_SUCCESS || partialBuffer == NULL) { TR_FAILED("clCreateBuffer(partials)", error); goto outKernel; }
+
+    cl_ulong count = (cl_ulong) CSize;
+    cl_uint splits = (cl_uint) this->splitK;
+    error  = clSetKernelArg(reduceKernel, 0, sizeof(cl_ulong), &count);
+    error |= clSetKernelArg(reduceKernel, 1, sizeof(cl_uint), &splits);
+    error |= clSetKernelArg(reduceKernel, 2, sizeof(cl_mem), &partialBuffer);
+    error |= svm ? clSetKernelArgSVMPointer(reduceKernel, 3, C) : clSetKernelArg(reduceKernel, 3, sizeof(cl_mem), &CBuffer);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clSetKernelArg(MatMulReduceK)", error);
+      goto outKernel;
+    }
+  }
+
+  // The GEMV kernels take (rows, columns, ld, X, v, y) with X the matrix operand.
+  bool swap = this->gemv && !gemv.matrixIsA;
+  cl_uint arguments[3] = { (cl_uint) M, (cl_uint) N, (cl_uint) P };
+  if (this->gemv) {
+    arguments[0] = gemv.rows; arguments[1] = gemv.columns; arguments[2] = gemv.ld;
+  }
+
+  error  = clSetKernelArg(kernel, 0, sizeof(cl_uint), &arguments[0]);
+  error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &arguments[1]);
+  error |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &arguments[2]);
+  if (svm) {
+    error |= clSetKernelArgSVMPointer(kernel, 3, swap ? B : A);
+    error |= clSetKernelArgSVMPointer(kernel, 4, swap ? A : B);
+    error |= partialBuffer != NULL ? clSetKernelArg(kernel, 5, sizeof(cl_mem), &partialBuffer) : clSetKernelArgSVMPointer(kernel, 5, C);
+  }
+  else {
+    error |= clSetKernelArg(kernel, 3, sizeof(cl_mem), AImage != NULL ? &AImage : swap ? &BBuffer : &ABuffer);
+    error |= clSetKernelArg(kernel, 4, sizeof(cl_mem), BImage != NULL ? &BImage : swap ? &ABuffer : &BBuffer);
+    error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), partialBuffer != NULL ? &partialBuffer : &CBuffer);
+  }
+  error |= SETEPILOGUEARGUMENTS(TR_MATRIX_PRECISION)(this, kernel, biasBuffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg()", error);
+    goto outKernel;
+  }
+
+  TR_MATMUL_LOG(this, 1, "Enqueue OpenCL Kernel.");
+  size_t globalSize[3] = { P, M, this->splitK }; // (x, y, z) or (columns, rows, slices of N)
+  size_t localSize[3] = { this->blockSize, this->blockSize, 1u };
+  cl_uint dimensions = this->splitK > 1u ? 3u : 2u;
+  if (this->gemv) {
+    globalSize[0] = gemv.globalSize; localSize[0] = gemv.localSize;
+    dimensions = 1u;
+  }
+
+  // With split-K, `event` is the reduction and `splitEvent` the partial products.
+  error = clEnqueueNDRangeKernel(queue, kernel, dimensions, NULL, globalSize, localSize, 0, NULL, partialBuffer != NULL ? &splitEvent : &event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel()", error);
+    goto outKernel;
+  }
+
+  if (partialBuffer != NULL) {
+    size_t reduceSize = (CSize + TR_MATMUL_REDUCE_GROUP - 1u) / TR_MATMUL_REDUCE_GROUP * TR_MATMUL_REDUCE_GROUP;
+    error = clEnqueueNDRangeKernel(queue, reduceKernel, 1, NULL, &reduceSize, NULL, 0, NULL, &event);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clEnqueueNDRangeKernel(MatMulReduceK)", error);
+      goto outEvent;
+    }
+  }
 
-  // // https://stackoverflow.com/questions/26517114/how-to-compile-opencl-project-with-kernels
-  // // Create the memory buffers
-  // cl::Buffer bufferA=cl::Buffer(context, CL_MEM_READ_ONLY, N_ELEMENTS * sizeof(int));
-  // cl::Buffer bufferB=cl::Buffer(context, CL_MEM_READ_ONLY, N_ELEMENTS * sizeof(int));
-  // cl::Buffer bufferC=cl::Buffer(context, CL_MEM_WRITE_ONLY, N_ELEMENTS * sizeof(int));
-  // // Copy the input data to the input buffers using the command queue.
-  // queue.enqueueWriteBuffer( bufferA, CL_FALSE, 0, N_ELEMENTS * sizeof(int), A.get() );
-  // queue.enqueueWriteBuffer( bufferB, CL_FALSE, 0, N_ELEMENTS * sizeof(int), B.get() );
-  // // ...
-  // // Copy the output data back to the host
-  // queue.enqueueReadBuffer( bufferC, CL_TRUE, 0, N_ELEMENTS * sizeof(int), C.get() );
-
-
-  /*
-  If you already have the data and want to load the data into an OpenCL buffer
-  object, then use CL_MEM_USE_HOST_PTR with a buffer allocated at a 4096 byte
-  boundary (aligned to a page and cache line boundary) and a total size that is
-  a multiple of 64 bytes (cache line size).
-  */
-
-  // cl_mem
-  // clGetMemObjectInfo()
-  // cl_mem = clCreateBuffer()
-            // flags |= CL_MEM_READ_ONLY;
-            // flags |= CL_MEM_READ_WRITE;
-            // flags |= CL_MEM_USE_HOST_PTR;
-
-  // clEnqueueReadBuffer
-  // clEnqueueWriteBuffer
-  // clEnqueueFillBuffer
-  // clEnqueueMapBuffer, clEnqueueUnmapMemObject
-  // clEnqueueNDRangeKernel
-  // clEnqueueWaitForEvents
-
-  // cl_context context = this->oclContext->context;
-  // cl::Context context(deviceType);
-  // cl::CommandQueue queue(context, CL_QUEUE_PROFILING_ENABLE);
-  // cl::Program program(context, std::string(matrixMatMulSource), false); // true = build
-
-  // clRetainProgram(program)
-  // clReleaseProgram(program)
-  // clRetainKernel(kernel)
-  // clReleaseKernel(kernel)
-  // clRetainEvent(event)
-  // clReleaseEvent(event)
-
-  // row-major order
-
-outBuild:
-outProgram:
-  if (program != NULL) {
-    TR_MATMUL_LOG(this, 2, "Release OpenCL Program.");
-    if (CL_SUCCESS != (error = clReleaseProgram(program))) {
-      TR_FAILED("clReleaseProgram()", error);
-    }
-  }
-
-outC: if (C != NULL) { free(C); }
-outB: if (B != NULL) { free(B); }
-outA: if (A != NULL) { free(A); }
-
-  return false;
+  if (svm) {
+    // Later kernels only read A, B and C, which may thus stay mapped for reading.
+    if (CL_SUCCESS != (error = clWaitForEvents(1, &event))) {
+      TR_FAILED("clWaitForEvents()", error);
+      goto outEvent;
+    }
+
+    if ((hostOperands && (!Matrix(Map)(queue, CL_MAP_READ, &AMatrix) || !Matrix(Map)(queue, CL_MAP_READ, &BMatrix)))
+      || (hostResult && !Matrix(Map)(queue, CL_MAP_READ, &CMatrix))) {
+      goto outEvent;
+    }
+  }
+  else if (hostResult) {
+    TR_MATMUL_LOG(this, 1, "Read OpenCL Buffer.");
+    error = clEnqueueReadBuffer(queue, CBuffer, CL_TRUE, 0u, CBytes, C, 1, &event, NULL);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clEnqueueReadBuffer(C)", error);
+      goto outEvent;
+    }
+  }
+  else if (CL_SUCCESS != (error = clWaitForEvents(1, &event))) {
+    TR_FAILED("clWaitForEvents()", error);
+    goto outEvent;
+  }
+
+  // With split-K, the time spans the partial products and their reduction.
+  cl_ulong start = 0u, end = 0u;
+  error  = clGetEventProfilingInfo(splitEvent != NULL ? splitEvent : event, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo()", error);
+  }
+
+  // Only the useful (unpadded) operations are taken into account.
+  double nanoseconds = (double) (end - start);
+  double operations = 2.0 * (double) this->M * (double) this->N * (double) this->P;
+
+  printf(
+    TAB0 "Matrix Multiplication Results:" LF
+    TAB1 "Kernel.Time............: %.3f ms" LF
+    TAB1 "Performance............: %.3f GFLOP/s" LF
+    , nanoseconds * 1e-6
+    , nanoseconds > 0.0 ? operations / nanoseconds : 0.0
+  );
+
+  if (this->roofline) {
+    // The compulsory traffic, each operand moved once (i.e. the best the
+    // caches and the local memory could achieve).
+    Roofline roofline;
+    double CElements = (double) this->M * (double) this->P;
+    double bytes = (double) sizeof(TR_MATRIX_PRECISION)
+      * ((double) this->M * (double) this->N + (double) this->N * (double) this->P + (previousC ? CElements : 0.0) + (double) biasLength)
+      + (double) MatMulContext_OutputSize(this) * CElements;
+
+    if (Roofline_Measure(&this->openCl, sizeof(TR_MATRIX_PRECISION) == sizeof(double), &roofline)) {
+      Roofline_Display(&roofline, operations, bytes, nanoseconds);
+    }
+    else {
+      TR_ERROR("Roofline_Measure() failed");
+    }
+  }
+
+  printf(TAB1 "Host.Arena.............: %.1f MiB, first touched in %.3f ms (%ld minor, %ld major faults, %s)" LF
+    , (double) arena.size / (1024.0 * 1024.0), arena.populateMilliseconds
+    , arena.minorFaults, arena.majorFaults
+    , arena.hugePages ? "huge pages" : arena.transparentHugePages ? "transparent huge pages" : "regular pages"
+  );
+
+  success = true;
+
+  if (this->cpuCheck && this->deviceReference) {
+    CompareStatistics statistics;
+    TR_MATMUL_LOG(this, 1, "Check Result against a Device Reference.");
+    if (!Compare(Reference)(this, ABuffer, BBuffer, CBuffer, &statistics)) {
+      TR_ERROR("Compare(Reference) failed");
+      success = false;
+    }
+    else {
+      bool passed = statistics.failures == 0u && statistics.nonFinite == 0u;
+      printf(
+        TAB1 "Device.Check...........: %s (%zu out of tolerance, %zu non-finite)" LF
+        TAB1 "Max.Absolute.Error.....: %g" LF
+        TAB1 "Max.Relative.Error.....: %g" LF
+        TAB1 "ULP.Histogram..........:"
+        , passed ? "Passed" : "Failed", statistics.failures, statistics.nonFinite
+        , statistics.maxAbsoluteError
+        , statistics.maxRelativeError
+      );
+
+      // Bucket 0 is exact, then [2^(b-1), 2^b) ULPs, the last one being open.
+      for (size_t bucket = 0u; bucket < TR_COMPARE_BUCKETS; ++bucket) {
+        if (statistics.histogram[bucket] == 0u) { continue; }
+        if (bucket <= 1u) { printf(" %zu: %zu", bucket, statistics.histogram[bucket]); }
+        else if (bucket + 1u < TR_COMPARE_BUCKETS) { printf(" <%zu: %zu", (size_t) 1u << bucket, statistics.histogram[bucket]); }
+        else { printf(" >=%zu: %zu", (size_t) 1u << (bucket - 1u), statistics.histogram[bucket]); }
+      }
+
+      printf(LF);
+      success = passed;
+    }
+  }
+  else if (this->cpuCheck) {
+    double maxError = 0.0;
+    TR_MATMUL_LOG(this, 1, "Check Result on CPU.");
+    success = CHECKMATMUL(TR_MATRIX_PRECISION)(this, A, B, C, &maxError);
+    printf(TAB1 "CPU.Check..............: %s (max. error %g)" LF
+      , success ? "Passed" : "Failed", maxError);
+  }
+
+  if (this->freivalds > 0u) {
+    FreivaldsResult result;
+    TR_MATMUL_LOG(this, 1, "Check Result with Freivalds on %s.", freivaldsOnHost ? "Host" : "Device");
+    bool verified = freivaldsOnHost
+      ? Freivalds(Host)(this, A, B, C, &result)
+      : Freivalds(Device)(this, ABuffer, BBuffer, CBuffer, &result);
+
+    if (!verified) {
+      TR_ERROR("Freivalds() failed");
+      success = false;
+    }
+    else {
+      printf(TAB1 "Freivalds.Check........: %s (%zu/%zu trials failed, confidence >= %g, max. error %g <= %g)" LF
+        , result.failures == 0u ? "Passed" : "Failed", result.failures, result.trials
+        , result.confidence, result.maxError, result.tolerance);
+      success = success && result.failures == 0u;
+    }
+  }
+
+  if (this->strassen) {
+    TR_MATMUL_LOG(this, 1, "Run Strassen-Winograd.");
+    if (!Strassen(Benchmark)(this, ABuffer, BBuffer, CBuffer, nanoseconds * 1e-6)) {
+      TR_ERROR("Strassen(Benchmark) failed");
+      success = false;
+    }
+  }
+
+  if (this->streams > 1u) {
+    if (!Streams(Benchmark)(this, ABuffer, BBuffer, nanoseconds * 1e-6)) {
+      TR_ERROR("Streams(Benchmark) failed");
+      success = false;
+    }
+  }
+
+  if (this->producers > 0u) {
+    TR_MATMUL_LOG(this, 1, "Run the Submitter.");
+    if (!Streams(Submit)(this, ABuffer, BBuffer, nanoseconds * 1e-6)) {
+      TR_ERROR("Streams(Submit) failed");
+      success = false;
+    }
+  }
+
+  if (this->numa) {
+    if (!Numa(Benchmark)(this, ABuffer, BBuffer, A, B, nanoseconds * 1e-6)) {
+      TR_ERROR("Numa(Benchmark) failed");
+      success = false;
+    }
+  }
+
+  if (this->sparseDensity > 0.0) {
+    TR_MATMUL_LOG(this, 1, "Run Sparse-Dense Products.");
+    if (!SpMM(Benchmark)(this, ABuffer, BBuffer, B, nanoseconds * 1e-6)) {
+      TR_ERROR("SpMM(Benchmark) failed");
+      success = false;
+    }
+  }
+
+  // Run last, C (or its partial products) being overwritten.
+  if (this->imageOperands) {
+    double bufferNanoseconds = 0.0;
+    TR_MATMUL_LOG(this, 1, "Time the Buffer Operands.");
+    if (!TIMEBUFFEROPERANDS(TR_MATRIX_PRECISION)(this, bufferOptions, reduceKernel,
+      ABuffer, BBuffer, partialBuffer != NULL ? partialBuffer : CBuffer, biasBuffer, &bufferNanoseconds)) {
+      TR_ERROR("TimeBufferOperands() failed");
+      success = false;
+    }
+    else {
+      printf(TAB1 "Buffer.Operands.Time...: %.3f ms (x%.2f for the images)" LF
+        , bufferNanoseconds * 1e-6, nanoseconds > 0.0 ? bufferNanoseconds / nanoseconds : 0.0);
+    }
+  }
+
+  printf(LF);
+
+outEvent:
+  if (event != NULL) {
+    if (CL_SUCCESS != (error = clReleaseEvent(event))) {
+      TR_FAILED("clReleaseEvent()", error);
+    }
+  }
+
+  if (splitEvent != NULL) {
+    if (CL_SUCCESS != (error = clReleaseEvent(splitEvent))) {
+      TR_FAILED("clReleaseEvent()", error);
+    }
+  }
+
+outKernel:
+  // The build callbacks refer to `build` and `randomBuild`, which must not go out of scope.
+  if (building) { kernel = ProgramCache_WaitKernel(&build); }
+  if (randomBuilding) { randomKernel = ProgramCache_WaitKernel(&randomBuild); }
+
+  TR_MATMUL_LOG(this, 2, "Release OpenCL Kernels.");
+  if (kernel != NULL && CL_SUCCESS != (error = clReleaseKernel(kernel))) { TR_FAILED("clReleaseKernel()", error); }
+  if (randomKernel != NULL && CL_SUCCESS != (error = clReleaseKernel(randomKernel))) { TR_FAILED("clReleaseKernel()", error); }
+  if (reduceKernel != NULL && CL_SUCCESS != (error = clReleaseKernel(reduceKernel))) { TR_FAILED("clReleaseKernel()", error); }
+
+  TR_MATMUL_LOG(this, 2, "Release OpenCL Buffers.");
+  if (svm) {
+    // clSVMFree() does not wait for the pending commands.
+    Matrix(Unmap)(queue, &CMatrix); Matrix(Unmap)(queue, &BMatrix); Matrix(Unmap)(queue, &AMatrix);
+    if (CL_SUCCESS != (error = clFinish(queue))) { TR_FAILED("clFinish()", error); }
+    if (!Matrix(Release)(&CMatrix) || !Matrix(Release)(&BMatrix) || !Matrix(Release)(&AMatrix)) { TR_ERROR("Matrix(Release) failed"); }
+    ABuffer = BBuffer = CBuffer = NULL;
+    A = B = C = NULL;
+  }
+
+  if (BImage != NULL && CL_SUCCESS != (error = clReleaseMemObject(BImage))) { TR_FAILED("clReleaseMemObject(B image)", error); }
+  if (AImage != NULL && CL_SUCCESS != (error = clReleaseMemObject(AImage))) { TR_FAILED("clReleaseMemObject(A image)", error); }
+  if (biasBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(biasBuffer))) { TR_FAILED("clReleaseMemObject(bias)", error); }
+  if (partialBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(partialBuffer))) { TR_FAILED("clReleaseMemObject(partials)", error); }
+  if (CBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(CBuffer))) { TR_FAILED("clReleaseMemObject(C)", error); }
+  if (BBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(BBuffer))) { TR_FAILED("clReleaseMemObject(B)", error); }
+  if (ABuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(ABuffer))) { TR_FAILED("clReleaseMemObject(A)", error); }
+
+  this->arena = NULL;
+  if (!HostArena_Release(&arena)) { TR_ERROR("HostArena_Release() failed"); }
+
+  return success;
 }
 
 // ╔╦╗┌─┐┌┬┐╔╦╗┬ ┬┬    ╔═╗┌┐┌┌┬┐
@@ -208,6 +1208,10 @@ outA: if (A != NULL) { free(A); }
 
 bool MatMulProgram_Run(IN MatMulContext* context) {
   assert(context != NULL);
+  if (context->df64) {
+    return DF64_Run(context);
+  }
+
   return context->openCl.fp64Extension
     ? RUNMATMULPROGRAM(double)(context)
     : RUNMATMULPROGRAM(float)(context);
@@ -11,10 +11,13 @@
 
 #include <CL/opencl.h> // Khronos API
 
+#include <assert.h> // assert()
 #include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t
+#include <stdio.h> // fprintf(), stderr
 
-#include "common/helper.h" // IN, OUT, INOUT
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
 #include "matrix/Matrix.h" // Matrix(), Self{}
 
 bool Matrix(NewWithHostMemory)(IN size_t rows, IN size_t columns, OUT Matrix()* matrix) {
@@ -29,9 +32,101 @@ bool Matrix(NewWithDeviceMemory)(IN size_t rows, IN size_t columns, OUT Matrix()
   return false;
 }
 
+bool Matrix(NewWithSvmMemory)(
+  IN OpenClContext const* openCl,
+  IN size_t rows,
+  IN size_t columns,
+  OUT Matrix()* this)
+{
+  assert(openCl != NULL && openCl->context != NULL);
+  assert(this != NULL);
+
+  cl_device_svm_capabilities svm = openCl->capabilities.svmCapabilities;
+  size_t bytes = sizeof(TR_MATRIX_PRECISION) * rows * columns;
+  *this = (Matrix()) { .rows = rows, .columns = columns };
+
+  if ((svm & (CL_DEVICE_SVM_COARSE_GRAIN_BUFFER | CL_DEVICE_SVM_FINE_GRAIN_BUFFER)) == 0u) {
+    TR_ERROR("The device does not support shared virtual memory.");
+    return false;
+  }
+
+  this->fineGrained = (svm & CL_DEVICE_SVM_FINE_GRAIN_BUFFER) != 0u;
+  cl_svm_mem_flags flags = CL_MEM_READ_WRITE | (this->fineGrained ? CL_MEM_SVM_FINE_GRAIN_BUFFER : 0u);
+
+  // Aligned on the largest OpenCL type (long16), as for buffers.
+  this->pointer = (TR_MATRIX_PRECISION*) clSVMAlloc(openCl->context, flags, bytes, 128u);
+  if (this->pointer == NULL) {
+    TR_ERROR("clSVMAlloc(%zu bytes) failed", bytes);
+    return false;
+  }
+
+  this->svmContext = openCl->context;
+
+  // An SVM pointer given to CL_MEM_USE_HOST_PTR is the storage of the buffer.
+  cl_int error;
+  this->memory = clCreateBuffer(openCl->context, CL_MEM_READ_WRITE | CL_MEM_USE_HOST_PTR, bytes, this->pointer, &error);
+  if (error != CL_SUCCESS || this->memory == NULL) {
+    TR_FAILED("clCreateBuffer(SVM)", error);
+    clSVMFree(this->svmContext, this->pointer);
+    *this = (Matrix()) { 0 };
+    return false;
+  }
+
+  return true;
+}
+
+bool Matrix(Map)(IN cl_command_queue queue, IN cl_map_flags flags, INOUT Matrix()* this) {
+  assert(queue != NULL && this != NULL);
+
+  if (this->svmContext == NULL || this->fineGrained || this->mapped) {
+    return true;
+  }
+
+  size_t bytes = sizeof(TR_MATRIX_PRECISION) * (this->rows + this->rowPadding) * (this->columns + this->columnPadding);
+  cl_int error = clEnqueueSVMMap(queue, CL_TRUE, flags, this->pointer, bytes, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueSVMMap()", error);
+    return false;
+  }
+
+  this->mapped = true;
+  return true;
+}
+
+bool Matrix(Unmap)(IN cl_command_queue queue, INOUT Matrix()* this) {
+  assert(queue != NULL && this != NULL);
+
+  if (!this->mapped) {
+    return true;
+  }
+
+  cl_int error = clEnqueueSVMUnmap(queue, this->pointer, 0, NULL, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueSVMUnmap()", error);
+    return false;
+  }
+
+  this->mapped = false;
+  return true;
+}
+
 bool Matrix(Release)(INOUT Matrix()* this) {
-  (void) this;
-  return false;
+  assert(this != NULL);
+
+  cl_int error;
+  bool success = true;
+  if (this->memory != NULL && CL_SUCCESS != (error = clReleaseMemObject(this->memory))) {
+    TR_FAILED("clReleaseMemObject(Matrix)", error);
+    success = false;
+  }
+
+  // The buffer no longer refers to the allocation.
+  if (this->svmContext != NULL) {
+    clSVMFree(this->svmContext, this->pointer);
+  }
+
+  *this = (Matrix()) { 0 };
+  return success;
 }
 
 #endif // TR_MATRIX_PRECISION
@@ -14,6 +14,7 @@
 #include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t
 
+#include "common/OpenClContext.h" // OpenClContext{}
 #include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
 
 #undef Matrix
@@ -40,6 +41,11 @@ typedef struct Matrix() {
 
   TR_MATRIX_PRECISION* pointer; // host pointer or mapped
   cl_mem memory;
+
+  // Owner of `pointer` when allocated with clSVMAlloc(), NULL otherwise.
+  cl_context svmContext;
+  bool fineGrained; // Coherent, no map/unmap needed.
+  bool mapped; // Coarse-grained only.
 } Matrix();
 
 ///
@@ -57,7 +63,54 @@ bool Matrix(NewWithHostMemory)(
 bool Matrix(NewWithDeviceMemory)(IN size_t rows, IN size_t columns, OUT Matrix()* matrix);
 
 ///
+/// Allocates a `(rows, columns)` matrix in shared virtual memory, fine-grained
+/// when the device supports it, coarse-grained otherwise.
+///
+/// `pointer` is the SVM allocation (set on kernels with clSetKernelArgSVMPointer()),
+/// and `memory` a buffer using it as storage (for the APIs expecting a `cl_mem`),
+/// thus on shared-memory devices the host and the device never copy it.
+///
+/// @returns `true` on success, `false` otherwise (e.g. no SVM before OpenCL 2.0).
+///
+/// @pre `context` is not NULL and initialized, `matrix` is not NULL.
+/// @post `matrix` must be released with `Matrix(Release)()`.
+/// @post May display error on stderr.
+///
+bool Matrix(NewWithSvmMemory)(
+  IN OpenClContext const* context,
+  IN size_t rows,
+  IN size_t columns,
+  OUT Matrix()* matrix
+);
+
+///
+/// Makes a coarse-grained SVM matrix accessible from the host (blocking), the
+/// `flags` being `CL_MAP_*`. Does nothing for other matrixes.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @post The matrix must be unmapped before a kernel writes it.
+/// @post May display error on stderr.
+///
+bool Matrix(Map)(IN cl_command_queue queue, IN cl_map_flags flags, INOUT Matrix()* matrix);
+
+///
+/// Gives a mapped coarse-grained SVM matrix back to the device (enqueued,
+/// ordered by the in-order queue). Does nothing for other matrixes.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @post May display error on stderr.
+///
+bool Matrix(Unmap)(IN cl_command_queue queue, INOUT Matrix()* matrix);
+
+///
+/// Releases the buffer and the SVM allocation of the matrix.
+///
+/// @returns `true` on success, `false` otherwise.
 ///
+/// @pre No command using the matrix is pending (clSVMFree() does not wait).
+/// @post May display error on stderr.
 ///
 bool Matrix(Release)(INOUT Matrix()* matrix);
 
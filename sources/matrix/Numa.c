@@ -0,0 +1,276 @@
+#ifndef TR_MATRIX_NUMA_C
+#ifndef TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // printf(), snprintf()
+#include <string.h> // strlen()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/OpenClContext.h" // OpenClContext_FromNumaNodes()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "common/timer.h" // TimerNow()
+#include "matrix/MatMulContext.h" // MatMulContext{}, TR_MATMUL_LOG()
+
+// Define matrixMatMulStart and matrixMatMulEnd.
+TR_OPENCL_IMPORT(matrix, MatMul)
+
+///
+/// The part of the product computed by a NUMA node, the rows `[row, row + rows)`
+/// of C, with its own context, kernel and buffers.
+///
+typedef struct NumaNode {
+  size_t row, rows;
+  cl_kernel kernel;
+  cl_mem A, B, C;
+} NumaNode;
+
+///
+/// Enqueues the blocked MatMul kernel (with views) of a node on its buffers,
+/// its A holding either its rows of A, or the whole A when stored transposed
+/// (then its rows of op(A) are columns).
+///
+static bool EnqueueNode(
+  IN MatMulContext const* this, IN cl_command_queue queue,
+  IN NumaNode const* node, OUT cl_event* event)
+{
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  cl_uint sizes[3] = { (cl_uint) node->rows, (cl_uint) N, (cl_uint) P };
+  cl_ulong offsets[3] = { this->transA ? node->row : 0u, 0u, 0u };
+  cl_uint lds[3] = { (cl_uint) (this->transA ? M : N), (cl_uint) (this->transB ? N : P), (cl_uint) P };
+
+  cl_int error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < 3u; ++index) {
+    error |= clSetKernelArg(node->kernel, index, sizeof(cl_uint), &sizes[index]);
+    error |= clSetKernelArg(node->kernel, 3u + 2u * index, sizeof(cl_ulong), &offsets[index]);
+    error |= clSetKernelArg(node->kernel, 4u + 2u * index, sizeof(cl_uint), &lds[index]);
+  }
+
+  error |= clSetKernelArg(node->kernel, 9, sizeof(cl_mem), &node->A);
+  error |= clSetKernelArg(node->kernel, 10, sizeof(cl_mem), &node->B);
+  error |= clSetKernelArg(node->kernel, 11, sizeof(cl_mem), &node->C);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Numa)", error);
+    return false;
+  }
+
+  size_t globalSize[2] = { P, node->rows }; // (x, y) or (columns, rows)
+  size_t localSize[2] = { this->blockSize, this->blockSize };
+  error = clEnqueueNDRangeKernel(queue, node->kernel, 2, NULL, globalSize, localSize, 0, NULL, event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(Numa)", error);
+    return false;
+  }
+
+  return true;
+}
+
+///
+/// Creates a buffer in the context of a node, then fills it from its queue,
+/// thus the pages are first touched by the threads of the node (node-local).
+///
+static cl_mem NewNodeBuffer(IN OpenClContext const* node, IN size_t bytes, IN void const* source) {
+  cl_int error;
+  cl_mem buffer = clCreateBuffer(node->context, CL_MEM_READ_WRITE, bytes, NULL, &error);
+  if (error != CL_SUCCESS || buffer == NULL) {
+    TR_FAILED("clCreateBuffer(Numa)", error);
+    return NULL;
+  }
+
+  if (source != NULL && CL_SUCCESS != (error = clEnqueueWriteBuffer(node->queue, buffer, CL_FALSE, 0u, bytes, source, 0, NULL, NULL))) {
+    TR_FAILED("clEnqueueWriteBuffer(Numa)", error);
+    clReleaseMemObject(buffer);
+    return NULL;
+  }
+
+  return buffer;
+}
+
+#define TR_MATRIX_PRECISION float
+#include "matrix/Numa.c"
+#undef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION double
+#  include "matrix/Numa.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_NUMA_C
+#else // TR_MATRIX_PRECISION
+
+#include "matrix/Compare.h" // Compare(), CompareStatistics{}
+#include "matrix/Numa.h" // Numa()
+
+bool Numa(Benchmark)(
+  IN MatMulContext* this,
+  IN cl_mem ABuffer, IN cl_mem BBuffer,
+  IN TR_MATRIX_PRECISION const* A,
+  IN TR_MATRIX_PRECISION const* B,
+  IN double classicMilliseconds)
+{
+  assert(this != NULL);
+  assert(ABuffer != NULL && BBuffer != NULL);
+  assert(A != NULL && B != NULL);
+
+  cl_int error;
+  bool success = false;
+  OpenClContext contexts[TR_OPENCL_MAX_NODES];
+  NumaNode nodes[TR_OPENCL_MAX_NODES] = { 0 };
+  cl_event events[TR_OPENCL_MAX_NODES] = { NULL };
+  size_t count = 0u;
+  cl_mem SBuffer = NULL, R = NULL, bound = NULL;
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  TR_MATMUL_LOG(this, 1, "Partition the Device by NUMA Node.");
+  if (!OpenClContext_FromNumaNodes(&this->openCl, contexts, &count)) {
+    TR_ERROR("The device cannot be partitioned by NUMA node (e.g. not a multi-socket CPU).");
+    return false;
+  }
+
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options),
+    "-DMATMUL_BLOCKSIZE=%zu -DMATMUL_REAL=%s%s%s%s -DMATMUL_VIEWS"
+    , this->blockSize
+    , TR_STRINGIFY(TR_MATRIX_PRECISION)
+    , this->transA ? " -DTRANS_A" : ""
+    , this->transB ? " -DTRANS_B" : ""
+    , MatMulContext_LocalTileOptions(this)
+  );
+
+  // Whole blocks of rows, as evenly as possible (a node may get none).
+  size_t blocks = M / this->blockSize;
+  size_t const elementSize = sizeof(TR_MATRIX_PRECISION);
+  for (size_t index = 0u; index < count; ++index) {
+    NumaNode* node = &nodes[index];
+    node->row = blocks * index / count * this->blockSize;
+    node->rows = blocks * (index + 1u) / count * this->blockSize - node->row;
+    if (node->rows == 0u) { continue; }
+
+    node->kernel = ProgramCache_GetKernel(&contexts[index], matrixMatMulStart, matrixMatMulEnd, options, "MatMul");
+    if (node->kernel == NULL) {
+      TR_ERROR("ProgramCache_GetKernel(MatMul) failed");
+      goto out;
+    }
+
+    // Only its rows of A (contiguous unless transposed), and the whole B.
+    node->A = this->transA
+      ? NewNodeBuffer(&contexts[index], elementSize * N * M, A)
+      : NewNodeBuffer(&contexts[index], elementSize * node->rows * N, A + node->row * N);
+    node->B = NewNodeBuffer(&contexts[index], elementSize * N * P, B);
+    node->C = NewNodeBuffer(&contexts[index], elementSize * node->rows * P, NULL);
+    if (node->A == NULL || node->B == NULL || node->C == NULL) {
+      goto out;
+    }
+  }
+
+  // The uploads are not part of the timing.
+  for (size_t index = 0u; index < count; ++index) {
+    if (CL_SUCCESS != (error = clFinish(contexts[index].queue))) {
+      TR_FAILED("clFinish(Numa)", error);
+      goto out;
+    }
+  }
+
+  // The nodes have their own clocks, thus the host one measures them all.
+  TR_MATMUL_LOG(this, 1, "Run Rows on %zu NUMA Nodes.", count);
+  double startTime = TimerNow();
+  for (size_t index = 0u; index < count; ++index) {
+    if (nodes[index].rows > 0u && !EnqueueNode(this, contexts[index].queue, &nodes[index], &events[index])) {
+      goto out;
+    }
+  }
+
+  for (size_t index = 0u; index < count; ++index) {
+    if (CL_SUCCESS != (error = clFlush(contexts[index].queue))) {
+      TR_FAILED("clFlush(Numa)", error);
+      goto out;
+    }
+  }
+
+  for (size_t index = 0u; index < count; ++index) {
+    if (events[index] != NULL && CL_SUCCESS != (error = clWaitForEvents(1, &events[index]))) {
+      TR_FAILED("clWaitForEvents(Numa)", error);
+      goto out;
+    }
+  }
+
+  double milliseconds = (TimerNow() - startTime) * 1e3;
+  char rows[16u * TR_OPENCL_MAX_NODES] = { 0x0 };
+  for (size_t index = 0u; index < count; ++index) {
+    size_t length = strlen(rows);
+    snprintf(rows + length, sizeof(rows) - length, "%s%zu", index > 0u ? " " : "", nodes[index].rows);
+  }
+
+  printf(
+    TAB1 "Numa.Time..............: %.3f ms (x%.2f against the whole device, %zu nodes, host clock)" LF
+    TAB1 "Numa.Rows..............: %s" LF
+    , milliseconds, milliseconds > 0.0 ? classicMilliseconds / milliseconds : 0.0, count
+    , rows
+  );
+
+  if (this->cpuCheck) {
+    TR_MATMUL_LOG(this, 1, "Gather the Rows of every Node.");
+    SBuffer = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, elementSize * M * P, NULL, &error);
+    if (error != CL_SUCCESS || SBuffer == NULL) {
+      TR_FAILED("clCreateBuffer(Numa)", error);
+      goto out;
+    }
+
+    TR_MATRIX_PRECISION* gathered = clEnqueueMapBuffer(this->openCl.queue, SBuffer, CL_TRUE,
+      CL_MAP_WRITE_INVALIDATE_REGION, 0u, elementSize * M * P, 0, NULL, NULL, &error);
+    if (error != CL_SUCCESS || gathered == NULL) {
+      TR_FAILED("clEnqueueMapBuffer(Numa)", error);
+      goto out;
+    }
+
+    for (size_t index = 0u; index < count && error == CL_SUCCESS; ++index) {
+      if (nodes[index].rows == 0u) { continue; }
+      error = clEnqueueReadBuffer(contexts[index].queue, nodes[index].C, CL_TRUE,
+        0u, elementSize * nodes[index].rows * P, gathered + nodes[index].row * P, 0, NULL, NULL);
+    }
+
+    cl_int unmapped = clEnqueueUnmapMemObject(this->openCl.queue, SBuffer, gathered, 0, NULL, NULL);
+    if (error != CL_SUCCESS || unmapped != CL_SUCCESS) {
+      TR_FAILED("clEnqueueReadBuffer(Numa)", error != CL_SUCCESS ? error : unmapped);
+      goto out;
+    }
+
+    CompareStatistics statistics;
+    if (!Compare(NewReference)(this, ABuffer, BBuffer, &R, &bound)
+      || !Compare(Buffers)(this, SBuffer, R, bound, &statistics)) {
+      goto out;
+    }
+
+    printf(TAB1 "Numa.Check.............: %s (max. error %g absolute, %g relative)" LF
+      , statistics.failures == 0u && statistics.nonFinite == 0u ? "Passed" : "Failed"
+      , statistics.maxAbsoluteError, statistics.maxRelativeError);
+  }
+
+  success = true;
+
+out:
+  for (size_t index = 0u; index < count; ++index) {
+    NumaNode* node = &nodes[index];
+    if (events[index] != NULL) { clReleaseEvent(events[index]); }
+    if (node->C != NULL && CL_SUCCESS != (error = clReleaseMemObject(node->C))) { TR_FAILED("clReleaseMemObject(C)", error); }
+    if (node->B != NULL && CL_SUCCESS != (error = clReleaseMemObject(node->B))) { TR_FAILED("clReleaseMemObject(B)", error); }
+    if (node->A != NULL && CL_SUCCESS != (error = clReleaseMemObject(node->A))) { TR_FAILED("clReleaseMemObject(A)", error); }
+    if (node->kernel != NULL) { clReleaseKernel(node->kernel); }
+    if (!OpenClContext_Release(&contexts[index])) { TR_ERROR("OpenClContext_Release(Numa) failed"); }
+  }
+
+  if (bound != NULL && CL_SUCCESS != (error = clReleaseMemObject(bound))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (R != NULL && CL_SUCCESS != (error = clReleaseMemObject(R))) { TR_FAILED("clReleaseMemObject(R)", error); }
+  if (SBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(SBuffer))) { TR_FAILED("clReleaseMemObject(Numa)", error); }
+
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_NUMA_C
@@ -0,0 +1,57 @@
+#ifndef TR_MATRIX_NUMA_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/Numa.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/Numa.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_NUMA_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+#include "matrix/MatMulContext.h" // MatMulContext{}
+
+#undef Numa
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Numa(suffix) TR_JOIN2(_, NumaFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Numa(suffix) TR_JOIN2(_, NumaDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// Runs `C = op(A) * op(B)` on every NUMA node of the device (a CPU with
+/// sub-devices by affinity domain), each node computing its own whole blocks
+/// of rows of C from node-local copies of its rows of op(A) and of B, then
+/// displays the time against the whole device (`classicMilliseconds`) and,
+/// with `--cpu-check`, the errors against a device reference.
+///
+/// @returns `true` if the nodes could be run, `false` otherwise (e.g. the
+///          device cannot be partitioned by NUMA node).
+///
+/// @pre `A` and `B` are the host operands (padded), `ABuffer` and `BBuffer`
+///      their buffers (for the reference).
+/// @post Displays on stdout, may display error on stderr.
+///
+bool Numa(Benchmark)(
+  IN MatMulContext* context,
+  IN cl_mem ABuffer, IN cl_mem BBuffer,
+  IN TR_MATRIX_PRECISION const* A,
+  IN TR_MATRIX_PRECISION const* B,
+  IN double classicMilliseconds
+);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_NUMA_H
@@ -0,0 +1,592 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <getopt.h> // getopt_long()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdint.h> // SIZE_MAX
+#include <stdio.h> // FILE, fopen(), fprintf(), printf()
+#include <stdlib.h> // malloc(), free(), qsort(), strtod()
+#include <string.h> // strcmp(), strlen()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "common/parse.h" // ParseNumbers()
+#include "matrix/MatMulContext.h" // MatMulContext_DefaultBlockSize()
+#include "matrix/Perf.h" // Self
+
+/// Defaults of the command line (see `Perf_ArgumentsUsage()`).
+#define TR_PERF_DEFAULT_BASELINE "perf/baseline.json"
+#define TR_PERF_DEFAULT_THRESHOLD 10.0 // %
+#define TR_PERF_DEFAULT_REPETITIONS 7u
+#define TR_PERF_MAX_REPETITIONS 101u
+
+/// Limits of the baseline file.
+#define TR_PERF_NAME_SIZE 128u
+#define TR_PERF_MAX_ENTRIES 1024u
+
+// Define matrixMatMulStart and matrixMatMulEnd.
+TR_OPENCL_IMPORT(matrix, MatMul)
+
+///
+/// A kernel variant of `matrix/MatMul.cl`, i.e. its build options.
+///
+typedef struct PerfVariant {
+  char const* name;
+  bool specialize, transA, transB;
+  /// The local tiles (see `--local-tiles`).
+  bool doubleBuffer, padLocal;
+} PerfVariant;
+
+///
+/// A case of the suite, run in every supported precision.
+///
+typedef struct PerfCase {
+  size_t M, N, P;
+  PerfVariant variant;
+} PerfCase;
+
+/// The fixed set of cases, extended when a kernel variant is added (the keys
+/// of the baseline must then be updated with `--update`).
+static PerfCase const perfCases[] = {
+  { 256u, 256u, 256u, { "classic", false, false, false, false, false } },
+  { 512u, 512u, 512u, { "classic", false, false, false, false, false } },
+  { 1024u, 1024u, 1024u, { "classic", false, false, false, false, false } },
+  { 1024u, 256u, 512u, { "classic", false, false, false, false, false } },
+  { 512u, 512u, 512u, { "specialize", true, false, false, false, false } },
+  { 1024u, 1024u, 1024u, { "specialize", true, false, false, false, false } },
+  { 512u, 512u, 512u, { "trans-a", false, true, false, false, false } },
+  { 512u, 512u, 512u, { "trans-b", false, false, true, false, false } },
+  { 1024u, 1024u, 1024u, { "padded", false, false, false, false, true } },
+  { 1024u, 1024u, 1024u, { "double-buffer", false, false, false, true, false } },
+  { 1024u, 1024u, 1024u, { "double-buffer-padded", false, false, false, true, true } },
+};
+
+///
+/// A timing of the baseline file, `{ "<device>": { "<key>": <milliseconds> } }`.
+///
+typedef struct PerfEntry {
+  char device[TR_PERF_NAME_SIZE];
+  char key[TR_PERF_NAME_SIZE];
+  double milliseconds;
+} PerfEntry;
+
+typedef struct PerfBaseline {
+  PerfEntry entries[TR_PERF_MAX_ENTRIES];
+  size_t count;
+} PerfBaseline;
+
+// ╔╗ ┌─┐┌─┐┌─┐┬  ┬┌┐┌┌─┐
+// ╠╩╗├─┤└─┐├┤ │  ││││├┤
+// ╚═╝┴ ┴└─┘└─┘┴─┘┴┘└┘└─┘
+
+static void SkipSpaces(INOUT char const** cursor) {
+  while (**cursor == ' ' || **cursor == '\t' || **cursor == '\n' || **cursor == '\r') { *cursor += 1; }
+}
+
+static bool Expect(INOUT char const** cursor, IN char expected) {
+  SkipSpaces(cursor);
+  if (**cursor != expected) { return false; }
+  *cursor += 1;
+  return true;
+}
+
+///
+/// Parses a JSON string (only `\"` and `\\` escapes) into `output`.
+///
+static bool ParseString(INOUT char const** cursor, OUT char* output, IN size_t size) {
+  if (!Expect(cursor, '"')) { return false; }
+
+  size_t length = 0u;
+  for (; **cursor != '"'; *cursor += 1) {
+    if (**cursor == '\0') { return false; }
+    if (**cursor == '\\') { *cursor += 1; }
+    if (**cursor == '\0' || length + 1u >= size) { return false; }
+    output[length++] = **cursor;
+  }
+
+  output[length] = '\0';
+  *cursor += 1;
+  return true;
+}
+
+///
+/// Parses the baseline file, a missing file being an empty baseline.
+///
+static bool LoadBaseline(IN char const* path, OUT PerfBaseline* baseline) {
+  baseline->count = 0u;
+
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) { return true; }
+
+  bool success = false;
+  char* content = NULL;
+  if (fseek(file, 0, SEEK_END) != 0) { goto out; }
+  long size = ftell(file);
+  if (size < 0 || fseek(file, 0, SEEK_SET) != 0) { goto out; }
+
+  content = (char*) malloc((size_t) size + 1u);
+  if (content == NULL || fread(content, 1u, (size_t) size, file) != (size_t) size) { goto out; }
+  content[size] = '\0';
+
+  char const* cursor = content;
+  if (!Expect(&cursor, '{')) { goto out; }
+  if (Expect(&cursor, '}')) { success = true; goto out; }
+
+  do {
+    char device[TR_PERF_NAME_SIZE];
+    if (!ParseString(&cursor, device, sizeof(device)) || !Expect(&cursor, ':') || !Expect(&cursor, '{')) { goto out; }
+    if (Expect(&cursor, '}')) { continue; }
+
+    do {
+      if (baseline->count == TR_PERF_MAX_ENTRIES) { goto out; }
+      PerfEntry* entry = &baseline->entries[baseline->count];
+      snprintf(entry->device, sizeof(entry->device), "%s", device);
+      if (!ParseString(&cursor, entry->key, sizeof(entry->key)) || !Expect(&cursor, ':')) { goto out; }
+
+      SkipSpaces(&cursor);
+      char* end = NULL;
+      entry->milliseconds = strtod(cursor, &end);
+      if (end == cursor) { goto out; }
+      cursor = end;
+      baseline->count += 1u;
+    } while (Expect(&cursor, ','));
+
+    if (!Expect(&cursor, '}')) { goto out; }
+  } while (Expect(&cursor, ','));
+
+  success = Expect(&cursor, '}');
+
+out:
+  if (!success) { TR_ERROR("The baseline \"%s\" is not a valid { \"<device>\": { \"<case>\": <ms> } } file.", path); }
+  if (content != NULL) { free(content); }
+  fclose(file);
+  return success;
+}
+
+static void WriteString(IN FILE* file, IN char const* string) {
+  fputc('"', file);
+  for (; *string != '\0'; ++string) {
+    if (*string == '"' || *string == '\\') { fputc('\\', file); }
+    fputc(*string, file);
+  }
+  fputc('"', file);
+}
+
+///
+/// Writes the baseline file, the devices in their order of appearance.
+///
+static bool SaveBaseline(IN char const* path, IN PerfBaseline const* baseline) {
+  FILE* file = fopen(path, "wb");
+  if (file == NULL) {
+    TR_ERROR("The baseline \"%s\" cannot be written.", path);
+    return false;
+  }
+
+  fprintf(file, "{");
+  bool firstDevice = true;
+  for (size_t index = 0u; index < baseline->count; ++index) {
+    char const* device = baseline->entries[index].device;
+
+    bool seen = false;
+    for (size_t previous = 0u; previous < index && !seen; ++previous) {
+      seen = strcmp(baseline->entries[previous].device, device) == 0;
+    }
+    if (seen) { continue; }
+
+    fprintf(file, "%s\n  ", firstDevice ? "" : ",");
+    WriteString(file, device);
+    fprintf(file, ": {");
+    firstDevice = false;
+
+    bool firstKey = true;
+    for (size_t other = index; other < baseline->count; ++other) {
+      PerfEntry const* entry = &baseline->entries[other];
+      if (strcmp(entry->device, device) != 0) { continue; }
+      fprintf(file, "%s\n    ", firstKey ? "" : ",");
+      WriteString(file, entry->key);
+      fprintf(file, ": %.4f", entry->milliseconds);
+      firstKey = false;
+    }
+
+    fprintf(file, "\n  }");
+  }
+
+  fprintf(file, "\n}\n");
+  bool written = !ferror(file);
+  if (fclose(file) != 0 || !written) {
+    TR_ERROR("The baseline \"%s\" could not be written completely.", path);
+    return false;
+  }
+
+  return true;
+}
+
+static PerfEntry* FindEntry(INOUT PerfBaseline* baseline, IN char const* device, IN char const* key) {
+  for (size_t index = 0u; index < baseline->count; ++index) {
+    PerfEntry* entry = &baseline->entries[index];
+    if (strcmp(entry->device, device) == 0 && strcmp(entry->key, key) == 0) {
+      return entry;
+    }
+  }
+
+  return NULL;
+}
+
+// ╔╦╗┬┌┬┐┬┌┐┌┌─┐
+//  ║ │││││││││ ┬
+//  ╩ ┴┴ ┴┴┘└┘└─┘
+
+static int CompareDoubles(IN void const* a, IN void const* b) {
+  double x = *(double const*) a, y = *(double const*) b;
+  return (x > y) - (x < y);
+}
+
+///
+/// Times a case in a precision by the median of `repetitions` runs (after a
+/// warm-up run), from the profiling events.
+///
+static bool TimeCase(
+  IN OpenClContext* openCl, IN PerfCase const* perfCase, IN bool doublePrecision,
+  IN size_t blockSize, IN size_t repetitions, OUT double* milliseconds)
+{
+  cl_int error;
+  bool success = false;
+  cl_kernel kernel = NULL;
+  cl_mem buffers[3] = { NULL };
+  double samples[TR_PERF_MAX_REPETITIONS];
+
+  size_t M = perfCase->M, N = perfCase->N, P = perfCase->P;
+  size_t elementSize = doublePrecision ? sizeof(double) : sizeof(float);
+
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  int length = snprintf(options, sizeof(options),
+    "-DMATMUL_BLOCKSIZE=%zu -DMATMUL_REAL=%s%s%s%s%s"
+    , blockSize
+    , doublePrecision ? "double" : "float"
+    , perfCase->variant.transA ? " -DTRANS_A" : ""
+    , perfCase->variant.transB ? " -DTRANS_B" : ""
+    , perfCase->variant.doubleBuffer ? " -DMATMUL_DOUBLE_BUFFER" : ""
+    , perfCase->variant.padLocal ? " -DMATMUL_LOCAL_PAD=1" : ""
+  );
+
+  if (perfCase->variant.specialize && length > 0 && (size_t) length < sizeof(options)) {
+    snprintf(options + length, sizeof(options) - (size_t) length,
+      " -DMATMUL_M=%zu -DMATMUL_N=%zu -DMATMUL_P=%zu -DMATMUL_LDA=%zu -DMATMUL_LDB=%zu -DMATMUL_LDC=%zu"
+      , M, N, P, perfCase->variant.transA ? M : N, perfCase->variant.transB ? N : P, P);
+  }
+
+  kernel = ProgramCache_GetKernel(openCl, matrixMatMulStart, matrixMatMulEnd, options, "MatMul");
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(MatMul) failed");
+    goto out;
+  }
+
+  // The timings do not depend on the values, a constant is enough.
+  size_t const sizes[3] = { M * N, N * P, M * P };
+  float const floatPattern = 0.5f;
+  double const doublePattern = 0.5;
+  void const* pattern = doublePrecision ? (void const*) &doublePattern : (void const*) &floatPattern;
+
+  for (size_t index = 0u; index < 3u; ++index) {
+    buffers[index] = clCreateBuffer(openCl->context, CL_MEM_READ_WRITE, elementSize * sizes[index], NULL, &error);
+    if (error != CL_SUCCESS || buffers[index] == NULL) {
+      TR_FAILED("clCreateBuffer(Perf)", error);
+      goto out;
+    }
+
+    error = clEnqueueFillBuffer(openCl->queue, buffers[index], pattern, elementSize, 0u, elementSize * sizes[index], 0, NULL, NULL);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clEnqueueFillBuffer(Perf)", error);
+      goto out;
+    }
+  }
+
+  cl_uint arguments[3] = { (cl_uint) M, (cl_uint) N, (cl_uint) P };
+  error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < 3u; ++index) {
+    error |= clSetKernelArg(kernel, index, sizeof(cl_uint), &arguments[index]);
+    error |= clSetKernelArg(kernel, 3u + index, sizeof(cl_mem), &buffers[index]);
+  }
+
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Perf)", error);
+    goto out;
+  }
+
+  size_t globalSize[2] = { P, M }; // (x, y) or (columns, rows)
+  size_t localSize[2] = { blockSize, blockSize };
+  for (size_t run = 0u; run <= repetitions; ++run) {
+    cl_event event = NULL;
+    error = clEnqueueNDRangeKernel(openCl->queue, kernel, 2, NULL, globalSize, localSize, 0, NULL, &event);
+    if (error != CL_SUCCESS || CL_SUCCESS != (error = clWaitForEvents(1, &event))) {
+      TR_FAILED("clEnqueueNDRangeKernel(Perf)", error);
+      if (event != NULL) { clReleaseEvent(event); }
+      goto out;
+    }
+
+    cl_ulong start = 0u, end = 0u;
+    error  = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+    error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+    clReleaseEvent(event);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clGetEventProfilingInfo(Perf)", error);
+      goto out;
+    }
+
+    // The first run warms the caches and the driver up.
+    if (run > 0u) { samples[run - 1u] = (double) (end - start) * 1e-6; }
+  }
+
+  qsort(samples, repetitions, sizeof(double), CompareDoubles);
+  *milliseconds = repetitions % 2u == 1u
+    ? samples[repetitions / 2u]
+    : (samples[repetitions / 2u - 1u] + samples[repetitions / 2u]) / 2.0;
+  success = true;
+
+out:
+  for (size_t index = 0u; index < 3u; ++index) {
+    if (buffers[index] != NULL && CL_SUCCESS != (error = clReleaseMemObject(buffers[index]))) { TR_FAILED("clReleaseMemObject(Perf)", error); }
+  }
+
+  if (kernel != NULL) { clReleaseKernel(kernel); }
+  return success;
+}
+
+// ╔═╗┌─┐┌┬┐┌┬┐┌─┐┌┐┌┌┬┐
+// ║  │ ││││││││├─┤│││ ││
+// ╚═╝└─┘┴ ┴┴ ┴┴ ┴┘└┘╶┴┘
+
+void Perf_ArgumentsUsage(IN FILE* stream, IN char const* command) {
+  assert(stream != NULL);
+  assert(command != NULL);
+
+  fprintf(stream,
+    TAB1 BOLD("%s") LF
+
+    TAB2 "Times a fixed set of shapes, precisions and MatMul kernel variants (median of runs)" LF
+    TAB2 "and compares them against the baseline of the device, failing on regressions:" LFLF
+
+    TAB2 BOLD("-d, --device") " GPU | CPU | Default | Fastest | <PlatformIndex>:<DeviceIndex>" LF
+    TAB3 "Specifies which device to use (prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-b, --baseline") " <Path>" LF
+    TAB3 "The JSON baseline, keyed by device name then by case (default " TR_PERF_DEFAULT_BASELINE ")." LFLF
+
+    TAB2 BOLD("-t, --threshold") " <Percent>" LF
+    TAB3 "How much slower than its baseline a case may be before failing (default 10)." LFLF
+
+    TAB2 BOLD("-n, --repetitions") " <Runs>" LF
+    TAB3 "The number of timed runs of each case, after a warm-up one (default 7, at most 101)." LFLF
+
+    TAB2 BOLD("-u, --update") LF
+    TAB3 "Replaces the baseline of the device with the new timings instead of failing." LFLF
+
+    TAB2 BOLD("-m, --allow-missing") LF
+    TAB3 "Passes the cases without baseline for the device instead of failing on them." LFLF
+
+    TAB2 BOLD("-h, --help") LF
+    TAB3 "Displays this help and quit." LFLF
+
+    , command
+  );
+}
+
+int Perf_Run(IN int argc, IN char* argv[]) {
+  assert(argc >= 1 && argv[0] != NULL);
+
+  static struct option options[] = {
+    { "device", required_argument, NULL, 'd' },
+    { "baseline", required_argument, NULL, 'b' },
+    { "threshold", required_argument, NULL, 't' },
+    { "repetitions", required_argument, NULL, 'n' },
+    { "update", no_argument, NULL, 'u' },
+    { "allow-missing", no_argument, NULL, 'm' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 },
+  };
+
+  int option;
+  char const* device = "Default";
+  char const* path = TR_PERF_DEFAULT_BASELINE;
+  char const* threshold = NULL;
+  char const* repetitions = NULL;
+  bool update = false;
+  bool allowMissing = false;
+
+  opterr = 1; // Prints error on stderr.
+  while (0 <= (option = getopt_long(argc, argv, "d:b:t:n:umh", options, NULL))) {
+    switch (option) {
+      case 'd': device = optarg; break;
+      case 'b': path = optarg; break;
+      case 't': threshold = optarg; break;
+      case 'n': repetitions = optarg; break;
+      case 'u': update = true; break;
+      case 'm': allowMissing = true; break;
+      case 'h':
+        Perf_ArgumentsUsage(stdout, argv[0]);
+        return 2;
+      default:
+        return 0;
+    }
+  }
+
+  double limit = TR_PERF_DEFAULT_THRESHOLD;
+  if (threshold != NULL) {
+    char* end = NULL;
+    limit = strtod(threshold, &end);
+    if (end == threshold || *end != '\0' || !(limit >= 0.0)) {
+      fprintf(stderr, LF "The threshold must be a non-negative percentage:" LF TAB1 "--threshold %s" LFLF, threshold);
+      return 0;
+    }
+  }
+
+  size_t runs = TR_PERF_DEFAULT_REPETITIONS;
+  if (repetitions != NULL) {
+    char const* cursor = repetitions;
+    if (!ParseNumbers(&cursor, &runs, 1) || runs == 0u || runs > TR_PERF_MAX_REPETITIONS) {
+      fprintf(stderr, LF "The number of runs must be between 1 and %u:" LF TAB1 "--repetitions %s" LFLF
+        , TR_PERF_MAX_REPETITIONS, repetitions);
+      return 0;
+    }
+  }
+
+  int result = 0;
+  OpenClContext openCl;
+  PerfBaseline* baseline = (PerfBaseline*) malloc(sizeof(PerfBaseline));
+  if (baseline == NULL) {
+    TR_ERROR("malloc(PerfBaseline) failed");
+    return 0;
+  }
+
+  if (!LoadBaseline(path, baseline)) {
+    free(baseline);
+    return 0;
+  }
+
+  if (OpenClContext_FromString(device, &openCl) != 1) {
+    fprintf(stderr, LF "The device cannot be opened:" LF TAB1 "--device %s" LFLF, device);
+    free(baseline);
+    return 0;
+  }
+
+  char name[TR_PERF_NAME_SIZE] = { 0x0 };
+  cl_int error = clGetDeviceInfo(openCl.device, CL_DEVICE_NAME, sizeof(name) - 1u, name, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetDeviceInfo(CL_DEVICE_NAME)", error);
+    goto out;
+  }
+
+  // The default block size of MatMul, the same for every case so that they
+  // compare with each other, thus the one of the largest local tiles.
+  size_t blockSize = SIZE_MAX;
+  size_t caseCount = sizeof(perfCases) / sizeof(perfCases[0]);
+  for (size_t index = 0u; index < caseCount; ++index) {
+    PerfVariant const* variant = &perfCases[index].variant;
+    size_t fitting = MatMulContext_DefaultBlockSize(&openCl.capabilities, sizeof(double)
+      , variant->doubleBuffer, variant->padLocal);
+    blockSize = fitting < blockSize ? fitting : blockSize;
+  }
+
+  bool fp64 = OpenClContext_EnableDoublePrecision(&openCl);
+
+  printf(
+    TAB0 "Performance Suite:" LF
+    TAB1 "Device.................: %s" LF
+    TAB1 "Baseline...............: %s" LF
+    TAB1 "Threshold..............: %.1f%%" LF
+    TAB1 "Repetitions............: %zu (median)" LF
+    TAB1 "Block.Size.............: %zu" LFLF
+    , name, path, limit, runs, blockSize
+  );
+
+  size_t regressions = 0u, missing = 0u, dropped = 0u;
+  for (size_t precision = 0u; precision < 2u; ++precision) {
+    bool doublePrecision = precision == 1u;
+    for (size_t index = 0u; index < caseCount; ++index) {
+      PerfCase const* perfCase = &perfCases[index];
+      char key[TR_PERF_NAME_SIZE];
+      snprintf(key, sizeof(key), "%s/%zux%zux%zu/%s", doublePrecision ? "double" : "float"
+        , perfCase->M, perfCase->N, perfCase->P, perfCase->variant.name);
+
+      if (doublePrecision && !fp64) {
+        printf(TAB1 "%-36s Skipped (no double-precision)" LF, key);
+        continue;
+      }
+
+      double milliseconds = 0.0;
+      if (!TimeCase(&openCl, perfCase, doublePrecision, blockSize, runs, &milliseconds)) {
+        TR_ERROR("The case %s could not be run.", key);
+        goto out;
+      }
+
+      PerfEntry* entry = FindEntry(baseline, name, key);
+      if (update) {
+        if (entry == NULL && baseline->count < TR_PERF_MAX_ENTRIES) {
+          entry = &baseline->entries[baseline->count++];
+          snprintf(entry->device, sizeof(entry->device), "%s", name);
+          snprintf(entry->key, sizeof(entry->key), "%s", key);
+        }
+
+        if (entry == NULL) {
+          dropped += 1u;
+          printf(TAB1 "%-36s %10.4f ms (baseline full)" LF, key, milliseconds);
+          continue;
+        }
+
+        entry->milliseconds = milliseconds;
+        printf(TAB1 "%-36s %10.4f ms (updated)" LF, key, milliseconds);
+        continue;
+      }
+
+      if (entry == NULL || !(entry->milliseconds > 0.0)) {
+        missing += 1u;
+        printf(TAB1 "%-36s %10.4f ms (no baseline)" LF, key, milliseconds);
+        continue;
+      }
+
+      double change = 100.0 * (milliseconds - entry->milliseconds) / entry->milliseconds;
+      bool regressed = change > limit;
+      regressions += regressed ? 1u : 0u;
+      printf(TAB1 "%-36s %10.4f ms (baseline %10.4f ms, %+6.1f%%) %s" LF
+        , key, milliseconds, entry->milliseconds, change, regressed ? BOLD("Regressed") : "Passed");
+    }
+  }
+
+  printf(LF);
+  if (update) {
+    if (!SaveBaseline(path, baseline)) {
+      fprintf(stderr, TAB1 "The baseline of \"%s\" was not written to %s." LFLF, name, path);
+      goto out;
+    }
+
+    if (dropped > 0u) {
+      fprintf(stderr, TAB1 "%zu case%s not recorded, the baseline is limited to %u entries." LFLF
+        , dropped, dropped >= 2u ? "s" : "", TR_PERF_MAX_ENTRIES);
+      goto out;
+    }
+
+    printf(TAB1 "Baseline of \"%s\" written to %s." LFLF, name, path);
+    result = 1;
+  }
+  else {
+    // A device without baseline would otherwise pass whatever its timings.
+    if (missing > 0u) {
+      printf(TAB1 "%zu case%s without baseline for this device (run with --update to record them%s)." LF
+        , missing, missing >= 2u ? "s" : "", allowMissing ? "" : ", or with --allow-missing");
+    }
+
+    printf(TAB1 "%zu regression%s beyond %.1f%%." LFLF, regressions, regressions >= 2u ? "s" : "", limit);
+    result = regressions == 0u && (missing == 0u || allowMissing) ? 1 : 0;
+  }
+
+out:
+  if (!OpenClContext_Release(&openCl)) {
+    TR_ERROR("OpenClContext_Release() failed");
+  }
+
+  free(baseline);
+  return result;
+}
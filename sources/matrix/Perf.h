@@ -0,0 +1,30 @@
+#ifndef TR_MATRIX_PERF_H
+#define TR_MATRIX_PERF_H
+
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // FILE
+
+#include "common/helper.h" // IN, INOUT, OUT
+
+///
+/// Displays the usage of the `perf` command.
+///
+/// @pre `stream` and `command` are not NULL.
+///
+void Perf_ArgumentsUsage(IN FILE* stream, IN char const* command);
+
+///
+/// Runs the performance regression suite (the `perf` command): a fixed set of
+/// shapes, precisions and MatMul kernel variants, each timed by the median of
+/// several runs, then compared against the baseline of the device (keyed by
+/// its name) in a JSON file.
+///
+/// @returns `0` if a case regressed beyond the threshold, has no baseline
+///          (unless `--allow-missing`) or on failure, `1` on success, `2` for
+///          `--help`.
+///
+/// @post Displays on stdout, may display error on stderr.
+///
+int Perf_Run(IN int argc, IN char* argv[]);
+
+#endif // TR_MATRIX_PERF_H
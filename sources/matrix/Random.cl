@@ -0,0 +1,80 @@
+#ifndef RANDOM_REAL
+#define RANDOM_REAL float
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+
+typedef RANDOM_REAL Real;
+
+///
+/// Philox4x32-10 counter-based random number generator.
+///
+/// IMPORTANT: This is the exact same generator as `common/philox.h` on the host,
+/// both must be kept bit-identical.
+///
+
+#define PHILOX_M0 0xD2511F53u
+#define PHILOX_M1 0xCD9E8D57u
+#define PHILOX_W0 0x9E3779B9u
+#define PHILOX_W1 0xBB67AE85u
+#define PHILOX_ROUNDS 10
+
+static uint4 Philox4x32(uint4 counter, uint2 key) {
+  for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+    uint high0 = mul_hi(PHILOX_M0, counter.x), low0 = PHILOX_M0 * counter.x;
+    uint high1 = mul_hi(PHILOX_M1, counter.z), low1 = PHILOX_M1 * counter.z;
+
+    counter = (uint4) (high1 ^ counter.y ^ key.x, low1, high0 ^ counter.w ^ key.y, low0);
+    key += (uint2) (PHILOX_W0, PHILOX_W1);
+  }
+
+  return counter;
+}
+
+///
+/// Fills a row-major `(rowsPadded, columnsPadded)` matrix with random values in
+/// [-1, 1) and zeroes its padding.
+///
+/// The value of `(row, column)` only depends on `(seed, stream, row, column)`,
+/// neither on the padding nor on the work-group size.
+///
+/// @pre get_global_size(0, 1) is (columnsPadded, rowsPadded).
+///
+__kernel void FillRandom(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned int const stream,
+  IN unsigned int const seedLow,
+  IN unsigned int const seedHigh,
+  OUT __global Real* matrix)
+{
+  size_t column = get_global_id(0);
+  size_t row = get_global_id(1);
+  size_t stride = get_global_size(0);
+
+  Real value = 0;
+
+  if (row < rows && column < columns) {
+    uint4 random = Philox4x32((uint4) ((uint) column, (uint) row, stream, 0u), (uint2) (seedLow, seedHigh));
+
+#if defined(cl_khr_fp64) || defined(cl_amd_fp64)
+    if (sizeof(Real) == sizeof(double)) {
+      ulong bits = ((ulong) random.x << 21) ^ (ulong) (random.y >> 11);
+      value = (Real) ((double) bits * 0x1.0p-52 - 1.0);
+    }
+    else
+#endif
+    {
+      value = (Real) ((float) (random.x >> 8) * 0x1.0p-23f - 1.0f);
+    }
+  }
+
+  matrix[row * stride + column] = value;
+}
@@ -0,0 +1,23 @@
+#ifndef TR_MATRIX_RANDOMSTREAMS_H
+#define TR_MATRIX_RANDOMSTREAMS_H
+
+///
+/// The random streams (see `common/philox.h`) of the matrix commands, all keyed
+/// by the same `--seed`, thus defined together so that no two inputs share a
+/// stream. The device fills of A and B (`matrix/Random.cl`) use the same ones.
+///
+
+#define TR_STREAM_A 0u
+#define TR_STREAM_B 1u
+#define TR_STREAM_C 2u // Previous C of the epilogue (beta).
+#define TR_STREAM_BIAS 3u // Bias vector of the epilogue.
+#define TR_STREAM_SAMPLES 4u // Elements of C checked by DF64.
+
+/// The vectors `r` of the Freivalds trials, the trial k using the stream
+/// `TR_STREAM_FREIVALDS + k`, in a range of their own (hence the most trials).
+#define TR_STREAM_FREIVALDS 0x10000u
+#define TR_STREAM_FREIVALDS_TRIALS 0x10000u
+
+#define TR_STREAM_SPARSITY 0xFFFFFFFFu // Mask of the sparse B.
+
+#endif // TR_MATRIX_RANDOMSTREAMS_H
@@ -0,0 +1,276 @@
+#ifndef TR_MATRIX_SPMM_C
+#ifndef TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // printf(), snprintf()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+
+#define GETKERNEL(TYPE) TR_JOIN2(_, GetSpMMKernel, TYPE)
+#define DISPLAYCHECK(TYPE) TR_JOIN2(_, DisplaySpMMCheck, TYPE)
+
+/// Work-group size of SpMMRows (a power of 2).
+#define TR_SPMM_GROUP 64u
+
+/// Merge path items (row ends and non-zeros) per work-item of SpMMMerge.
+#define TR_SPMM_ITEMS 16u
+
+// Define matrixSpMMStart and matrixSpMMEnd.
+TR_OPENCL_IMPORT(matrix, SpMM)
+
+///
+/// Returns the device time from the start of `first` to the end of `last`.
+///
+static double ElapsedMilliseconds(IN cl_event first, IN cl_event last) {
+  cl_ulong start = 0u, end = 0u;
+  cl_int error = clGetEventProfilingInfo(first, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo(SpMM)", error);
+    return 0.0;
+  }
+
+  return (double) (end - start) * 1e-6;
+}
+
+#define TR_MATRIX_PRECISION float
+#include "matrix/SpMM.c"
+#undef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION double
+#  include "matrix/SpMM.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_SPMM_C
+#else // TR_MATRIX_PRECISION
+
+#include "matrix/Compare.h" // Compare(), CompareStatistics{}
+#include "matrix/SpMM.h" // SpMM(), SpMMStrategy{}, SparseMatrix()
+
+///
+/// Returns the kernel `name` of `matrix/SpMM.cl` (built once per precision).
+///
+/// @returns A retained kernel, or NULL on failure.
+///
+static cl_kernel GETKERNEL(TR_MATRIX_PRECISION)(IN OpenClContext* openCl, IN char const* name) {
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options), "-DSPMM_REAL=%s -DSPMM_GROUP=%u", TR_STRINGIFY(TR_MATRIX_PRECISION), TR_SPMM_GROUP);
+  return ProgramCache_GetKernel(openCl, matrixSpMMStart, matrixSpMMEnd, options, name);
+}
+
+bool SpMM(Run)(
+  IN MatMulContext* this, IN SpMMStrategy strategy,
+  IN SparseMatrix()* S, IN cl_mem A, OUT cl_mem C,
+  OUT double* milliseconds)
+{
+  assert(this != NULL && S != NULL && milliseconds != NULL);
+  assert(S->rowOffsetsMemory != NULL && A != NULL && C != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_command_queue queue = this->openCl.queue;
+  cl_kernel kernel = NULL, fixup = NULL;
+  cl_mem carryRows = NULL, carryValues = NULL;
+  cl_event first = NULL, last = NULL;
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  // op(A)[m][k], whatever the storage order.
+  cl_uint strides[3] = {
+    (cl_uint) (this->transA ? 1u : N),
+    (cl_uint) (this->transA ? M : 1u),
+    (cl_uint) P,
+  };
+
+  cl_uint rows = (cl_uint) S->rows;
+  cl_mem sparse[3] = { S->rowOffsetsMemory, S->columnIndicesMemory, S->valuesMemory };
+  *milliseconds = 0.0;
+
+  if (strategy == SpMMStrategy_Rows) {
+    kernel = GETKERNEL(TR_MATRIX_PRECISION)(&this->openCl, "SpMMRows");
+    if (kernel == NULL) { TR_ERROR("ProgramCache_GetKernel(SpMMRows) failed"); goto out; }
+
+    error  = clSetKernelArg(kernel, 0, sizeof(cl_uint), &rows);
+    error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &strides[0]);
+    error |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &strides[1]);
+    error |= clSetKernelArg(kernel, 3, sizeof(cl_uint), &strides[2]);
+    error |= clSetKernelArg(kernel, 4, sizeof(cl_mem), &sparse[0]);
+    error |= clSetKernelArg(kernel, 5, sizeof(cl_mem), &sparse[1]);
+    error |= clSetKernelArg(kernel, 6, sizeof(cl_mem), &sparse[2]);
+    error |= clSetKernelArg(kernel, 7, sizeof(cl_mem), &A);
+    error |= clSetKernelArg(kernel, 8, sizeof(cl_mem), &C);
+    if (error != CL_SUCCESS) { TR_FAILED("clSetKernelArg(SpMMRows)", error); goto out; }
+
+    size_t globalSize[2] = { S->rows * TR_SPMM_GROUP, this->M };
+    size_t localSize[2] = { TR_SPMM_GROUP, 1u };
+    error = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, globalSize, localSize, 0, NULL, &first);
+    if (error != CL_SUCCESS) { TR_FAILED("clEnqueueNDRangeKernel(SpMMRows)", error); goto out; }
+  }
+  else {
+    kernel = GETKERNEL(TR_MATRIX_PRECISION)(&this->openCl, "SpMMMerge");
+    fixup = GETKERNEL(TR_MATRIX_PRECISION)(&this->openCl, "SpMMFixup");
+    if (kernel == NULL || fixup == NULL) { TR_ERROR("ProgramCache_GetKernel(SpMMMerge, SpMMFixup) failed"); goto out; }
+
+    cl_uint nonZeros = (cl_uint) S->nonZeros, items = TR_SPMM_ITEMS;
+    cl_uint threads = (cl_uint) ((S->rows + S->nonZeros + TR_SPMM_ITEMS - 1u) / TR_SPMM_ITEMS);
+    if (threads == 0u) { threads = 1u; }
+
+    carryRows = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, sizeof(cl_uint) * threads, NULL, &error);
+    if (error != CL_SUCCESS || carryRows == NULL) { TR_FAILED("clCreateBuffer(carryRows)", error); goto out; }
+    carryValues = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * threads * this->M, NULL, &error);
+    if (error != CL_SUCCESS || carryValues == NULL) { TR_FAILED("clCreateBuffer(carryValues)", error); goto out; }
+
+    error  = clSetKernelArg(kernel, 0, sizeof(cl_uint), &rows);
+    error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &nonZeros);
+    error |= clSetKernelArg(kernel, 2, sizeof(cl_uint), &items);
+    error |= clSetKernelArg(kernel, 3, sizeof(cl_uint), &strides[0]);
+    error |= clSetKernelArg(kernel, 4, sizeof(cl_uint), &strides[1]);
+    error |= clSetKernelArg(kernel, 5, sizeof(cl_uint), &strides[2]);
+    error |= clSetKernelArg(kernel, 6, sizeof(cl_mem), &sparse[0]);
+    error |= clSetKernelArg(kernel, 7, sizeof(cl_mem), &sparse[1]);
+    error |= clSetKernelArg(kernel, 8, sizeof(cl_mem), &sparse[2]);
+    error |= clSetKernelArg(kernel, 9, sizeof(cl_mem), &A);
+    error |= clSetKernelArg(kernel, 10, sizeof(cl_mem), &C);
+    error |= clSetKernelArg(kernel, 11, sizeof(cl_mem), &carryRows);
+    error |= clSetKernelArg(kernel, 12, sizeof(cl_mem), &carryValues);
+    error |= clSetKernelArg(fixup, 0, sizeof(cl_uint), &rows);
+    error |= clSetKernelArg(fixup, 1, sizeof(cl_uint), &threads);
+    error |= clSetKernelArg(fixup, 2, sizeof(cl_uint), &strides[2]);
+    error |= clSetKernelArg(fixup, 3, sizeof(cl_mem), &carryRows);
+    error |= clSetKernelArg(fixup, 4, sizeof(cl_mem), &carryValues);
+    error |= clSetKernelArg(fixup, 5, sizeof(cl_mem), &C);
+    if (error != CL_SUCCESS) { TR_FAILED("clSetKernelArg(SpMMMerge)", error); goto out; }
+
+    size_t globalSize[2] = { threads, this->M };
+    error = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, globalSize, NULL, 0, NULL, &first);
+    if (error != CL_SUCCESS) { TR_FAILED("clEnqueueNDRangeKernel(SpMMMerge)", error); goto out; }
+
+    size_t fixupSize = this->M;
+    error = clEnqueueNDRangeKernel(queue, fixup, 1, NULL, &fixupSize, NULL, 0, NULL, &last);
+    if (error != CL_SUCCESS) { TR_FAILED("clEnqueueNDRangeKernel(SpMMFixup)", error); goto out; }
+  }
+
+  if (CL_SUCCESS != (error = clWaitForEvents(1, last != NULL ? &last : &first))) {
+    TR_FAILED("clWaitForEvents(SpMM)", error);
+    goto out;
+  }
+
+  *milliseconds = ElapsedMilliseconds(first, last != NULL ? last : first);
+  success = true;
+
+out:
+  if (last != NULL) { clReleaseEvent(last); }
+  if (first != NULL) { clReleaseEvent(first); }
+  if (carryValues != NULL && CL_SUCCESS != (error = clReleaseMemObject(carryValues))) { TR_FAILED("clReleaseMemObject(carryValues)", error); }
+  if (carryRows != NULL && CL_SUCCESS != (error = clReleaseMemObject(carryRows))) { TR_FAILED("clReleaseMemObject(carryRows)", error); }
+  if (fixup != NULL) { clReleaseKernel(fixup); }
+  if (kernel != NULL) { clReleaseKernel(kernel); }
+
+  return success;
+}
+
+///
+/// Displays the timing of a strategy (against the dense kernel) and its errors.
+///
+static void DISPLAYCHECK(TR_MATRIX_PRECISION)(
+  IN char const* timeLabel, IN char const* checkLabel,
+  IN double milliseconds, IN double classicMilliseconds, IN double operations,
+  IN CompareStatistics const* statistics)
+{
+  printf(TAB1 "%s%.3f ms (x%.2f against dense, %.3f effective GFLOP/s)" LF
+    , timeLabel, milliseconds
+    , milliseconds > 0.0 ? classicMilliseconds / milliseconds : 0.0
+    , milliseconds > 0.0 ? operations / (milliseconds * 1e6) : 0.0
+  );
+
+  if (statistics != NULL) {
+    printf(TAB1 "%s%s (max. error %g absolute, %g relative)" LF
+      , checkLabel
+      , statistics->failures == 0u && statistics->nonFinite == 0u ? "Passed" : "Failed"
+      , statistics->maxAbsoluteError, statistics->maxRelativeError
+    );
+  }
+}
+
+bool SpMM(Benchmark)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B,
+  IN TR_MATRIX_PRECISION const* BHost,
+  IN double classicMilliseconds)
+{
+  assert(this != NULL && BHost != NULL);
+  assert(A != NULL && B != NULL);
+
+  cl_int error;
+  bool success = false;
+  SparseMatrix() S = { 0 };
+  cl_mem SBuffer = NULL, R = NULL, bound = NULL;
+
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  // S = op(B)^T, i.e. S[p][n] = op(B)[n][p], whatever the storage order of B.
+  TR_MATMUL_LOG(this, 1, "Compress B (CSR).");
+  if (!SparseMatrix(NewFromDense)(this->P, this->N, this->transB ? N : 1u, this->transB ? 1u : P, BHost, &S)
+    || !SparseMatrix(Upload)(&this->openCl, &S)) {
+    goto out;
+  }
+
+  SBuffer = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * M * P, NULL, &error);
+  if (error != CL_SUCCESS || SBuffer == NULL) {
+    TR_FAILED("clCreateBuffer(SpMM)", error);
+    goto out;
+  }
+
+  if (this->cpuCheck) {
+    TR_MATMUL_LOG(this, 1, "Compute the Dense Reference on Device.");
+    if (!Compare(NewReference)(this, A, B, &R, &bound)) {
+      goto out;
+    }
+  }
+
+  size_t denseBytes = sizeof(TR_MATRIX_PRECISION) * this->N * this->P;
+  size_t sparseBytes = sizeof(cl_uint) * (S.rows + 1u) + (sizeof(cl_uint) + sizeof(TR_MATRIX_PRECISION)) * S.nonZeros;
+  printf(TAB1 "Sparse.B...............: %zu non-zeros (%.3f%%), %zu bytes in CSR instead of %zu" LF
+    , S.nonZeros, 100.0 * (double) S.nonZeros / (double) (this->N * this->P), sparseBytes, denseBytes);
+
+  double operations = 2.0 * (double) this->M * (double) S.nonZeros;
+  SpMMStrategy const strategies[2] = { SpMMStrategy_Rows, SpMMStrategy_Merge };
+  char const* const timeLabels[2] = { "SpMM.Rows.Time.........: ", "SpMM.Merge.Time........: " };
+  char const* const checkLabels[2] = { "SpMM.Rows.Check........: ", "SpMM.Merge.Check.......: " };
+
+  for (size_t index = 0u; index < 2u; ++index) {
+    double milliseconds = 0.0;
+    TR_MATMUL_LOG(this, 1, "Run SpMM (%s).", strategies[index] == SpMMStrategy_Rows ? "Rows" : "Merge");
+    if (!SpMM(Run)(this, strategies[index], &S, A, SBuffer, &milliseconds)) {
+      goto out;
+    }
+
+    CompareStatistics statistics;
+    if (R != NULL && !Compare(Buffers)(this, SBuffer, R, bound, &statistics)) {
+      goto out;
+    }
+
+    DISPLAYCHECK(TR_MATRIX_PRECISION)(timeLabels[index], checkLabels[index],
+      milliseconds, classicMilliseconds, operations, R != NULL ? &statistics : NULL);
+  }
+
+  success = true;
+
+out:
+  if (bound != NULL && CL_SUCCESS != (error = clReleaseMemObject(bound))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (R != NULL && CL_SUCCESS != (error = clReleaseMemObject(R))) { TR_FAILED("clReleaseMemObject(R)", error); }
+  if (SBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(SBuffer))) { TR_FAILED("clReleaseMemObject(SpMM)", error); }
+  if (!SparseMatrix(Release)(&S)) { TR_ERROR("SparseMatrix(Release) failed"); }
+
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_SPMM_C
@@ -0,0 +1,171 @@
+#ifndef SPMM_REAL
+#define SPMM_REAL float
+#endif
+
+#ifndef SPMM_GROUP // Work-group size of SpMMRows, must be a power of 2.
+#define SPMM_GROUP 64
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+#define INOUT
+
+typedef SPMM_REAL Real;
+
+///
+/// Sparse-dense products `C = op(A) * S^T` where S is a `(rows, columns)` CSR
+/// matrix and `op(A)` a dense `(M, columns)` matrix, whose element `(m, k)` is
+/// `A[m * rowStrideA + k * columnStrideA]` (any storage order).
+///
+/// With `S = op(B)^T`, this is `C = op(A) * op(B)` with a sparse B, and with
+/// `M = 1`, this is the SpMV `y = S * x` (`x` being the single row of A).
+///
+/// C is `(M, rows)` with the leading dimension `ldc`.
+///
+
+///
+/// One work-group per `(row of S, row of A)`, its work-items striding over the
+/// non-zeros of the row (coalesced), then reduced in local memory.
+///
+/// Simple and efficient for regular rows, but a long row stalls its work-group
+/// while short rows leave most work-items idle.
+///
+/// @pre get_global_size(0, 1) is (rows * SPMM_GROUP, M), get_local_size(0, 1) is (SPMM_GROUP, 1).
+///
+__attribute__((reqd_work_group_size(SPMM_GROUP, 1, 1)))
+__kernel void SpMMRows(
+  IN unsigned int const rows,
+  IN unsigned int const rowStrideA,
+  IN unsigned int const columnStrideA,
+  IN unsigned int const ldc,
+
+  IN  __global unsigned int const* rowOffsets,
+  IN  __global unsigned int const* columnIndices,
+  IN  __global Real const* values,
+  IN  __global Real const* A,
+  OUT __global Real      * C)
+{
+  __local Real sums[SPMM_GROUP];
+
+  size_t row = get_group_id(0);
+  size_t m = get_global_id(1);
+  size_t localId = get_local_id(0);
+
+  __global Real const* ARow = A + m * rowStrideA;
+
+  Real sum = 0;
+  for (unsigned int index = rowOffsets[row] + localId; index < rowOffsets[row + 1]; index += SPMM_GROUP) {
+    sum += values[index] * ARow[columnIndices[index] * columnStrideA];
+  }
+
+  sums[localId] = sum;
+  barrier(CLK_LOCAL_MEM_FENCE);
+
+  for (size_t stride = SPMM_GROUP / 2; stride > 0; stride >>= 1) {
+    if (localId < stride) {
+      sums[localId] += sums[localId + stride];
+    }
+
+    barrier(CLK_LOCAL_MEM_FENCE);
+  }
+
+  if (localId == 0 && row < rows) {
+    C[m * ldc + row] = sums[0];
+  }
+}
+
+///
+/// Merge-based load balancing (Merrill and Garland): the merge path of the row
+/// ends and of the non-zeros (`rows + nonZeros` items) is split in equal shares
+/// of `items`, one per work-item, whatever the distribution of the non-zeros.
+///
+/// A work-item writes the rows it completes, and its last partial row as a
+/// carry (`carryRows[t]`, `carryValues[m * threads + t]`) added by `SpMMFixup`.
+///
+/// @pre get_global_size(0, 1) is (threads, M) with `threads * items >= rows + nonZeros`.
+///
+__kernel void SpMMMerge(
+  IN unsigned int const rows,
+  IN unsigned int const nonZeros,
+  IN unsigned int const items,
+  IN unsigned int const rowStrideA,
+  IN unsigned int const columnStrideA,
+  IN unsigned int const ldc,
+
+  IN  __global unsigned int const* rowOffsets,
+  IN  __global unsigned int const* columnIndices,
+  IN  __global Real const* values,
+  IN  __global Real const* A,
+  OUT __global Real      * C,
+  OUT __global unsigned int* carryRows,
+  OUT __global Real      * carryValues)
+{
+  size_t thread = get_global_id(0);
+  size_t threads = get_global_size(0);
+  size_t m = get_global_id(1);
+
+  __global Real const* ARow = A + m * rowStrideA;
+  __global unsigned int const* rowEnds = rowOffsets + 1;
+
+  // Finds where the diagonal crosses the merge path (binary search).
+  unsigned int total = rows + nonZeros;
+  unsigned int diagonal = min((unsigned int) thread * items, total);
+  unsigned int low = diagonal > nonZeros ? diagonal - nonZeros : 0u;
+  unsigned int high = min(diagonal, rows);
+  while (low < high) {
+    unsigned int pivot = (low + high) >> 1;
+    if (rowEnds[pivot] <= diagonal - pivot - 1u) low = pivot + 1u;
+    else high = pivot;
+  }
+
+  unsigned int row = low;
+  unsigned int index = diagonal - low;
+  unsigned int end = min(diagonal + items, total);
+
+  Real sum = 0;
+  for (unsigned int item = diagonal; item < end; ++item) {
+    if (row < rows && index < rowEnds[row]) {
+      sum += values[index] * ARow[columnIndices[index] * columnStrideA];
+      index += 1u;
+    }
+    else {
+      C[m * ldc + row] = sum;
+      sum = 0;
+      row += 1u;
+    }
+  }
+
+  if (m == 0) { carryRows[thread] = row; }
+  carryValues[m * threads + thread] = sum;
+}
+
+///
+/// Adds the carries of `SpMMMerge` (a row spanning several work-items).
+///
+/// @pre get_global_size(0) is M.
+///
+__kernel void SpMMFixup(
+  IN unsigned int const rows,
+  IN unsigned int const threads,
+  IN unsigned int const ldc,
+
+  IN    __global unsigned int const* carryRows,
+  IN    __global Real const* carryValues,
+  INOUT __global Real      * C)
+{
+  size_t m = get_global_id(0);
+
+  // In order, the work-items of a row being consecutive.
+  for (unsigned int thread = 0u; thread < threads; ++thread) {
+    unsigned int row = carryRows[thread];
+    if (row < rows) {
+      C[m * ldc + row] += carryValues[m * threads + thread];
+    }
+  }
+}
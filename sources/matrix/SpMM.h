@@ -0,0 +1,82 @@
+#ifndef TR_MATRIX_SPMM_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/SpMM.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/SpMM.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_SPMM_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+#include "matrix/MatMulContext.h" // MatMulContext{}
+#include "matrix/SparseMatrix.h" // SparseMatrix()
+
+#undef SpMM
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define SpMM(suffix) TR_JOIN2(_, SpMMFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define SpMM(suffix) TR_JOIN2(_, SpMMDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// Strategies of the sparse-dense products (see `matrix/SpMM.cl`).
+///
+#ifndef TR_MATRIX_SPMM_STRATEGY
+#define TR_MATRIX_SPMM_STRATEGY
+typedef enum SpMMStrategy {
+  SpMMStrategy_Rows, ///< One work-group per row of S.
+  SpMMStrategy_Merge, ///< Merge-based load balancing.
+} SpMMStrategy;
+#endif // TR_MATRIX_SPMM_STRATEGY
+
+///
+/// Computes `C = op(A) * S^T` with the given strategy, S being uploaded, i.e.
+/// `C = op(A) * op(B)` for `S = op(B)^T`, or the SpMV `y = S * x` when A has
+/// a single row.
+///
+/// @param milliseconds Device time of the product.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `S.columns` is N and `S.rows` is P, `A` and `C` are the padded buffers.
+///
+bool SpMM(Run)(
+  IN MatMulContext* context, IN SpMMStrategy strategy,
+  IN SparseMatrix()* S, IN cl_mem A, OUT cl_mem C,
+  OUT double* milliseconds
+);
+
+///
+/// Runs both strategies with the sparse B next to the dense classic kernel
+/// (computed in `classicMilliseconds`), then displays their timings and, with
+/// `--cpu-check`, their errors against a naive reference of the dense product.
+///
+/// @param BHost The host copy of the (sparse) B stored as given to the dense kernel.
+///
+/// @returns `true` if the products could be run, `false` otherwise.
+///
+/// @post Displays on stdout, may display error on stderr.
+///
+bool SpMM(Benchmark)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B,
+  IN TR_MATRIX_PRECISION const* BHost,
+  IN double classicMilliseconds
+);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_SPMM_H
@@ -0,0 +1,116 @@
+#ifndef TR_MATRIX_SPARSEMATRIX_C
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/SparseMatrix.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/SparseMatrix.c"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_SPARSEMATRIX_C
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <limits.h> // UINT_MAX
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // fprintf()
+#include <stdlib.h> // malloc(), free()
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "matrix/SparseMatrix.h" // SparseMatrix(), Self{}
+
+bool SparseMatrix(NewFromDense)(
+  IN size_t rows, IN size_t columns,
+  IN size_t rowStride, IN size_t columnStride,
+  IN TR_MATRIX_PRECISION const* dense,
+  OUT SparseMatrix()* this)
+{
+  assert(dense != NULL && this != NULL);
+
+  *this = (SparseMatrix()) { .rows = rows, .columns = columns };
+
+  // First pass: counts the non-zeros to allocate once.
+  size_t nonZeros = 0u;
+  for (size_t row = 0u; row < rows; ++row) {
+    for (size_t column = 0u; column < columns; ++column) {
+      nonZeros += dense[row * rowStride + column * columnStride] != 0 ? 1u : 0u;
+    }
+  }
+
+  if (nonZeros > UINT_MAX || columns > UINT_MAX) {
+    TR_ERROR("The sparse matrix (%zu non-zeros) overflows the kernel indices.", nonZeros);
+    return false;
+  }
+
+  this->nonZeros = nonZeros;
+  this->rowOffsets = malloc(sizeof(cl_uint) * (rows + 1u));
+  this->columnIndices = malloc(sizeof(cl_uint) * (nonZeros > 0u ? nonZeros : 1u));
+  this->values = malloc(sizeof(TR_MATRIX_PRECISION) * (nonZeros > 0u ? nonZeros : 1u));
+  if (this->rowOffsets == NULL || this->columnIndices == NULL || this->values == NULL) {
+    TR_ERROR("malloc(SparseMatrix) failed");
+    SparseMatrix(Release)(this);
+    return false;
+  }
+
+  // Second pass: fills the rows.
+  size_t index = 0u;
+  for (size_t row = 0u; row < rows; ++row) {
+    this->rowOffsets[row] = (cl_uint) index;
+    for (size_t column = 0u; column < columns; ++column) {
+      TR_MATRIX_PRECISION value = dense[row * rowStride + column * columnStride];
+      if (value != 0) {
+        this->columnIndices[index] = (cl_uint) column;
+        this->values[index] = value;
+        index += 1u;
+      }
+    }
+  }
+
+  this->rowOffsets[rows] = (cl_uint) index;
+  return true;
+}
+
+bool SparseMatrix(Upload)(IN OpenClContext* context, INOUT SparseMatrix()* this) {
+  assert(context != NULL && this != NULL);
+  assert(this->rowOffsetsMemory == NULL);
+
+  cl_int error;
+  cl_mem_flags flags = CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR;
+  size_t nonZeros = this->nonZeros > 0u ? this->nonZeros : 1u;
+
+  this->rowOffsetsMemory = clCreateBuffer(context->context, flags, sizeof(cl_uint) * (this->rows + 1u), this->rowOffsets, &error);
+  if (error != CL_SUCCESS) { TR_FAILED("clCreateBuffer(rowOffsets)", error); this->rowOffsetsMemory = NULL; return false; }
+  this->columnIndicesMemory = clCreateBuffer(context->context, flags, sizeof(cl_uint) * nonZeros, this->columnIndices, &error);
+  if (error != CL_SUCCESS) { TR_FAILED("clCreateBuffer(columnIndices)", error); this->columnIndicesMemory = NULL; return false; }
+  this->valuesMemory = clCreateBuffer(context->context, flags, sizeof(TR_MATRIX_PRECISION) * nonZeros, this->values, &error);
+  if (error != CL_SUCCESS) { TR_FAILED("clCreateBuffer(values)", error); this->valuesMemory = NULL; return false; }
+
+  return true;
+}
+
+bool SparseMatrix(Release)(INOUT SparseMatrix()* this) {
+  assert(this != NULL);
+
+  cl_int error;
+  bool success = true;
+
+  cl_mem memories[3] = { this->valuesMemory, this->columnIndicesMemory, this->rowOffsetsMemory };
+  for (size_t index = 0u; index < 3u; ++index) {
+    if (memories[index] != NULL && CL_SUCCESS != (error = clReleaseMemObject(memories[index]))) {
+      TR_FAILED("clReleaseMemObject(SparseMatrix)", error);
+      success = false;
+    }
+  }
+
+  if (this->values != NULL) { free(this->values); }
+  if (this->columnIndices != NULL) { free(this->columnIndices); }
+  if (this->rowOffsets != NULL) { free(this->rowOffsets); }
+
+  *this = (SparseMatrix()) { 0 };
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_SPARSEMATRIX_C
@@ -0,0 +1,88 @@
+#ifndef TR_MATRIX_SPARSEMATRIX_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/SparseMatrix.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/SparseMatrix.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_SPARSEMATRIX_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+
+#undef SparseMatrix
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define SparseMatrix(suffix) TR_JOIN2(_, SparseMatrixFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define SparseMatrix(suffix) TR_JOIN2(_, SparseMatrixDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// A sparse matrix in the Compressed Sparse Row (CSR) format, the non-zeros of
+/// the row `r` being `values[rowOffsets[r] .. rowOffsets[r + 1]]` with their
+/// columns in `columnIndices`.
+///
+/// The indices are `cl_uint` to be shared as is with the OpenCL kernels.
+///
+typedef struct SparseMatrix() {
+  size_t rows, columns;
+  size_t nonZeros;
+
+  cl_uint* rowOffsets; // rows + 1
+  cl_uint* columnIndices; // nonZeros
+  TR_MATRIX_PRECISION* values; // nonZeros
+
+  /// The device copies of the above (NULL until uploaded).
+  cl_mem rowOffsetsMemory;
+  cl_mem columnIndicesMemory;
+  cl_mem valuesMemory;
+} SparseMatrix();
+
+///
+/// Creates the CSR matrix of the non-zeros of a dense matrix, the element
+/// `(row, column)` being `dense[row * rowStride + column * columnStride]`
+/// (hence any storage order, e.g. transposed).
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `dense` is not NULL.
+/// @post `matrix` must be released with `SparseMatrix(Release)`.
+///
+bool SparseMatrix(NewFromDense)(
+  IN size_t rows, IN size_t columns,
+  IN size_t rowStride, IN size_t columnStride,
+  IN TR_MATRIX_PRECISION const* dense,
+  OUT SparseMatrix()* matrix
+);
+
+///
+/// Copies the CSR arrays into read-only device buffers.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `matrix` is initialized and not uploaded yet.
+///
+bool SparseMatrix(Upload)(IN OpenClContext* context, INOUT SparseMatrix()* matrix);
+
+///
+/// Releases the host and device memory of the matrix.
+///
+bool SparseMatrix(Release)(INOUT SparseMatrix()* matrix);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_SPARSEMATRIX_H
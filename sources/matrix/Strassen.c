@@ -0,0 +1,433 @@
+#ifndef TR_MATRIX_STRASSEN_C
+#ifndef TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <math.h> // INFINITY
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // printf(), snprintf()
+#include <string.h> // strlen()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+
+#define TRACKEVENT(TYPE) TR_JOIN2(_, TrackEvent, TYPE)
+#define ENQUEUECOMBINE(TYPE) TR_JOIN2(_, EnqueueCombine, TYPE)
+#define ENQUEUELEAF(TYPE) TR_JOIN2(_, EnqueueLeaf, TYPE)
+#define RECURSE(TYPE) TR_JOIN2(_, Recurse, TYPE)
+
+// Define matrixMatMulStart and matrixMatMulEnd.
+TR_OPENCL_IMPORT(matrix, MatMul)
+// Define matrixStrassenStart and matrixStrassenEnd.
+TR_OPENCL_IMPORT(matrix, Strassen)
+
+///
+/// A view `(offset, leading dimension)` into a row-major buffer, in elements.
+///
+typedef struct View {
+  cl_mem buffer;
+  size_t offset, ld;
+} View;
+
+///
+/// Returns the quadrant `(row, column)` of `op(X)`, of `(rows, columns)` elements,
+/// i.e. the quadrant `(column, row)` of the stored X if transposed.
+///
+static View Quadrant(IN View view, IN size_t row, IN size_t column, IN size_t rows, IN size_t columns, IN bool transposed) {
+  size_t offset = transposed
+    ? (column * columns) * view.ld + row * rows
+    : (row * rows) * view.ld + column * columns;
+
+  return (View) { view.buffer, view.offset + offset, view.ld };
+}
+
+#define TR_MATRIX_PRECISION float
+#include "matrix/Strassen.c"
+#undef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION double
+#  include "matrix/Strassen.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_STRASSEN_C
+#else // TR_MATRIX_PRECISION
+
+#include "matrix/Compare.h" // Compare(), CompareStatistics{}
+#include "matrix/Strassen.h" // Strassen(), StrassenPlan{}
+
+///
+/// Keeps the first and the last events of the run (for the profiling).
+///
+static void TRACKEVENT(TR_MATRIX_PRECISION)(INOUT StrassenPlan* plan, IN cl_event event) {
+  if (plan->first == NULL) { plan->first = event; return; }
+  if (plan->last != NULL) { clReleaseEvent(plan->last); }
+  plan->last = event;
+}
+
+///
+/// Enqueues `Z = X + sign * Y` on `(rows, columns)` views.
+///
+static bool ENQUEUECOMBINE(TR_MATRIX_PRECISION)(
+  INOUT StrassenPlan* plan, IN size_t rows, IN size_t columns,
+  IN View X, IN View Y, IN View Z, IN TR_MATRIX_PRECISION sign)
+{
+  cl_kernel kernel = plan->combine;
+  cl_uint sizes[2] = { (cl_uint) rows, (cl_uint) columns };
+  cl_ulong offsets[3] = { X.offset, Y.offset, Z.offset };
+  cl_uint lds[3] = { (cl_uint) X.ld, (cl_uint) Y.ld, (cl_uint) Z.ld };
+
+  cl_int error = CL_SUCCESS;
+  error |= clSetKernelArg(kernel, 0, sizeof(cl_uint), &sizes[0]);
+  error |= clSetKernelArg(kernel, 1, sizeof(cl_uint), &sizes[1]);
+  for (cl_uint index = 0u; index < 3u; ++index) {
+    error |= clSetKernelArg(kernel, 2u + 2u * index, sizeof(cl_ulong), &offsets[index]);
+    error |= clSetKernelArg(kernel, 3u + 2u * index, sizeof(cl_uint), &lds[index]);
+  }
+
+  error |= clSetKernelArg(kernel, 8, sizeof(TR_MATRIX_PRECISION), &sign);
+  error |= clSetKernelArg(kernel, 9, sizeof(cl_mem), &X.buffer);
+  error |= clSetKernelArg(kernel, 10, sizeof(cl_mem), &Y.buffer);
+  error |= clSetKernelArg(kernel, 11, sizeof(cl_mem), &Z.buffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Combine)", error);
+    return false;
+  }
+
+  cl_event event = NULL;
+  size_t globalSize[2] = { columns, rows };
+  error = clEnqueueNDRangeKernel(plan->context->openCl.queue, kernel, 2, NULL, globalSize, NULL, 0, NULL, &event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(Combine)", error);
+    return false;
+  }
+
+  TRACKEVENT(TR_MATRIX_PRECISION)(plan, event);
+  return true;
+}
+
+///
+/// Enqueues the blocked MatMul kernel on views, `C = op(A) * op(B)` of (M, N, P).
+///
+static bool ENQUEUELEAF(TR_MATRIX_PRECISION)(
+  INOUT StrassenPlan* plan, IN View A, IN View B, IN View C,
+  IN size_t M, IN size_t N, IN size_t P)
+{
+  cl_kernel kernel = plan->matMul;
+  cl_uint sizes[3] = { (cl_uint) M, (cl_uint) N, (cl_uint) P };
+  cl_ulong offsets[3] = { A.offset, B.offset, C.offset };
+  cl_uint lds[3] = { (cl_uint) A.ld, (cl_uint) B.ld, (cl_uint) C.ld };
+
+  cl_int error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < 3u; ++index) {
+    error |= clSetKernelArg(kernel, index, sizeof(cl_uint), &sizes[index]);
+    error |= clSetKernelArg(kernel, 3u + 2u * index, sizeof(cl_ulong), &offsets[index]);
+    error |= clSetKernelArg(kernel, 4u + 2u * index, sizeof(cl_uint), &lds[index]);
+  }
+
+  error |= clSetKernelArg(kernel, 9, sizeof(cl_mem), &A.buffer);
+  error |= clSetKernelArg(kernel, 10, sizeof(cl_mem), &B.buffer);
+  error |= clSetKernelArg(kernel, 11, sizeof(cl_mem), &C.buffer);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(MatMul)", error);
+    return false;
+  }
+
+  cl_event event = NULL;
+  size_t blockSize = plan->context->blockSize;
+  size_t globalSize[2] = { P, M }; // (x, y) or (columns, rows)
+  size_t localSize[2] = { blockSize, blockSize };
+  error = clEnqueueNDRangeKernel(plan->context->openCl.queue, kernel, 2, NULL, globalSize, localSize, 0, NULL, &event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(MatMul)", error);
+    return false;
+  }
+
+  TRACKEVENT(TR_MATRIX_PRECISION)(plan, event);
+  return true;
+}
+
+///
+/// One level of the Strassen-Winograd recursion on `C = op(A) * op(B)` of (M, N, P),
+/// (7 products and 15 combinations, the products being accumulated into the
+/// quadrants of C to only need 2 temporaries):
+///
+/// ```txt
+/// S1 = A21 + A22   T1 = B12 - B11   X   = A11 B11         C12 = C21 + X (U4)
+/// S2 = S1  - A11   T2 = B22 - T1    C11 = A12 B21 + X     Y   = S3 T3
+/// S3 = A11 - A21   T3 = B22 - B12   C21 = S2 T2 + X (U2)  C21 = C21 + Y (U3)
+/// S4 = A12 - S2    T4 = T2  - B21   X   = S1 T1           C22 = C21 + X
+///                                   X   = S4 B22          C12 = C12 + X
+///                                   X   = A22 T4          C21 = C21 - X
+/// ```
+///
+static bool RECURSE(TR_MATRIX_PRECISION)(
+  INOUT StrassenPlan* plan, IN View A, IN View B, IN View C,
+  IN size_t M, IN size_t N, IN size_t P, IN size_t level, IN size_t depth)
+{
+  if (level == depth) {
+    return ENQUEUELEAF(TR_MATRIX_PRECISION)(plan, A, B, C, M, N, P);
+  }
+
+  MatMulContext const* context = plan->context;
+  bool transA = context->transA, transB = context->transB;
+  size_t m = M / 2u, n = N / 2u, p = P / 2u;
+
+  // The temporaries of a level are shared by all its calls (one after another).
+  if (plan->pool[level] == NULL) {
+    cl_int error;
+    size_t bytes = sizeof(TR_MATRIX_PRECISION) * (4u * m * n + 4u * n * p + 2u * m * p);
+    plan->pool[level] = clCreateBuffer(context->openCl.context, CL_MEM_READ_WRITE, bytes, NULL, &error);
+    if (error != CL_SUCCESS || plan->pool[level] == NULL) {
+      TR_FAILED("clCreateBuffer(Strassen)", error);
+      plan->pool[level] = NULL;
+      return false;
+    }
+  }
+
+  cl_mem pool = plan->pool[level];
+  View S[4], T[4];
+  for (size_t index = 0u; index < 4u; ++index) {
+    S[index] = (View) { pool, index * m * n, transA ? m : n };
+    T[index] = (View) { pool, 4u * m * n + index * n * p, transB ? n : p };
+  }
+
+  View X = { pool, 4u * m * n + 4u * n * p, p };
+  View Y = { pool, X.offset + m * p, p };
+
+  View A11 = Quadrant(A, 0u, 0u, m, n, transA), A12 = Quadrant(A, 0u, 1u, m, n, transA);
+  View A21 = Quadrant(A, 1u, 0u, m, n, transA), A22 = Quadrant(A, 1u, 1u, m, n, transA);
+  View B11 = Quadrant(B, 0u, 0u, n, p, transB), B12 = Quadrant(B, 0u, 1u, n, p, transB);
+  View B21 = Quadrant(B, 1u, 0u, n, p, transB), B22 = Quadrant(B, 1u, 1u, n, p, transB);
+  View C11 = Quadrant(C, 0u, 0u, m, p, false), C12 = Quadrant(C, 0u, 1u, m, p, false);
+  View C21 = Quadrant(C, 1u, 0u, m, p, false), C22 = Quadrant(C, 1u, 1u, m, p, false);
+
+  // Sums are computed on the stored (possibly transposed) quadrants.
+  size_t ARows = transA ? n : m, AColumns = transA ? m : n;
+  size_t BRows = transB ? p : n, BColumns = transB ? n : p;
+
+  #define TR_COMBINE(ROWS, COLUMNS, Z, X, SIGN, Y) \
+    ENQUEUECOMBINE(TR_MATRIX_PRECISION)(plan, ROWS, COLUMNS, X, Y, Z, (TR_MATRIX_PRECISION) (SIGN))
+  #define TR_PRODUCT(Z, X, Y) \
+    RECURSE(TR_MATRIX_PRECISION)(plan, X, Y, Z, m, n, p, level + 1u, depth)
+
+  bool success =
+       TR_COMBINE(ARows, AColumns, S[0], A21, +1, A22)
+    && TR_COMBINE(ARows, AColumns, S[1], S[0], -1, A11)
+    && TR_COMBINE(ARows, AColumns, S[2], A11, -1, A21)
+    && TR_COMBINE(ARows, AColumns, S[3], A12, -1, S[1])
+    && TR_COMBINE(BRows, BColumns, T[0], B12, -1, B11)
+    && TR_COMBINE(BRows, BColumns, T[1], B22, -1, T[0])
+    && TR_COMBINE(BRows, BColumns, T[2], B22, -1, B12)
+    && TR_COMBINE(BRows, BColumns, T[3], T[1], -1, B21)
+
+    && TR_PRODUCT(X, A11, B11)               // P1
+    && TR_PRODUCT(C11, A12, B21)             // P2
+    && TR_COMBINE(m, p, C11, C11, +1, X)     // U1 = P1 + P2
+    && TR_PRODUCT(C21, S[1], T[1])           // P6
+    && TR_COMBINE(m, p, C21, C21, +1, X)     // U2 = P1 + P6
+    && TR_PRODUCT(X, S[0], T[0])             // P5
+    && TR_COMBINE(m, p, C12, C21, +1, X)     // U4 = U2 + P5
+    && TR_PRODUCT(Y, S[2], T[2])             // P7
+    && TR_COMBINE(m, p, C21, C21, +1, Y)     // U3 = U2 + P7
+    && TR_COMBINE(m, p, C22, C21, +1, X)     // U7 = U3 + P5
+    && TR_PRODUCT(X, S[3], B22)              // P3
+    && TR_COMBINE(m, p, C12, C12, +1, X)     // U5 = U4 + P3
+    && TR_PRODUCT(X, A22, T[3])              // P4
+    && TR_COMBINE(m, p, C21, C21, -1, X);    // U6 = U3 - P4
+
+  #undef TR_COMBINE
+  #undef TR_PRODUCT
+
+  return success;
+}
+
+bool Strassen(NewPlan)(IN MatMulContext* this, OUT StrassenPlan* plan) {
+  assert(this != NULL && plan != NULL);
+
+  *plan = (StrassenPlan) { .context = this };
+
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options),
+    "-DMATMUL_BLOCKSIZE=%zu -DMATMUL_REAL=%s%s%s%s -DMATMUL_VIEWS"
+    , this->blockSize
+    , TR_STRINGIFY(TR_MATRIX_PRECISION)
+    , this->transA ? " -DTRANS_A" : ""
+    , this->transB ? " -DTRANS_B" : ""
+    , MatMulContext_LocalTileOptions(this)
+  );
+
+  char const* combineOptions = "-DSTRASSEN_REAL=" TR_STRINGIFY(TR_MATRIX_PRECISION);
+
+  plan->matMul = ProgramCache_GetKernel(&this->openCl, matrixMatMulStart, matrixMatMulEnd, options, "MatMul");
+  plan->combine = ProgramCache_GetKernel(&this->openCl, matrixStrassenStart, matrixStrassenEnd, combineOptions, "Combine");
+  if (plan->matMul == NULL || plan->combine == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(MatMul, Combine) failed");
+    Strassen(ReleasePlan)(plan);
+    return false;
+  }
+
+  return true;
+}
+
+bool Strassen(Run)(
+  INOUT StrassenPlan* plan,
+  IN cl_mem A, IN cl_mem B, OUT cl_mem C,
+  IN size_t depth, OUT double* milliseconds)
+{
+  assert(plan != NULL && plan->context != NULL && milliseconds != NULL);
+  assert(A != NULL && B != NULL && C != NULL);
+  assert(depth <= TR_MATMUL_STRASSEN_MAX_DEPTH);
+
+  MatMulContext const* this = plan->context;
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  View AView = { A, 0u, this->transA ? M : N };
+  View BView = { B, 0u, this->transB ? N : P };
+  View CView = { C, 0u, P };
+
+  *milliseconds = 0.0;
+  if (plan->first != NULL) { clReleaseEvent(plan->first); plan->first = NULL; }
+  if (plan->last != NULL) { clReleaseEvent(plan->last); plan->last = NULL; }
+
+  bool success = RECURSE(TR_MATRIX_PRECISION)(plan, AView, BView, CView, M, N, P, 0u, depth);
+
+  // A single command is both the first and the last one.
+  cl_event last = plan->last != NULL ? plan->last : plan->first;
+  if (last == NULL) { return false; }
+
+  cl_int error = clWaitForEvents(1, &last);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clWaitForEvents(Strassen)", error);
+    return false;
+  }
+
+  cl_ulong start = 0u, end = 0u;
+  error  = clGetEventProfilingInfo(plan->first, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(last, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo(Strassen)", error);
+  }
+
+  *milliseconds = (double) (end - start) * 1e-6;
+  return success;
+}
+
+bool Strassen(ReleasePlan)(INOUT StrassenPlan* plan) {
+  assert(plan != NULL);
+
+  cl_int error;
+  bool success = true;
+
+  // Pending commands use the temporaries.
+  if (plan->context != NULL) { clFinish(plan->context->openCl.queue); }
+
+  if (plan->first != NULL) { clReleaseEvent(plan->first); }
+  if (plan->last != NULL) { clReleaseEvent(plan->last); }
+
+  for (size_t level = 0u; level < TR_MATMUL_STRASSEN_MAX_DEPTH; ++level) {
+    if (plan->pool[level] != NULL && CL_SUCCESS != (error = clReleaseMemObject(plan->pool[level]))) {
+      TR_FAILED("clReleaseMemObject(Strassen)", error);
+      success = false;
+    }
+  }
+
+  if (plan->combine != NULL) { clReleaseKernel(plan->combine); }
+  if (plan->matMul != NULL) { clReleaseKernel(plan->matMul); }
+
+  *plan = (StrassenPlan) { 0 };
+  return success;
+}
+
+bool Strassen(Benchmark)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  IN double classicMilliseconds)
+{
+  assert(this != NULL);
+  assert(A != NULL && B != NULL && C != NULL);
+
+  cl_int error;
+  bool success = false;
+  StrassenPlan plan;
+  cl_mem SBuffer = NULL, R = NULL, bound = NULL;
+
+  size_t M = this->M + this->paddingM;
+  size_t P = this->P + this->paddingP;
+
+  if (!Strassen(NewPlan)(this, &plan)) {
+    return false;
+  }
+
+  SBuffer = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * M * P, NULL, &error);
+  if (error != CL_SUCCESS || SBuffer == NULL) {
+    TR_FAILED("clCreateBuffer(Strassen)", error);
+    goto out;
+  }
+
+  // The crossover: the deepest level is only worth it while it is faster.
+  size_t depth = this->strassenDepth;
+  double milliseconds = 0.0;
+  if (depth == 0u) {
+    double fastest = classicMilliseconds;
+    char timings[256] = { 0x0 };
+    snprintf(timings, sizeof(timings), "classic %.3f ms", classicMilliseconds);
+
+    for (size_t level = 1u; level <= this->strassenMaxDepth; ++level) {
+      TR_MATMUL_LOG(this, 1, "Time Strassen-Winograd with depth %zu.", level);
+      if (!Strassen(Run)(&plan, A, B, SBuffer, level, &milliseconds)) {
+        goto out;
+      }
+
+      size_t length = strlen(timings);
+      snprintf(timings + length, sizeof(timings) - length, ", depth %zu %.3f ms", level, milliseconds);
+      if (milliseconds < fastest) { fastest = milliseconds; depth = level; }
+    }
+
+    printf(TAB1 "Strassen.Timings.......: %s" LF, timings);
+  }
+
+  TR_MATMUL_LOG(this, 1, "Run Strassen-Winograd with depth %zu.", depth);
+  if (!Strassen(Run)(&plan, A, B, SBuffer, depth, &milliseconds)) {
+    goto out;
+  }
+
+  TR_MATMUL_LOG(this, 1, "Compare Classic and Strassen-Winograd against a Device Reference.");
+  CompareStatistics classic, strassen;
+  if (!Compare(NewReference)(this, A, B, &R, &bound)
+    || !Compare(Buffers)(this, C, R, bound, &classic)
+    || !Compare(Buffers)(this, SBuffer, R, bound, &strassen)) {
+    goto out;
+  }
+
+  double growth = classic.maxAbsoluteError > 0.0
+    ? strassen.maxAbsoluteError / classic.maxAbsoluteError
+    : strassen.maxAbsoluteError > 0.0 ? INFINITY : 1.0;
+
+  printf(
+    TAB1 "Strassen.Depth.........: %zu (%s)" LF
+    TAB1 "Strassen.Time..........: %.3f ms (x%.2f against the classic kernel)" LF
+    TAB1 "Classic.Max.Error......: %g absolute, %g relative (%zu out of tolerance)" LF
+    TAB1 "Strassen.Max.Error.....: %g absolute, %g relative (%zu out of tolerance)" LF
+    TAB1 "Error.Growth...........: x%.2f" LF
+    , depth, this->strassenDepth == 0u ? "fastest measured" : "given"
+    , milliseconds, milliseconds > 0.0 ? classicMilliseconds / milliseconds : 0.0
+    , classic.maxAbsoluteError, classic.maxRelativeError, classic.failures + classic.nonFinite
+    , strassen.maxAbsoluteError, strassen.maxRelativeError, strassen.failures + strassen.nonFinite
+    , growth
+  );
+
+  success = true;
+
+out:
+  if (bound != NULL && CL_SUCCESS != (error = clReleaseMemObject(bound))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (R != NULL && CL_SUCCESS != (error = clReleaseMemObject(R))) { TR_FAILED("clReleaseMemObject(R)", error); }
+  if (!Strassen(ReleasePlan)(&plan)) { TR_ERROR("Strassen(ReleasePlan) failed"); }
+  if (SBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(SBuffer))) { TR_FAILED("clReleaseMemObject(Strassen)", error); }
+
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_STRASSEN_C
@@ -0,0 +1,43 @@
+#ifndef STRASSEN_REAL
+#define STRASSEN_REAL float
+#endif
+
+#if defined(cl_khr_fp64)
+#pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#elif defined(cl_amd_fp64)
+#pragma OPENCL EXTENSION cl_amd_fp64 : enable
+#endif
+
+#define IN
+#define OUT
+
+typedef STRASSEN_REAL Real;
+
+///
+/// Computes `Z = X + sign * Y` on `(rows, columns)` views `(offset, leading
+/// dimension)`, the quadrant combinations of the Strassen-Winograd recursion.
+///
+/// `Z` may be `X` (same view), for in-place accumulations.
+///
+/// @pre get_global_size(0, 1) is (columns, rows).
+///
+__kernel void Combine(
+  IN unsigned int const rows,
+  IN unsigned int const columns,
+  IN unsigned long const offsetX, IN unsigned int const ldX,
+  IN unsigned long const offsetY, IN unsigned int const ldY,
+  IN unsigned long const offsetZ, IN unsigned int const ldZ,
+  IN Real const sign,
+
+  IN  __global Real const* X,
+  IN  __global Real const* Y,
+  OUT __global Real      * Z)
+{
+  size_t column = get_global_id(0);
+  size_t row = get_global_id(1);
+  if (row >= rows || column >= columns) return;
+
+  Real x = X[offsetX + row * ldX + column];
+  Real y = Y[offsetY + row * ldY + column];
+  Z[offsetZ + row * ldZ + column] = x + sign * y;
+}
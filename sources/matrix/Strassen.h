@@ -0,0 +1,108 @@
+#ifndef TR_MATRIX_STRASSEN_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/Strassen.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/Strassen.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_STRASSEN_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+#include "matrix/MatMulContext.h" // MatMulContext{}, TR_MATMUL_STRASSEN_MAX_DEPTH
+
+#ifndef TR_MATRIX_STRASSEN_PLAN
+#define TR_MATRIX_STRASSEN_PLAN
+
+///
+/// Kernels and pooled temporaries of the Strassen-Winograd recursion, reused
+/// from one run to another (e.g. while timing the depths).
+///
+typedef struct StrassenPlan {
+  MatMulContext* context;
+
+  /// The blocked MatMul kernel over views (leaves) and the Combine kernel.
+  cl_kernel matMul, combine;
+
+  /// One buffer per level holding its temporaries, i.e. 4 (M, N) quadrants
+  /// for the sums of A, 4 (N, P) for the sums of B and 2 (M, P) for the
+  /// products, halved at each level. Allocated on first use.
+  cl_mem pool[TR_MATMUL_STRASSEN_MAX_DEPTH];
+
+  /// First and last commands of the current run (for the profiling).
+  cl_event first, last;
+} StrassenPlan;
+
+#endif // TR_MATRIX_STRASSEN_PLAN
+
+#undef Strassen
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Strassen(suffix) TR_JOIN2(_, StrassenFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Strassen(suffix) TR_JOIN2(_, StrassenDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// Gets the kernels of the recursion, the temporaries being allocated lazily.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `context` is not NULL, initialized and outlives the plan.
+/// @post `plan` must be released with `Strassen(ReleasePlan)`.
+///
+bool Strassen(NewPlan)(IN MatMulContext* context, OUT StrassenPlan* plan);
+
+///
+/// Computes `C = op(A) * op(B)` with `depth` levels of Strassen-Winograd
+/// recursion over quadrant views of the device buffers, the blocked MatMul
+/// kernel computing the leaves (7^depth products of 1/2^depth sizes).
+///
+/// @param milliseconds Device time from the first to the last command.
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre The padded sizes are multiples of `blockSize << depth`.
+///
+bool Strassen(Run)(
+  INOUT StrassenPlan* plan,
+  IN cl_mem A, IN cl_mem B, OUT cl_mem C,
+  IN size_t depth, OUT double* milliseconds
+);
+
+///
+/// Releases the kernels and the temporaries of the plan.
+///
+bool Strassen(ReleasePlan)(INOUT StrassenPlan* plan);
+
+///
+/// Runs the Strassen-Winograd recursion next to the classic kernel (whose
+/// result is `C`, computed in `classicMilliseconds`), picking the depth from
+/// timings unless given, then displays the timings and the error growth of
+/// both results against a naive reference (see `matrix/Compare.h`).
+///
+/// @returns `true` if the recursion could be run, `false` otherwise.
+///
+/// @post Displays on stdout, may display error on stderr.
+///
+bool Strassen(Benchmark)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  IN double classicMilliseconds
+);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_STRASSEN_H
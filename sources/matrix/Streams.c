@@ -0,0 +1,432 @@
+#ifndef TR_MATRIX_STREAMS_C
+#ifndef TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <stdatomic.h> // atomic_load()
+#include <stdbool.h> // bool, true, false
+#include <stdio.h> // printf(), snprintf()
+#include <stdlib.h> // calloc(), free()
+#include <string.h> // strlen()
+#include <threads.h> // thrd_create(), thrd_join()
+
+#include "common/OpenCl.h" // TR_OPENCL_IMPORT()
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/Submitter.h" // Submitter{}, SubmitJob{}
+#include "common/timer.h" // TimerNow()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "matrix/MatMulContext.h" // MatMulContext{}, TR_MATMUL_LOG()
+
+/// Slices of rows per stream, so that the least loaded queue can even out.
+#define TR_STREAMS_SLICES 4u
+#define TR_STREAMS_MAX_SLICES (TR_OPENCL_MAX_STREAMS * TR_STREAMS_SLICES)
+
+// Define matrixMatMulStart and matrixMatMulEnd.
+TR_OPENCL_IMPORT(matrix, MatMul)
+
+///
+/// The arguments of the blocked MatMul kernel (with views) on the rows
+/// `[row, row + rows)` of `C = op(A) * op(B)`, i.e. on the same rows of op(A).
+///
+typedef struct SliceArguments {
+  cl_uint sizes[3];
+  cl_ulong offsets[3];
+  cl_uint lds[3];
+  size_t globalSize[2], localSize[2];
+} SliceArguments;
+
+static SliceArguments GetSliceArguments(IN MatMulContext const* this, IN size_t row, IN size_t rows) {
+  size_t M = this->M + this->paddingM;
+  size_t N = this->N + this->paddingN;
+  size_t P = this->P + this->paddingP;
+
+  // The rows of op(A) are its columns when stored transposed.
+  return (SliceArguments) {
+    .sizes = { (cl_uint) rows, (cl_uint) N, (cl_uint) P },
+    .offsets = { this->transA ? row : row * N, 0u, row * P },
+    .lds = { (cl_uint) (this->transA ? M : N), (cl_uint) (this->transB ? N : P), (cl_uint) P },
+    .globalSize = { P, rows }, // (x, y) or (columns, rows)
+    .localSize = { this->blockSize, this->blockSize },
+  };
+}
+
+///
+/// Enqueues the blocked MatMul kernel (with views) on the rows `[row, row + rows)`.
+///
+static bool EnqueueSlice(
+  IN MatMulContext const* this, IN cl_command_queue queue, IN cl_kernel kernel,
+  IN cl_mem A, IN cl_mem B, IN cl_mem C,
+  IN size_t row, IN size_t rows, OUT cl_event* event)
+{
+  SliceArguments arguments = GetSliceArguments(this, row, rows);
+
+  cl_int error = CL_SUCCESS;
+  for (cl_uint index = 0u; index < 3u; ++index) {
+    error |= clSetKernelArg(kernel, index, sizeof(cl_uint), &arguments.sizes[index]);
+    error |= clSetKernelArg(kernel, 3u + 2u * index, sizeof(cl_ulong), &arguments.offsets[index]);
+    error |= clSetKernelArg(kernel, 4u + 2u * index, sizeof(cl_uint), &arguments.lds[index]);
+  }
+
+  error |= clSetKernelArg(kernel, 9, sizeof(cl_mem), &A);
+  error |= clSetKernelArg(kernel, 10, sizeof(cl_mem), &B);
+  error |= clSetKernelArg(kernel, 11, sizeof(cl_mem), &C);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(MatMul)", error);
+    return false;
+  }
+
+  // The arguments are captured by the enqueue, the kernel can be set again.
+  error = clEnqueueNDRangeKernel(queue, kernel, 2, NULL, arguments.globalSize, arguments.localSize, 0, NULL, event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(MatMul)", error);
+    return false;
+  }
+
+  return true;
+}
+
+///
+/// A thread submitting the slices `first`, `first + step`, ... (of `rows`
+/// rows each) through the submitter, then waiting for them.
+///
+typedef struct SliceProducer {
+  MatMulContext const* context;
+  Submitter* submitter;
+  cl_kernel kernel;
+  cl_mem A, B, C;
+  size_t first, step, count, rows;
+  SubmitJob* jobs;
+
+  /// The first error of its jobs, and the largest batch one was part of.
+  cl_int status;
+  size_t largestBatch;
+} SliceProducer;
+
+static int ProduceSlices(IN void* data) {
+  SliceProducer* this = (SliceProducer*) data;
+
+  size_t submitted = 0u;
+  for (; submitted < this->count; ++submitted) {
+    size_t row = (this->first + submitted * this->step) * this->rows;
+    SliceArguments arguments = GetSliceArguments(this->context, row, this->rows);
+
+    SubmitJob* job = &this->jobs[submitted];
+    if (!SubmitJob_Init(job, this->kernel, 2u, arguments.globalSize, arguments.localSize)) {
+      this->status = CL_OUT_OF_HOST_MEMORY;
+      break;
+    }
+
+    // A missing argument fails the enqueue, thus completes the job anyway.
+    for (cl_uint index = 0u; index < 3u; ++index) {
+      SubmitJob_SetArgument(job, index, sizeof(cl_uint), &arguments.sizes[index]);
+      SubmitJob_SetArgument(job, 3u + 2u * index, sizeof(cl_ulong), &arguments.offsets[index]);
+      SubmitJob_SetArgument(job, 4u + 2u * index, sizeof(cl_uint), &arguments.lds[index]);
+    }
+
+    SubmitJob_SetArgument(job, 9, sizeof(cl_mem), &this->A);
+    SubmitJob_SetArgument(job, 10, sizeof(cl_mem), &this->B);
+    SubmitJob_SetArgument(job, 11, sizeof(cl_mem), &this->C);
+    Submitter_Submit(this->submitter, job);
+  }
+
+  for (size_t index = 0u; index < submitted; ++index) {
+    cl_int status = SubmitJob_Wait(&this->jobs[index]);
+    if (status != CL_COMPLETE && this->status == CL_SUCCESS) {
+      this->status = status;
+    }
+
+    size_t batch = this->jobs[index].batchSize;
+    this->largestBatch = batch > this->largestBatch ? batch : this->largestBatch;
+  }
+
+  return 0;
+}
+
+#define TR_MATRIX_PRECISION float
+#include "matrix/Streams.c"
+#undef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION double
+#  include "matrix/Streams.c"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_STREAMS_C
+#else // TR_MATRIX_PRECISION
+
+#include "matrix/Compare.h" // Compare(), CompareStatistics{}
+#include "matrix/Streams.h" // Streams()
+
+///
+/// Returns the blocked MatMul kernel with views (retained).
+///
+static cl_kernel Streams(Kernel)(IN MatMulContext* this) {
+  char options[TR_PROGRAMCACHE_OPTIONS_SIZE] = { 0x0 };
+  snprintf(options, sizeof(options),
+    "-DMATMUL_BLOCKSIZE=%zu -DMATMUL_REAL=%s%s%s%s -DMATMUL_VIEWS"
+    , this->blockSize
+    , TR_STRINGIFY(TR_MATRIX_PRECISION)
+    , this->transA ? " -DTRANS_A" : ""
+    , this->transB ? " -DTRANS_B" : ""
+    , MatMulContext_LocalTileOptions(this)
+  );
+
+  cl_kernel kernel = ProgramCache_GetKernel(&this->openCl, matrixMatMulStart, matrixMatMulEnd, options, "MatMul");
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(MatMul) failed");
+  }
+
+  return kernel;
+}
+
+bool Streams(Benchmark)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B,
+  IN double classicMilliseconds)
+{
+  assert(this != NULL && this->openCl.streamCount >= 1u);
+  assert(A != NULL && B != NULL);
+
+  cl_int error;
+  bool success = false;
+  cl_kernel kernel = NULL;
+  cl_mem SBuffer = NULL, R = NULL, bound = NULL;
+  cl_event events[TR_STREAMS_MAX_SLICES] = { NULL };
+  size_t slices = 0u;
+
+  size_t M = this->M + this->paddingM;
+  size_t P = this->P + this->paddingP;
+  size_t streams = this->openCl.streamCount;
+
+  if (NULL == (kernel = Streams(Kernel)(this))) {
+    goto out;
+  }
+
+  SBuffer = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * M * P, NULL, &error);
+  if (error != CL_SUCCESS || SBuffer == NULL) {
+    TR_FAILED("clCreateBuffer(Streams)", error);
+    goto out;
+  }
+
+  // Whole blocks of rows, a few per stream.
+  size_t blocks = M / this->blockSize;
+  size_t wanted = streams * TR_STREAMS_SLICES;
+  size_t sliceRows = ((blocks + wanted - 1u) / wanted) * this->blockSize;
+
+  // Least-loaded: the slice goes to the queue with the fewest enqueued rows
+  // (the slices being alike, this is round-robin but for the last one).
+  size_t load[TR_OPENCL_MAX_STREAMS] = { 0u };
+  size_t owners[TR_STREAMS_MAX_SLICES] = { 0u };
+
+  TR_MATMUL_LOG(this, 1, "Run Slices on %zu Streams.", streams);
+  for (size_t row = 0u; row < M && slices < TR_STREAMS_MAX_SLICES; row += sliceRows, ++slices) {
+    size_t rows = row + sliceRows <= M ? sliceRows : M - row;
+
+    size_t owner = 0u;
+    for (size_t stream = 1u; stream < streams; ++stream) {
+      if (load[stream] < load[owner]) { owner = stream; }
+    }
+
+    if (!EnqueueSlice(this, this->openCl.streams[owner], kernel, A, B, SBuffer, row, rows, &events[slices])) {
+      goto out;
+    }
+
+    load[owner] += rows;
+    owners[slices] = owner;
+  }
+
+  // Submits every queue before waiting any of them.
+  for (size_t stream = 0u; stream < streams; ++stream) {
+    if (CL_SUCCESS != (error = clFlush(this->openCl.streams[stream]))) {
+      TR_FAILED("clFlush(stream)", error);
+      goto out;
+    }
+  }
+
+  if (CL_SUCCESS != (error = clWaitForEvents((cl_uint) slices, events))) {
+    TR_FAILED("clWaitForEvents(Streams)", error);
+    goto out;
+  }
+
+  // The device timestamps are shared by the queues of a device.
+  cl_ulong first = 0u, last = 0u;
+  cl_ulong busy[TR_OPENCL_MAX_STREAMS] = { 0u };
+  for (size_t slice = 0u; slice < slices; ++slice) {
+    cl_ulong start = 0u, end = 0u;
+    error  = clGetEventProfilingInfo(events[slice], CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+    error |= clGetEventProfilingInfo(events[slice], CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+    if (error != CL_SUCCESS) {
+      TR_FAILED("clGetEventProfilingInfo(Streams)", error);
+      goto out;
+    }
+
+    first = slice == 0u || start < first ? start : first;
+    last = end > last ? end : last;
+    busy[owners[slice]] += end - start;
+  }
+
+  double milliseconds = (double) (last - first) * 1e-6;
+  char utilization[8u * TR_OPENCL_MAX_STREAMS] = { 0x0 };
+  for (size_t stream = 0u; stream < streams; ++stream) {
+    size_t length = strlen(utilization);
+    snprintf(utilization + length, sizeof(utilization) - length, "%s%.1f%%"
+      , stream > 0u ? " " : "", last > first ? 100.0 * (double) busy[stream] / (double) (last - first) : 0.0);
+  }
+
+  printf(
+    TAB1 "Streams.Time...........: %.3f ms (x%.2f against one queue, %zu slices of %zu rows)" LF
+    TAB1 "Streams.Utilization....: %s" LF
+    , milliseconds, milliseconds > 0.0 ? classicMilliseconds / milliseconds : 0.0, slices, sliceRows
+    , utilization
+  );
+
+  if (this->cpuCheck) {
+    TR_MATMUL_LOG(this, 1, "Compare the Slices against a Device Reference.");
+    CompareStatistics statistics;
+    if (!Compare(NewReference)(this, A, B, &R, &bound)
+      || !Compare(Buffers)(this, SBuffer, R, bound, &statistics)) {
+      goto out;
+    }
+
+    printf(TAB1 "Streams.Check..........: %s (max. error %g absolute, %g relative)" LF
+      , statistics.failures == 0u && statistics.nonFinite == 0u ? "Passed" : "Failed"
+      , statistics.maxAbsoluteError, statistics.maxRelativeError);
+  }
+
+  success = true;
+
+out:
+  for (size_t slice = 0u; slice < slices; ++slice) {
+    if (events[slice] != NULL) { clReleaseEvent(events[slice]); }
+  }
+
+  if (bound != NULL && CL_SUCCESS != (error = clReleaseMemObject(bound))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (R != NULL && CL_SUCCESS != (error = clReleaseMemObject(R))) { TR_FAILED("clReleaseMemObject(R)", error); }
+  if (SBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(SBuffer))) { TR_FAILED("clReleaseMemObject(Streams)", error); }
+  if (kernel != NULL) { clReleaseKernel(kernel); }
+
+  return success;
+}
+
+bool Streams(Submit)(
+  IN MatMulContext* this,
+  IN cl_mem A, IN cl_mem B,
+  IN double classicMilliseconds)
+{
+  assert(this != NULL && this->producers >= 1u);
+  assert(A != NULL && B != NULL);
+
+  cl_int error;
+  bool success = false;
+  bool started = false;
+  cl_kernel kernel = NULL;
+  cl_mem SBuffer = NULL, R = NULL, bound = NULL;
+  Submitter submitter;
+  SliceProducer* producers = NULL;
+  thrd_t* threads = NULL;
+  SubmitJob* jobs = NULL;
+  size_t running = 0u;
+
+  size_t M = this->M + this->paddingM;
+  size_t P = this->P + this->paddingP;
+  size_t count = this->producers;
+
+  // One block of rows per job: small and same-shaped, thus coalesced.
+  size_t slices = M / this->blockSize;
+  size_t perProducer = (slices + count - 1u) / count;
+
+  if (NULL == (kernel = Streams(Kernel)(this))) {
+    goto out;
+  }
+
+  SBuffer = clCreateBuffer(this->openCl.context, CL_MEM_READ_WRITE, sizeof(TR_MATRIX_PRECISION) * M * P, NULL, &error);
+  if (error != CL_SUCCESS || SBuffer == NULL) {
+    TR_FAILED("clCreateBuffer(Submitter)", error);
+    goto out;
+  }
+
+  producers = (SliceProducer*) calloc(count, sizeof(SliceProducer));
+  threads = (thrd_t*) calloc(count, sizeof(thrd_t));
+  jobs = (SubmitJob*) calloc(count * perProducer, sizeof(SubmitJob));
+  if (producers == NULL || threads == NULL || jobs == NULL) {
+    TR_ERROR("calloc(Submitter) failed");
+    goto out;
+  }
+
+  if (!(started = Submitter_Start(&this->openCl, &submitter))) {
+    goto out;
+  }
+
+  TR_MATMUL_LOG(this, 1, "Submit %zu Slices from %zu Threads.", slices, count);
+  double startTime = TimerNow();
+
+  for (; running < count; ++running) {
+    size_t first = running;
+    producers[running] = (SliceProducer) {
+      .context = this, .submitter = &submitter, .kernel = kernel,
+      .A = A, .B = B, .C = SBuffer,
+      .first = first, .step = count, .rows = this->blockSize,
+      .count = first < slices ? (slices - first + count - 1u) / count : 0u,
+      .jobs = jobs + running * perProducer,
+      .status = CL_SUCCESS,
+    };
+
+    if (thrd_create(&threads[running], ProduceSlices, &producers[running]) != thrd_success) {
+      TR_ERROR("thrd_create(Producer) failed");
+      break;
+    }
+  }
+
+  cl_int status = CL_SUCCESS;
+  size_t largestBatch = 0u;
+  for (size_t index = 0u; index < running; ++index) {
+    thrd_join(threads[index], NULL);
+    status = status == CL_SUCCESS ? producers[index].status : status;
+    largestBatch = producers[index].largestBatch > largestBatch ? producers[index].largestBatch : largestBatch;
+  }
+
+  double milliseconds = (TimerNow() - startTime) * 1e3;
+  if (running < count) { goto out; }
+  if (status != CL_SUCCESS) {
+    TR_FAILED("SubmitJob_Wait(Submitter)", status);
+    goto out;
+  }
+
+  printf(
+    TAB1 "Submitter.Time.........: %.3f ms (x%.2f against one queue, %zu jobs from %zu threads)" LF
+    TAB1 "Submitter.Batches......: %zu (largest of %zu jobs)" LF
+    , milliseconds, milliseconds > 0.0 ? classicMilliseconds / milliseconds : 0.0
+    , atomic_load(&submitter.jobs), count
+    , atomic_load(&submitter.batches), largestBatch
+  );
+
+  if (this->cpuCheck) {
+    TR_MATMUL_LOG(this, 1, "Compare the Submitted Slices against a Device Reference.");
+    CompareStatistics statistics;
+    if (!Compare(NewReference)(this, A, B, &R, &bound)
+      || !Compare(Buffers)(this, SBuffer, R, bound, &statistics)) {
+      goto out;
+    }
+
+    printf(TAB1 "Submitter.Check........: %s (max. error %g absolute, %g relative)" LF
+      , statistics.failures == 0u && statistics.nonFinite == 0u ? "Passed" : "Failed"
+      , statistics.maxAbsoluteError, statistics.maxRelativeError);
+  }
+
+  success = true;
+
+out:
+  // The producers are joined, thus every submitted job is complete.
+  if (started && !Submitter_Stop(&submitter)) { success = false; }
+  free(jobs);
+  free(threads);
+  free(producers);
+
+  if (bound != NULL && CL_SUCCESS != (error = clReleaseMemObject(bound))) { TR_FAILED("clReleaseMemObject(bound)", error); }
+  if (R != NULL && CL_SUCCESS != (error = clReleaseMemObject(R))) { TR_FAILED("clReleaseMemObject(R)", error); }
+  if (SBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(SBuffer))) { TR_FAILED("clReleaseMemObject(Submitter)", error); }
+  if (kernel != NULL) { clReleaseKernel(kernel); }
+
+  return success;
+}
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_STREAMS_C
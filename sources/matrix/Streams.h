@@ -0,0 +1,71 @@
+#ifndef TR_MATRIX_STREAMS_H
+#ifndef TR_MATRIX_PRECISION
+#  define TR_MATRIX_PRECISION float
+#  include "matrix/Streams.h"
+#  undef TR_MATRIX_PRECISION
+#    define TR_MATRIX_PRECISION double
+#    include "matrix/Streams.h"
+#    undef TR_MATRIX_PRECISION
+#      define TR_MATRIX_STREAMS_H
+#else // TR_MATRIX_PRECISION
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+
+#include "common/helper.h" // IN, OUT, INOUT, TR_CONCAT()
+#include "matrix/MatMulContext.h" // MatMulContext{}
+
+#undef Streams
+#undef TR_float
+#undef TR_double
+#  define TR_float 1
+#  define TR_double 2
+#  if TR_float == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Streams(suffix) TR_JOIN2(_, StreamsFloat, suffix)
+#  elif TR_double == TR_CONCAT2(TR_, TR_MATRIX_PRECISION)
+#    define Streams(suffix) TR_JOIN2(_, StreamsDouble, suffix)
+#  else // TR_float || TR_double
+#    error TR_MATRIX_PRECISION := float | double
+#  endif // TR_float || TR_double
+#undef TR_float
+#undef TR_double
+
+///
+/// Runs `C = op(A) * op(B)` as independent slices of rows spread over the
+/// streams of the context (the least loaded first), then displays the time
+/// against the single-queue kernel (`classicMilliseconds`), the utilization of
+/// each queue from the profiling events and, with `--cpu-check`, the errors
+/// against a device reference.
+///
+/// @returns `true` if the slices could be run, `false` otherwise.
+///
+/// @pre `context->openCl.streamCount >= 1`.
+/// @post Displays on stdout, may display error on stderr.
+///
+bool Streams(Benchmark)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B,
+  IN double classicMilliseconds
+);
+
+///
+/// Runs `C = op(A) * op(B)` as one job per block of rows, submitted from
+/// `context->producers` threads through a `Submitter` (see `common/Submitter.h`),
+/// then displays the wall time against the single-queue kernel
+/// (`classicMilliseconds`), the number of batches the jobs were coalesced into
+/// and, with `--cpu-check`, the errors against a device reference.
+///
+/// @returns `true` if the jobs could be run, `false` otherwise.
+///
+/// @pre `context->producers >= 1`.
+/// @post Displays on stdout, may display error on stderr.
+///
+bool Streams(Submit)(
+  IN MatMulContext* context,
+  IN cl_mem A, IN cl_mem B,
+  IN double classicMilliseconds
+);
+
+#endif // TR_MATRIX_PRECISION
+#endif // TR_MATRIX_STREAMS_H
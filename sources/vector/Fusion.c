@@ -0,0 +1,754 @@
+#include <CL/opencl.h> // Khronos API
+
+#include <assert.h> // assert()
+#include <float.h> // FLT_EPSILON, DBL_EPSILON
+#include <getopt.h> // getopt_long()
+#include <math.h> // fabs(), fmax(), fmin()
+#include <stdarg.h> // va_list, va_start(), va_end()
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t
+#include <stdio.h> // FILE, fprintf(), printf(), snprintf(), vsnprintf()
+#include <stdlib.h> // malloc(), free(), strtod()
+#include <string.h> // memcpy(), strcmp(), strcspn(), strncmp()
+#include <threads.h> // mtx_*(), call_once()
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/ProgramCache.h" // ProgramCache_GetKernel()
+#include "common/helper.h" // IN, OUT, INOUT, TR_FAILED()
+#include "common/parallel.h" // ParallelFor()
+#include "common/parse.h" // ParseNumbers()
+#include "common/philox.h" // PhiloxElement(), PhiloxToFloat(), PhiloxToDouble()
+#include "vector/Fusion.h" // Self
+
+/// Maximum number of generated sources (one per signature) of the process.
+#define TR_FUSION_MAX_SOURCES 32u
+
+/// Maximum length of a generated source.
+#define TR_FUSION_SOURCE_SIZE 8192u
+
+/// Work-group size of the fused kernels (bounded by the device).
+#define TR_FUSION_GROUP 256u
+
+/// Defaults of the command line (see `Fusion_ArgumentsUsage()`).
+#define TR_FUSION_DEFAULT_EXPRESSION "axpy:2,scale:0.5,add,relu,clamp:-1:1"
+#define TR_FUSION_DEFAULT_SIZE "16Mi"
+#define TR_FUSION_DEFAULT_SEED 0x5EEDu
+
+// ╔═╗─┐ ┬┌─┐┬─┐┌─┐┌─┐┌─┐┬┌─┐┌┐┌
+// ║╣ ┌┴┬┘├─┘├┬┘├┤ └─┐└─┐││ ││││
+// ╚═╝┴ └─┴  ┴└─└─┘└─┘└─┘┴└─┘┘└┘
+
+void Fusion_Create(OUT Fusion* this) {
+  assert(this != NULL);
+  *this = (Fusion) { .stepCount = 0u, .inputCount = 1u };
+}
+
+static bool HasInput(IN FusionOperation operation) {
+  return operation == FusionOperation_Add || operation == FusionOperation_Axpy;
+}
+
+static size_t ScalarCount(IN FusionOperation operation) {
+  switch (operation) {
+    case FusionOperation_Scale: return 1u;
+    case FusionOperation_Axpy: return 1u;
+    case FusionOperation_Clamp: return 2u;
+    default: return 0u;
+  }
+}
+
+static bool AppendStep(INOUT Fusion* this, IN FusionStep step) {
+  assert(this != NULL);
+
+  if (this->stepCount == TR_FUSION_MAX_STEPS || (HasInput(step.operation) && step.input >= TR_FUSION_MAX_INPUTS)) {
+    return false;
+  }
+
+  this->steps[this->stepCount++] = step;
+  if (HasInput(step.operation) && step.input >= this->inputCount) {
+    this->inputCount = step.input + 1u;
+  }
+
+  return true;
+}
+
+bool Fusion_Scale(INOUT Fusion* this, IN double alpha) {
+  return AppendStep(this, (FusionStep) { .operation = FusionOperation_Scale, .scalars = { alpha, 0.0 } });
+}
+
+bool Fusion_Add(INOUT Fusion* this, IN size_t input) {
+  return AppendStep(this, (FusionStep) { .operation = FusionOperation_Add, .input = input });
+}
+
+bool Fusion_Axpy(INOUT Fusion* this, IN double alpha, IN size_t input) {
+  return AppendStep(this, (FusionStep) { .operation = FusionOperation_Axpy, .input = input, .scalars = { alpha, 0.0 } });
+}
+
+bool Fusion_Relu(INOUT Fusion* this) {
+  return AppendStep(this, (FusionStep) { .operation = FusionOperation_Relu });
+}
+
+bool Fusion_Clamp(INOUT Fusion* this, IN double low, IN double high) {
+  return AppendStep(this, (FusionStep) { .operation = FusionOperation_Clamp, .scalars = { low, high } });
+}
+
+bool Fusion_Signature(IN Fusion const* this, OUT char* signature, IN size_t size) {
+  assert(this != NULL && signature != NULL && size > 0u);
+
+  static char const letters[] = {
+    [FusionOperation_Scale] = 's',
+    [FusionOperation_Add] = 'a',
+    [FusionOperation_Axpy] = 'x',
+    [FusionOperation_Relu] = 'r',
+    [FusionOperation_Clamp] = 'c',
+  };
+
+  // The number of inputs is part of the signature: an unused input is still an argument.
+  int written = snprintf(signature, size, "%zu", this->inputCount);
+  size_t length = written < 0 ? size : (size_t) written;
+
+  for (size_t index = 0u; index < this->stepCount && length < size; ++index) {
+    FusionStep const* step = &this->steps[index];
+    written = HasInput(step->operation)
+      ? snprintf(signature + length, size - length, ",%c%zu", letters[step->operation], step->input)
+      : snprintf(signature + length, size - length, ",%c", letters[step->operation]);
+    length = written < 0 ? size : length + (size_t) written;
+  }
+
+  return length < size;
+}
+
+// ╔═╗┌─┐┌┐┌┌─┐┬─┐┌─┐┌┬┐┬┌─┐┌┐┌
+// ║ ╦├┤ │││├┤ ├┬┘├─┤ │ ││ ││││
+// ╚═╝└─┘┘└┘└─┘┴└─┴ ┴ ┴ ┴└─┘┘└┘
+
+///
+/// A generated source, kept for the lifetime of the process: `ProgramCache`
+/// keys the programs by the address of their source, which thus must neither
+/// move nor be reused by another signature.
+///
+typedef struct FusionSource {
+  char signature[TR_FUSION_SIGNATURE_SIZE];
+  char* source;
+  size_t length;
+} FusionSource;
+
+static struct {
+  FusionSource entries[TR_FUSION_MAX_SOURCES];
+  size_t count;
+  mtx_t mutex;
+} sources = { 0 };
+
+static once_flag sourcesOnce = ONCE_FLAG_INIT;
+
+static void InitializeSources(void) {
+  if (mtx_init(&sources.mutex, mtx_plain) != thrd_success) {
+    TR_ERROR("mtx_init(sources) failed");
+  }
+}
+
+///
+/// Appends to the source being generated, `length` becoming larger than
+/// `size` on truncation.
+///
+static void Append(INOUT char* source, IN size_t size, INOUT size_t* length, IN char const* format, ...) {
+  if (*length >= size) { return; }
+
+  va_list arguments;
+  va_start(arguments, format);
+  int written = vsnprintf(source + *length, size - *length, format, arguments);
+  va_end(arguments);
+
+  *length = written < 0 ? size : *length + (size_t) written;
+}
+
+///
+/// Generates the kernel `Fused` of the expression, the precision being given
+/// at build time by `-DFUSION_REAL`.
+///
+/// @returns The length of the source, `size` or more on truncation.
+///
+static size_t GenerateSource(IN Fusion const* this, OUT char* source, IN size_t size) {
+  size_t length = 0u;
+
+  Append(source, size, &length,
+    "#if defined(cl_khr_fp64)\n"
+    "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n"
+    "#elif defined(cl_amd_fp64)\n"
+    "#pragma OPENCL EXTENSION cl_amd_fp64 : enable\n"
+    "#endif\n\n"
+    "typedef FUSION_REAL Real;\n\n"
+    "__kernel void Fused(\n"
+    "  unsigned long const count,\n"
+    "  __global Real* output");
+
+  for (size_t input = 0u; input < this->inputCount; ++input) {
+    Append(source, size, &length, ",\n  __global Real const* input%zu", input);
+  }
+
+  for (size_t index = 0u; index < this->stepCount; ++index) {
+    for (size_t scalar = 0u; scalar < ScalarCount(this->steps[index].operation); ++scalar) {
+      Append(source, size, &length, ",\n  Real const scalar%zu_%zu", index, scalar);
+    }
+  }
+
+  Append(source, size, &length,
+    ")\n{\n"
+    "  size_t const index = get_global_id(0);\n"
+    "  if (index >= count) { return; }\n\n"
+    "  Real x = input0[index];\n");
+
+  for (size_t index = 0u; index < this->stepCount; ++index) {
+    FusionStep const* step = &this->steps[index];
+    switch (step->operation) {
+      case FusionOperation_Scale:
+        Append(source, size, &length, "  x = scalar%zu_0 * x;\n", index);
+        break;
+      case FusionOperation_Add:
+        Append(source, size, &length, "  x = x + input%zu[index];\n", step->input);
+        break;
+      case FusionOperation_Axpy:
+        Append(source, size, &length, "  x = scalar%zu_0 * input%zu[index] + x;\n", index, step->input);
+        break;
+      case FusionOperation_Relu:
+        Append(source, size, &length, "  x = fmax(x, (Real) 0);\n");
+        break;
+      case FusionOperation_Clamp:
+        Append(source, size, &length, "  x = clamp(x, scalar%zu_0, scalar%zu_1);\n", index, index);
+        break;
+    }
+  }
+
+  Append(source, size, &length, "\n  output[index] = x;\n}\n");
+  return length;
+}
+
+///
+/// Returns the source of the expression, generated on the first request of its
+/// signature then shared.
+///
+/// @returns `NULL` on failure.
+///
+static FusionSource const* GetSource(IN Fusion const* this) {
+  char signature[TR_FUSION_SIGNATURE_SIZE];
+  if (!Fusion_Signature(this, signature, sizeof(signature))) {
+    TR_ERROR("The signature of the expression is too long.");
+    return NULL;
+  }
+
+  call_once(&sourcesOnce, InitializeSources);
+  mtx_lock(&sources.mutex);
+
+  FusionSource* found = NULL;
+  for (size_t index = 0u; index < sources.count && found == NULL; ++index) {
+    if (strcmp(sources.entries[index].signature, signature) == 0) {
+      found = &sources.entries[index];
+    }
+  }
+
+  if (found == NULL && sources.count < TR_FUSION_MAX_SOURCES) {
+    char buffer[TR_FUSION_SOURCE_SIZE];
+    size_t length = GenerateSource(this, buffer, sizeof(buffer));
+    char* source = length < sizeof(buffer) ? (char*) malloc(length + 1u) : NULL;
+    if (source != NULL) {
+      memcpy(source, buffer, length + 1u);
+      found = &sources.entries[sources.count++];
+      snprintf(found->signature, sizeof(found->signature), "%s", signature);
+      found->source = source;
+      found->length = length;
+    }
+  }
+
+  mtx_unlock(&sources.mutex);
+
+  if (found == NULL) {
+    TR_ERROR("The source of the expression %s cannot be generated.", signature);
+  }
+
+  return found;
+}
+
+bool Fusion_Enqueue(
+  IN OpenClContext* context,
+  IN Fusion const* this,
+  IN bool doublePrecision,
+  IN size_t count,
+  IN cl_mem const* inputs,
+  IN cl_mem output,
+  OUT cl_event* event)
+{
+  assert(context != NULL && this != NULL && inputs != NULL);
+
+  FusionSource const* source = GetSource(this);
+  if (source == NULL) {
+    return false;
+  }
+
+  char const* options = doublePrecision ? "-DFUSION_REAL=double" : "-DFUSION_REAL=float";
+  cl_kernel kernel = ProgramCache_GetKernel(context, source->source, source->source + source->length, options, "Fused");
+  if (kernel == NULL) {
+    TR_ERROR("ProgramCache_GetKernel(Fused) failed");
+    return false;
+  }
+
+  cl_ulong elements = (cl_ulong) count;
+  cl_uint argument = 0u;
+  cl_int error = clSetKernelArg(kernel, argument++, sizeof(cl_ulong), &elements);
+  error |= clSetKernelArg(kernel, argument++, sizeof(cl_mem), &output);
+  for (size_t input = 0u; input < this->inputCount; ++input) {
+    error |= clSetKernelArg(kernel, argument++, sizeof(cl_mem), &inputs[input]);
+  }
+
+  for (size_t index = 0u; index < this->stepCount; ++index) {
+    FusionStep const* step = &this->steps[index];
+    for (size_t scalar = 0u; scalar < ScalarCount(step->operation); ++scalar) {
+      cl_double doubleValue = step->scalars[scalar];
+      cl_float floatValue = (cl_float) step->scalars[scalar];
+      error |= doublePrecision
+        ? clSetKernelArg(kernel, argument++, sizeof(cl_double), &doubleValue)
+        : clSetKernelArg(kernel, argument++, sizeof(cl_float), &floatValue);
+    }
+  }
+
+  bool success = false;
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clSetKernelArg(Fused)", error);
+    goto out;
+  }
+
+  size_t maxGroup = context->capabilities.maxWorkGroupSize;
+  size_t localSize = maxGroup != 0u && maxGroup < TR_FUSION_GROUP ? maxGroup : TR_FUSION_GROUP;
+  size_t globalSize = (count + localSize - 1u) / localSize * localSize;
+  error = clEnqueueNDRangeKernel(context->queue, kernel, 1, NULL, &globalSize, &localSize, 0, NULL, event);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clEnqueueNDRangeKernel(Fused)", error);
+    goto out;
+  }
+
+  success = true;
+
+out:
+  if (CL_SUCCESS != (error = clReleaseKernel(kernel))) { TR_FAILED("clReleaseKernel()", error); }
+  return success;
+}
+
+// ╦ ╦┌─┐┌─┐┌┬┐
+// ╠═╣│ │└─┐ │
+// ╩ ╩└─┘└─┘ ┴
+
+typedef struct FusionFillTask {
+  uint64_t seed;
+  uint32_t stream;
+  bool doublePrecision;
+  void* data;
+} FusionFillTask;
+
+static void FillElements(IN size_t begin, IN size_t end, INOUT void* data) {
+  FusionFillTask const* task = data;
+
+  for (size_t index = begin; index < end; ++index) {
+    uint32_t second = 0u;
+    uint32_t first = PhiloxElement(task->seed, task->stream, (uint32_t) (index >> 32), (uint32_t) index, &second);
+    if (task->doublePrecision) {
+      ((double*) task->data)[index] = PhiloxToDouble(first, second);
+    }
+    else {
+      ((float*) task->data)[index] = PhiloxToFloat(first);
+    }
+  }
+}
+
+static double GetValue(IN void const* data, IN size_t index, IN bool doublePrecision) {
+  return doublePrecision ? ((double const*) data)[index] : (double) ((float const*) data)[index];
+}
+
+typedef struct FusionCheckTask {
+  Fusion const* fusion;
+  bool doublePrecision;
+  void* const* inputs;
+  void const* fused;
+  void const* unfused;
+  size_t count, chunk;
+  /// Per chunk, the maximum errors of the fused and unfused results.
+  double* errors;
+} FusionCheckTask;
+
+///
+/// Evaluates the expression on the host for the elements `[begin, end)`.
+///
+/// @param errors The maximum errors of the fused and unfused results.
+///
+static void CheckElements(IN FusionCheckTask const* task, IN size_t begin, IN size_t end, OUT double errors[2]) {
+  Fusion const* fusion = task->fusion;
+  bool dp = task->doublePrecision;
+
+  errors[0] = errors[1] = 0.0;
+  for (size_t index = begin; index < end; ++index) {
+    double x = GetValue(task->inputs[0], index, dp);
+    for (size_t step = 0u; step < fusion->stepCount; ++step) {
+      FusionStep const* s = &fusion->steps[step];
+      double v = HasInput(s->operation) ? GetValue(task->inputs[s->input], index, dp) : 0.0;
+      switch (s->operation) {
+        case FusionOperation_Scale: x = s->scalars[0] * x; break;
+        case FusionOperation_Add: x = x + v; break;
+        case FusionOperation_Axpy: x = s->scalars[0] * v + x; break;
+        case FusionOperation_Relu: x = fmax(x, 0.0); break;
+        case FusionOperation_Clamp: x = fmin(fmax(x, s->scalars[0]), s->scalars[1]); break;
+      }
+    }
+
+    double scale = fabs(x) > 1.0 ? fabs(x) : 1.0;
+    errors[0] = fmax(errors[0], fabs(GetValue(task->fused, index, dp) - x) / scale);
+    errors[1] = fmax(errors[1], fabs(GetValue(task->unfused, index, dp) - x) / scale);
+  }
+}
+
+///
+/// Evaluates the expression on the host in double-precision for the elements
+/// of the chunks `[begin, end)`, recording their largest errors relative to
+/// `max(1, |x|)`.
+///
+static void CheckChunks(IN size_t begin, IN size_t end, INOUT void* data) {
+  FusionCheckTask const* task = data;
+  for (size_t chunk = begin; chunk < end; ++chunk) {
+    size_t first = chunk * task->chunk;
+    size_t last = first + task->chunk < task->count ? first + task->chunk : task->count;
+    CheckElements(task, first, last, &task->errors[2u * chunk]);
+  }
+}
+
+// ╔═╗┌─┐┌┬┐┌┬┐┌─┐┌┐┌┌┬┐
+// ║  │ ││││││││├─┤│││ ││
+// ╚═╝└─┘┴ ┴┴ ┴┴ ┴┘└┘╶┴┘
+
+///
+/// Parses a comma-separated list of operations, `axpy:<alpha>`, `scale:<alpha>`,
+/// `add`, `relu` and `clamp:<low>:<high>`, the add and axpy operations reading
+/// the next input vector each.
+///
+static bool ParseExpression(IN char const* expression, OUT Fusion* fusion) {
+  Fusion_Create(fusion);
+
+  char const* cursor = expression;
+  while (*cursor != '\0') {
+    double scalars[2] = { 0.0, 0.0 };
+    size_t length = strcspn(cursor, ":,");
+    char const* name = cursor;
+    cursor += length;
+
+    size_t scalarCount = 0u;
+    while (*cursor == ':' && scalarCount < 2u) {
+      char* end = NULL;
+      scalars[scalarCount++] = strtod(cursor + 1, &end);
+      if (end == cursor + 1) { return false; }
+      cursor = end;
+    }
+
+    bool appended = false;
+    size_t input = fusion->inputCount;
+    if (length == 4u && strncmp(name, "axpy", 4u) == 0 && scalarCount == 1u) {
+      appended = Fusion_Axpy(fusion, scalars[0], input);
+    }
+    else if (length == 5u && strncmp(name, "scale", 5u) == 0 && scalarCount == 1u) {
+      appended = Fusion_Scale(fusion, scalars[0]);
+    }
+    else if (length == 3u && strncmp(name, "add", 3u) == 0 && scalarCount == 0u) {
+      appended = Fusion_Add(fusion, input);
+    }
+    else if (length == 4u && strncmp(name, "relu", 4u) == 0 && scalarCount == 0u) {
+      appended = Fusion_Relu(fusion);
+    }
+    else if (length == 5u && strncmp(name, "clamp", 5u) == 0 && scalarCount == 2u && scalars[0] <= scalars[1]) {
+      appended = Fusion_Clamp(fusion, scalars[0], scalars[1]);
+    }
+
+    if (!appended || (*cursor != '\0' && *cursor != ',')) { return false; }
+    if (*cursor == ',') { cursor += 1; }
+  }
+
+  return fusion->stepCount > 0u;
+}
+
+///
+/// Returns the duration of a completed kernel from its profiling event.
+///
+static double EventNanoseconds(IN cl_event event) {
+  cl_ulong start = 0u, end = 0u;
+  cl_int error = clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_START, sizeof(start), &start, NULL);
+  error |= clGetEventProfilingInfo(event, CL_PROFILING_COMMAND_END, sizeof(end), &end, NULL);
+  if (error != CL_SUCCESS) {
+    TR_FAILED("clGetEventProfilingInfo()", error);
+    return 0.0;
+  }
+
+  return (double) (end - start);
+}
+
+///
+/// Runs the expression fused, then one kernel per operation (ping-ponging
+/// between two temporaries), and checks both against the host.
+///
+static bool RunExpression(
+  IN OpenClContext* openCl, IN Fusion const* fusion,
+  IN bool doublePrecision, IN size_t count, IN uint64_t seed)
+{
+  cl_int error;
+  bool success = false;
+  cl_mem inputBuffers[TR_FUSION_MAX_INPUTS] = { NULL };
+  cl_mem fusedBuffer = NULL, temporaries[2] = { NULL, NULL };
+  void* inputs[TR_FUSION_MAX_INPUTS] = { NULL };
+  void *fused = NULL, *unfused = NULL;
+  double errors[2u * TR_PARALLEL_MAX_THREADS] = { 0.0 };
+
+  size_t elementSize = doublePrecision ? sizeof(double) : sizeof(float);
+  size_t bytes = elementSize * count;
+
+  for (size_t input = 0u; input < fusion->inputCount; ++input) {
+    inputs[input] = malloc(bytes);
+    if (inputs[input] == NULL) { TR_ERROR("malloc(Input) failed"); goto out; }
+
+    FusionFillTask task = { seed, (uint32_t) input, doublePrecision, inputs[input] };
+    ParallelFor(count, FillElements, &task);
+
+    inputBuffers[input] = clCreateBuffer(openCl->context, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, bytes, inputs[input], &error);
+    if (error != CL_SUCCESS || inputBuffers[input] == NULL) { TR_FAILED("clCreateBuffer(Input)", error); goto out; }
+  }
+
+  fused = malloc(bytes);
+  unfused = malloc(bytes);
+  if (fused == NULL || unfused == NULL) { TR_ERROR("malloc(Output) failed"); goto out; }
+
+  fusedBuffer = clCreateBuffer(openCl->context, CL_MEM_READ_WRITE, bytes, NULL, &error);
+  if (error != CL_SUCCESS || fusedBuffer == NULL) { TR_FAILED("clCreateBuffer(Fused)", error); goto out; }
+  for (size_t index = 0u; index < 2u; ++index) {
+    temporaries[index] = clCreateBuffer(openCl->context, CL_MEM_READ_WRITE, bytes, NULL, &error);
+    if (error != CL_SUCCESS || temporaries[index] == NULL) { TR_FAILED("clCreateBuffer(Temporary)", error); goto out; }
+  }
+
+  // Fused: every input read once, the output written once.
+  cl_event event = NULL;
+  if (!Fusion_Enqueue(openCl, fusion, doublePrecision, count, inputBuffers, fusedBuffer, &event)) {
+    goto out;
+  }
+
+  error = clEnqueueReadBuffer(openCl->queue, fusedBuffer, CL_TRUE, 0u, bytes, fused, 1, &event, NULL);
+  double fusedNanoseconds = EventNanoseconds(event);
+  clReleaseEvent(event);
+  if (error != CL_SUCCESS) { TR_FAILED("clEnqueueReadBuffer(Fused)", error); goto out; }
+
+  // Unfused: one round trip through global memory per operation.
+  double unfusedNanoseconds = 0.0;
+  size_t unfusedBytes = 0u;
+  cl_mem current = inputBuffers[0];
+  for (size_t index = 0u; index < fusion->stepCount; ++index) {
+    FusionStep const* step = &fusion->steps[index];
+
+    Fusion single;
+    Fusion_Create(&single);
+    single.steps[0] = *step;
+    single.steps[0].input = 1u;
+    single.stepCount = 1u;
+    single.inputCount = HasInput(step->operation) ? 2u : 1u;
+
+    cl_mem const operands[2] = { current, inputBuffers[step->input] };
+    cl_mem target = temporaries[index % 2u];
+    if (!Fusion_Enqueue(openCl, &single, doublePrecision, count, operands, target, &event)) {
+      goto out;
+    }
+
+    error = clWaitForEvents(1, &event);
+    unfusedNanoseconds += error == CL_SUCCESS ? EventNanoseconds(event) : 0.0;
+    clReleaseEvent(event);
+    if (error != CL_SUCCESS) { TR_FAILED("clWaitForEvents(Unfused)", error); goto out; }
+
+    unfusedBytes += bytes * (single.inputCount + 1u);
+    current = target;
+  }
+
+  error = clEnqueueReadBuffer(openCl->queue, current, CL_TRUE, 0u, bytes, unfused, 0, NULL, NULL);
+  if (error != CL_SUCCESS) { TR_FAILED("clEnqueueReadBuffer(Unfused)", error); goto out; }
+
+  size_t fusedBytes = bytes * (fusion->inputCount + 1u);
+  printf(
+    TAB0 "Element-Wise Fusion Results:" LF
+    TAB1 "Unfused.Time...........: %.3f ms (%zu kernels, %.3f GB/s)" LF
+    TAB1 "Fused.Time.............: %.3f ms (1 kernel, %.3f GB/s)" LF
+    TAB1 "Speedup................: %.2fx" LF
+    TAB1 "Traffic.Saved..........: %.1f MiB" LF
+    , unfusedNanoseconds * 1e-6, fusion->stepCount
+    , unfusedNanoseconds > 0.0 ? (double) unfusedBytes / unfusedNanoseconds : 0.0
+    , fusedNanoseconds * 1e-6
+    , fusedNanoseconds > 0.0 ? (double) fusedBytes / fusedNanoseconds : 0.0
+    , fusedNanoseconds > 0.0 ? unfusedNanoseconds / fusedNanoseconds : 0.0
+    , (double) (unfusedBytes - fusedBytes) / (1024.0 * 1024.0)
+  );
+
+  // One chunk per thread, each with its own maximum errors.
+  size_t chunks = ParallelThreadCount();
+  FusionCheckTask check = {
+    .fusion = fusion, .doublePrecision = doublePrecision, .inputs = inputs,
+    .fused = fused, .unfused = unfused, .count = count,
+    .chunk = (count + chunks - 1u) / chunks, .errors = errors,
+  };
+
+  ParallelFor(chunks, CheckChunks, &check);
+
+  double fusedError = 0.0, unfusedError = 0.0;
+  for (size_t slot = 0u; slot < chunks; ++slot) {
+    fusedError = fmax(fusedError, errors[2u * slot + 0u]);
+    unfusedError = fmax(unfusedError, errors[2u * slot + 1u]);
+  }
+
+  double tolerance = 2.0 * (double) (fusion->stepCount + 1u) * (doublePrecision ? DBL_EPSILON : (double) FLT_EPSILON);
+  success = fusedError <= tolerance && unfusedError <= tolerance;
+  printf(
+    TAB1 "CPU.Check..............: %s" LF
+    TAB1 "Max.Relative.Error.....: %g fused, %g unfused (tolerance %g)" LFLF
+    , success ? "Passed" : "Failed", fusedError, unfusedError, tolerance
+  );
+
+out:
+  for (size_t index = 0u; index < 2u; ++index) {
+    if (temporaries[index] != NULL && CL_SUCCESS != (error = clReleaseMemObject(temporaries[index]))) { TR_FAILED("clReleaseMemObject(Temporary)", error); }
+  }
+
+  if (fusedBuffer != NULL && CL_SUCCESS != (error = clReleaseMemObject(fusedBuffer))) { TR_FAILED("clReleaseMemObject(Fused)", error); }
+  for (size_t input = 0u; input < TR_FUSION_MAX_INPUTS; ++input) {
+    if (inputBuffers[input] != NULL && CL_SUCCESS != (error = clReleaseMemObject(inputBuffers[input]))) { TR_FAILED("clReleaseMemObject(Input)", error); }
+    free(inputs[input]);
+  }
+
+  free(unfused);
+  free(fused);
+  return success;
+}
+
+void Fusion_ArgumentsUsage(IN FILE* stream, IN char const* command) {
+  assert(stream != NULL);
+  assert(command != NULL);
+
+  fprintf(stream,
+    TAB1 BOLD("%s") LF
+
+    TAB2 "Generates a single kernel for a chain of element-wise vector operations and compares it" LF
+    TAB2 "against one kernel per operation (one round trip through global memory each):" LFLF
+
+    TAB2 BOLD("-d, --device") " GPU | CPU | Default | Fastest | <PlatformIndex>:<DeviceIndex>" LF
+    TAB3 "Specifies which device to use (prefix, case-insensitive)." LFLF
+
+    TAB2 BOLD("-e, --expression") " <Operation>[,<Operation>...]" LF
+    TAB3 "The chain applied to the first vector: axpy:<Alpha>, scale:<Alpha>, add, relu and" LF
+    TAB3 "clamp:<Low>:<High>, add and axpy reading the next vector each" LF
+    TAB3 "(default " TR_FUSION_DEFAULT_EXPRESSION ")." LFLF
+
+    TAB2 BOLD("-n, --size") " <Elements>" LF
+    TAB3 "The length of the vectors with optional multiplicative suffixes (default " TR_FUSION_DEFAULT_SIZE ")." LFLF
+
+    TAB2 BOLD("-f, --double-precision") LF
+    TAB3 "Enables the double-precision floating-point extension." LFLF
+
+    TAB2 BOLD("-S, --seed") " <Seed>" LF
+    TAB3 "The seed of the random vectors." LFLF
+
+    TAB2 BOLD("-h, --help") LF
+    TAB3 "Displays this help and quit." LFLF
+
+    , command
+  );
+}
+
+int Fusion_Run(IN int argc, IN char* argv[]) {
+  assert(argc >= 1 && argv[0] != NULL);
+
+  static struct option options[] = {
+    { "device", required_argument, NULL, 'd' },
+    { "expression", required_argument, NULL, 'e' },
+    { "size", required_argument, NULL, 'n' },
+    { "double-precision", no_argument, NULL, 'f' },
+    { "seed", required_argument, NULL, 'S' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 },
+  };
+
+  int option;
+  char const* device = "Default";
+  char const* expression = TR_FUSION_DEFAULT_EXPRESSION;
+  char const* size = TR_FUSION_DEFAULT_SIZE;
+  char const* seed = NULL;
+  bool doublePrecision = false;
+
+  opterr = 1; // Prints error on stderr.
+  while (0 <= (option = getopt_long(argc, argv, "d:e:n:fS:h", options, NULL))) {
+    switch (option) {
+      case 'd': device = optarg; break;
+      case 'e': expression = optarg; break;
+      case 'n': size = optarg; break;
+      case 'f': doublePrecision = true; break;
+      case 'S': seed = optarg; break;
+      case 'h':
+        Fusion_ArgumentsUsage(stdout, argv[0]);
+        return 2;
+      default:
+        return 0;
+    }
+  }
+
+  Fusion fusion;
+  if (!ParseExpression(expression, &fusion)) {
+    fprintf(stderr, LF
+      "The expression must be a comma-separated list of at most %u operations" LF
+      "(axpy:<Alpha>, scale:<Alpha>, add, relu, clamp:<Low>:<High>) reading at most %u vectors:" LF
+      TAB1 "--expression %s" LFLF
+      , TR_FUSION_MAX_STEPS, TR_FUSION_MAX_INPUTS, expression
+    );
+
+    return 0;
+  }
+
+  size_t count = 0u;
+  char const* sizeCursor = size;
+  if (!ParseNumbers(&sizeCursor, &count, 1) || count == 0u) {
+    fprintf(stderr, LF "The size must be a positive number:" LF TAB1 "--size %s" LFLF, size);
+    return 0;
+  }
+
+  size_t seedValue = TR_FUSION_DEFAULT_SEED;
+  char const* seedCursor = seed;
+  if (seed != NULL && !ParseNumbers(&seedCursor, &seedValue, 1)) {
+    fprintf(stderr, LF "The seed must be a number:" LF TAB1 "--seed %s" LFLF, seed);
+    return 0;
+  }
+
+  OpenClContext openCl;
+  if (OpenClContext_FromString(device, &openCl) != 1) {
+    fprintf(stderr, LF "The device cannot be opened:" LF TAB1 "--device %s" LFLF, device);
+    return 0;
+  }
+
+  int result = 0;
+  if (doublePrecision && !OpenClContext_EnableDoublePrecision(&openCl)) {
+    fprintf(stderr, LF "The device does not support double-precision." LFLF);
+    goto out;
+  }
+
+  char signature[TR_FUSION_SIGNATURE_SIZE];
+  Fusion_Signature(&fusion, signature, sizeof(signature));
+  printf(
+    TAB0 "Element-Wise Fusion:" LF
+    TAB1 "Expression.............: %s" LF
+    TAB1 "Signature..............: %s" LF
+    TAB1 "Vectors................: %zu x %zu elements" LF
+    TAB1 "Floating.Point.........: %s" LFLF
+    , expression, signature, fusion.inputCount, count
+    , doublePrecision ? "Double-Precision" : "Single-Precision"
+  );
+
+  result = RunExpression(&openCl, &fusion, doublePrecision, count, (uint64_t) seedValue) ? 1 : 0;
+
+out:
+  if (!OpenClContext_Release(&openCl)) {
+    TR_ERROR("OpenClContext_Release() failed");
+  }
+
+  return result;
+}
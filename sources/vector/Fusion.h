@@ -0,0 +1,137 @@
+#ifndef TR_VECTOR_FUSION_H
+#define TR_VECTOR_FUSION_H
+
+#include <CL/opencl.h> // Khronos API
+
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
+#include <stdio.h> // FILE
+
+#include "common/OpenClContext.h" // OpenClContext{}
+#include "common/helper.h" // IN, INOUT, OUT
+
+/// Maximum number of element-wise operations of a fused expression.
+#define TR_FUSION_MAX_STEPS 32u
+
+/// Maximum number of input vectors of a fused expression.
+#define TR_FUSION_MAX_INPUTS 8u
+
+/// Maximum length of the signature of an expression (see `Fusion_Signature()`).
+#define TR_FUSION_SIGNATURE_SIZE 256u
+
+///
+/// The element-wise operations, `x` being the running value of an element and
+/// `v` the same element of an input vector.
+///
+typedef enum FusionOperation {
+  FusionOperation_Scale, ///< `x = alpha * x`
+  FusionOperation_Add, ///< `x = x + v`
+  FusionOperation_Axpy, ///< `x = alpha * v + x`
+  FusionOperation_Relu, ///< `x = max(x, 0)`
+  FusionOperation_Clamp, ///< `x = clamp(x, low, high)`
+} FusionOperation;
+
+typedef struct FusionStep {
+  FusionOperation operation;
+  /// The input vector `v` (Add and Axpy only).
+  size_t input;
+  /// `alpha`, or `low` and `high` (passed as kernel arguments).
+  double scalars[2];
+} FusionStep;
+
+///
+/// A chain of element-wise operations over vectors of the same length,
+/// `output = stepN(... step1(input0))`, generated into a single OpenCL kernel
+/// so that every vector is read once and the output written once, instead of
+/// one round trip through global memory per operation.
+///
+/// The generated source only depends on the operations and their inputs (the
+/// signature), the scalars being kernel arguments, so that expressions of the
+/// same shape share the same program.
+///
+typedef struct Fusion {
+  FusionStep steps[TR_FUSION_MAX_STEPS];
+  size_t stepCount;
+  /// Number of input vectors, the first one being the initial `x`.
+  size_t inputCount;
+} Fusion;
+
+///
+/// Starts an expression with `x = input0`.
+///
+/// @pre `fusion` is not NULL.
+///
+void Fusion_Create(OUT Fusion* fusion);
+
+///
+/// Appends an operation to the expression.
+///
+/// @returns `false` if the expression is full or `input` is out of range
+///          (`TR_FUSION_MAX_STEPS`, `TR_FUSION_MAX_INPUTS`), `true` otherwise.
+///
+/// @pre `fusion` is not NULL.
+///
+bool Fusion_Scale(INOUT Fusion* fusion, IN double alpha);
+bool Fusion_Add(INOUT Fusion* fusion, IN size_t input);
+bool Fusion_Axpy(INOUT Fusion* fusion, IN double alpha, IN size_t input);
+bool Fusion_Relu(INOUT Fusion* fusion);
+bool Fusion_Clamp(INOUT Fusion* fusion, IN double low, IN double high);
+
+///
+/// Writes the signature of the expression, its number of inputs then its steps,
+/// e.g. `3,s,a1,x2,r,c` for 3 inputs, a scale, an add of input 1, an axpy of
+/// input 2, a ReLU then a clamp.
+///
+/// @returns `false` if the signature was truncated, `true` otherwise.
+///
+/// @pre `fusion` and `signature` are not NULL.
+///
+bool Fusion_Signature(IN Fusion const* fusion, OUT char* signature, IN size_t size);
+
+///
+/// Enqueues the fused kernel of the expression over `count` elements, i.e.
+/// `output[i] = expression(inputs[0][i], ..., inputs[inputCount - 1][i])`.
+///
+/// The source is generated once per signature and kept for the lifetime of the
+/// process, the program being built and cached by `ProgramCache` like the other
+/// kernels (see `ProgramCache_GetKernel()`).
+///
+/// `output` may be one of the inputs (in-place).
+///
+/// @returns `true` on success, `false` otherwise.
+///
+/// @pre `context` is not NULL and already initialized (with double-precision
+///      enabled for `doublePrecision`).
+/// @pre `fusion` is not NULL, `inputs` holds `fusion->inputCount` buffers of
+///      at least `count` elements.
+/// @post `event` (if not NULL) must be released with `clReleaseEvent()`.
+/// @post May display error on stderr.
+///
+bool Fusion_Enqueue(
+  IN OpenClContext* context,
+  IN Fusion const* fusion,
+  IN bool doublePrecision,
+  IN size_t count,
+  IN cl_mem const* inputs,
+  IN cl_mem output,
+  OUT cl_event* event
+);
+
+///
+/// Displays the usage of the `fuse` command.
+///
+/// @pre `stream` and `command` are not NULL.
+///
+void Fusion_ArgumentsUsage(IN FILE* stream, IN char const* command);
+
+///
+/// Runs an expression both fused and as one kernel per operation (the `fuse`
+/// command), displays both timings and checks them against the host.
+///
+/// @returns `0` on failure (check included), `1` on success, `2` for `--help`.
+///
+/// @post Display content on stdout, may display error on stderr.
+///
+int Fusion_Run(IN int argc, IN char* argv[]);
+
+#endif // TR_VECTOR_FUSION_H